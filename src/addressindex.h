@@ -13,6 +13,10 @@
 #include <serialize.h>
 #include <uint256.h>
 
+#include <optional>
+#include <span>
+#include <tuple>
+
 static const std::string MEWC = "MEWC";
 
 struct CAddressUnspentKey {
@@ -69,6 +73,16 @@ struct CAddressUnspentKey {
         txhash.SetNull();
         index = 0;
     }
+
+    friend bool operator==(const CAddressUnspentKey& a, const CAddressUnspentKey& b) {
+        return a.type == b.type && a.hashBytes == b.hashBytes && a.asset == b.asset &&
+               a.txhash == b.txhash && a.index == b.index;
+    }
+
+    friend bool operator<(const CAddressUnspentKey& a, const CAddressUnspentKey& b) {
+        return std::tie(a.type, a.hashBytes, a.asset, a.txhash, a.index) <
+               std::tie(b.type, b.hashBytes, b.asset, b.txhash, b.index);
+    }
 };
 
 struct CAddressUnspentValue {
@@ -177,6 +191,17 @@ struct CAddressIndexKey {
         index = 0;
         spending = false;
     }
+
+    friend bool operator==(const CAddressIndexKey& a, const CAddressIndexKey& b) {
+        return a.type == b.type && a.hashBytes == b.hashBytes && a.asset == b.asset &&
+               a.blockHeight == b.blockHeight && a.txindex == b.txindex && a.txhash == b.txhash &&
+               a.index == b.index && a.spending == b.spending;
+    }
+
+    friend bool operator<(const CAddressIndexKey& a, const CAddressIndexKey& b) {
+        return std::tie(a.type, a.hashBytes, a.asset, a.blockHeight, a.txindex, a.index, a.spending) <
+               std::tie(b.type, b.hashBytes, b.asset, b.blockHeight, b.txindex, b.index, b.spending);
+    }
 };
 
 struct CAddressIndexIteratorKey {
@@ -306,6 +331,262 @@ struct CAddressIndexIteratorHeightKey {
     }
 };
 
+/**
+ * Variable length encoding of an unsigned integer whose bytes sort in the
+ * same order as the values: a run of leading one bits gives the number of
+ * extra bytes, followed by the value in big-endian order. Values below 128
+ * take one byte, below 2^14 two and below 2^21 (all block heights for now)
+ * three.
+ */
+template<typename Stream>
+void WriteOrderedVarInt(Stream& s, uint32_t n) {
+    if (n < (1U << 7)) {
+        ser_writedata8(s, n);
+    } else if (n < (1U << 14)) {
+        ser_writedata8(s, 0x80 | (n >> 8));
+        ser_writedata8(s, n & 0xFF);
+    } else if (n < (1U << 21)) {
+        ser_writedata8(s, 0xC0 | (n >> 16));
+        ser_writedata8(s, (n >> 8) & 0xFF);
+        ser_writedata8(s, n & 0xFF);
+    } else if (n < (1U << 28)) {
+        ser_writedata32be(s, 0xE0000000 | n);
+    } else {
+        ser_writedata8(s, 0xF0);
+        ser_writedata32be(s, n);
+    }
+}
+
+template<typename Stream>
+uint32_t ReadOrderedVarInt(Stream& s) {
+    const uint32_t first = ser_readdata8(s);
+    if (first >= 0xF0) return ser_readdata32be(s);
+    // One extra byte per leading one bit
+    int extra = 0;
+    while (first & (0x80 >> extra)) extra++;
+    uint32_t n = first & (0x7F >> extra);
+    for (int i = 0; i < extra; i++) n = (n << 8) | ser_readdata8(s);
+    return n;
+}
+
+/** Number of hash bytes an address of this type uses; the rest of hashBytes is zero. */
+inline size_t AddressHashSize(unsigned int type) {
+    // P2PKH, P2SH and P2WPKH are hash160s, P2TR keys (and anything else) 32 bytes.
+    return (type >= 1 && type <= 3) ? 20 : 32;
+}
+
+template<typename Stream>
+void WriteAddressHash(Stream& s, unsigned int type, const uint256& hashBytes) {
+    ser_writedata8(s, type);
+    s.write(std::as_bytes(std::span{hashBytes.begin(), AddressHashSize(type)}));
+}
+
+template<typename Stream>
+void ReadAddressHash(Stream& s, unsigned int& type, uint256& hashBytes) {
+    type = ser_readdata8(s);
+    hashBytes.SetNull();
+    s.read(std::as_writable_bytes(std::span{hashBytes.begin(), AddressHashSize(type)}));
+}
+
+/**
+ * On-disk key of an address delta since index version 2. It sorts like
+ * CAddressIndexKey, with the asset name replaced by an id that is local to
+ * the index and the txid moved to a key per transaction.
+ */
+struct CAddressIndexCompactKey {
+    unsigned int type;
+    uint256 hashBytes;
+    uint32_t assetId;
+    int blockHeight;
+    unsigned int txindex;
+    size_t index;
+    bool spending;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        WriteAddressHash(s, type, hashBytes);
+        WriteOrderedVarInt(s, assetId);
+        WriteOrderedVarInt(s, blockHeight);
+        WriteOrderedVarInt(s, txindex);
+        WriteOrderedVarInt(s, index);
+        char f = spending;
+        ser_writedata8(s, f);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        ReadAddressHash(s, type, hashBytes);
+        assetId = ReadOrderedVarInt(s);
+        blockHeight = ReadOrderedVarInt(s);
+        txindex = ReadOrderedVarInt(s);
+        index = ReadOrderedVarInt(s);
+        char f = ser_readdata8(s);
+        spending = f;
+    }
+
+    CAddressIndexCompactKey(const CAddressIndexKey& key, uint32_t asset) {
+        type = key.type;
+        hashBytes = key.hashBytes;
+        assetId = asset;
+        blockHeight = key.blockHeight;
+        txindex = key.txindex;
+        index = key.index;
+        spending = key.spending;
+    }
+
+    CAddressIndexCompactKey() {
+        SetNull();
+    }
+
+    void SetNull() {
+        type = 0;
+        hashBytes.SetNull();
+        assetId = 0;
+        blockHeight = 0;
+        txindex = 0;
+        index = 0;
+        spending = false;
+    }
+
+    friend bool operator==(const CAddressIndexCompactKey& a, const CAddressIndexCompactKey& b) {
+        return a.type == b.type && a.hashBytes == b.hashBytes && a.assetId == b.assetId &&
+               a.blockHeight == b.blockHeight && a.txindex == b.txindex &&
+               a.index == b.index && a.spending == b.spending;
+    }
+};
+
+/** On-disk key of an unspent output since index version 2. */
+struct CAddressUnspentCompactKey {
+    unsigned int type;
+    uint256 hashBytes;
+    uint32_t assetId;
+    uint256 txhash;
+    size_t index;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        WriteAddressHash(s, type, hashBytes);
+        WriteOrderedVarInt(s, assetId);
+        txhash.Serialize(s);
+        WriteOrderedVarInt(s, index);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        ReadAddressHash(s, type, hashBytes);
+        assetId = ReadOrderedVarInt(s);
+        txhash.Unserialize(s);
+        index = ReadOrderedVarInt(s);
+    }
+
+    CAddressUnspentCompactKey(const CAddressUnspentKey& key, uint32_t asset) {
+        type = key.type;
+        hashBytes = key.hashBytes;
+        assetId = asset;
+        txhash = key.txhash;
+        index = key.index;
+    }
+
+    CAddressUnspentCompactKey() {
+        SetNull();
+    }
+
+    void SetNull() {
+        type = 0;
+        hashBytes.SetNull();
+        assetId = 0;
+        txhash.SetNull();
+        index = 0;
+    }
+
+    friend bool operator==(const CAddressUnspentCompactKey& a, const CAddressUnspentCompactKey& b) {
+        return a.type == b.type && a.hashBytes == b.hashBytes && a.assetId == b.assetId &&
+               a.txhash == b.txhash && a.index == b.index;
+    }
+};
+
+/** Prefix of the compact keys of one address, optionally narrowed to an asset and a start height. */
+struct CAddressIndexCompactIteratorKey {
+    unsigned int type;
+    uint256 hashBytes;
+    std::optional<uint32_t> assetId;
+    std::optional<int> blockHeight;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        WriteAddressHash(s, type, hashBytes);
+        if (assetId) {
+            WriteOrderedVarInt(s, *assetId);
+            if (blockHeight) WriteOrderedVarInt(s, *blockHeight);
+        }
+    }
+
+    CAddressIndexCompactIteratorKey(unsigned int addressType, uint256 addressHash,
+                                    std::optional<uint32_t> asset = std::nullopt, std::optional<int> height = std::nullopt) {
+        type = addressType;
+        hashBytes = addressHash;
+        assetId = asset;
+        blockHeight = height;
+    }
+};
+
+/** Key of the txid of a transaction that has address deltas. */
+struct CAddressIndexTxKey {
+    int blockHeight;
+    unsigned int txindex;
+
+    template<typename Stream>
+    void Serialize(Stream& s) const {
+        ser_writedata32be(s, blockHeight);
+        WriteOrderedVarInt(s, txindex);
+    }
+    template<typename Stream>
+    void Unserialize(Stream& s) {
+        blockHeight = ser_readdata32be(s);
+        txindex = ReadOrderedVarInt(s);
+    }
+
+    CAddressIndexTxKey(int height, unsigned int blockindex) {
+        blockHeight = height;
+        txindex = blockindex;
+    }
+
+    CAddressIndexTxKey() {
+        blockHeight = 0;
+        txindex = 0;
+    }
+};
+
+/** Running totals of one asset at one address, as of the index tip. */
+struct CAddressBalance {
+    CAmount balance;
+    CAmount received;
+    int64_t txCount;
+
+    SERIALIZE_METHODS(CAddressBalance, obj) {
+        READWRITE(obj.balance, obj.received, obj.txCount);
+    }
+
+    CAddressBalance() {
+        SetNull();
+    }
+
+    void SetNull() {
+        balance = 0;
+        received = 0;
+        txCount = 0;
+    }
+
+    bool IsNull() const {
+        return balance == 0 && received == 0 && txCount == 0;
+    }
+
+    CAddressBalance& operator+=(const CAddressBalance& other) {
+        balance += other.balance;
+        received += other.received;
+        txCount += other.txCount;
+        return *this;
+    }
+};
+
 struct CMempoolAddressDelta
 {
     int64_t time;
@@ -0,0 +1,109 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ASSETS_ASSETBALANCEMAP_H
+#define BITCOIN_ASSETS_ASSETBALANCEMAP_H
+
+#include <consensus/amount.h>
+#include <memusage.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+/**
+ * Asset balances keyed by (asset name, address), which also keeps the keys
+ * ordered by (address, asset name). The balances of one asset and the
+ * balances of one address are each a single range, so neither lookup has
+ * to scan the whole map.
+ *
+ * Only the subset of the std::map interface the asset caches use is
+ * exposed, so every insertion goes through the second index. Entries are
+ * never erased one at a time.
+ */
+class CAssetBalanceMap
+{
+public:
+    using key_type = std::pair<std::string, std::string>;
+    using Map = std::map<key_type, CAmount>;
+    using iterator = Map::iterator;
+    using const_iterator = Map::const_iterator;
+
+    iterator begin() { return m_balances.begin(); }
+    iterator end() { return m_balances.end(); }
+    const_iterator begin() const { return m_balances.begin(); }
+    const_iterator end() const { return m_balances.end(); }
+
+    size_t size() const { return m_balances.size(); }
+    bool empty() const { return m_balances.empty(); }
+    size_t count(const key_type& key) const { return m_balances.count(key); }
+    iterator find(const key_type& key) { return m_balances.find(key); }
+    const_iterator find(const key_type& key) const { return m_balances.find(key); }
+    CAmount& at(const key_type& key) { return m_balances.at(key); }
+    const CAmount& at(const key_type& key) const { return m_balances.at(key); }
+
+    CAmount& operator[](const key_type& key)
+    {
+        const auto [it, inserted] = m_balances.try_emplace(key);
+        if (inserted) m_by_address.emplace(key.second, key.first);
+        return it->second;
+    }
+
+    template <typename Value>
+    std::pair<iterator, bool> insert(Value&& value)
+    {
+        auto result = m_balances.insert(std::forward<Value>(value));
+        if (result.second) m_by_address.emplace(result.first->first.second, result.first->first.first);
+        return result;
+    }
+
+    void clear()
+    {
+        m_balances.clear();
+        m_by_address.clear();
+    }
+
+    //! Move every balance of from into this map, replacing existing ones, and leave from empty.
+    void Merge(CAssetBalanceMap& from)
+    {
+        m_balances.merge(from.m_balances);
+        // Whatever merge() left behind has a key that is already here
+        for (auto& [key, amount] : from.m_balances) {
+            m_balances.find(key)->second = amount;
+        }
+        m_by_address.merge(from.m_by_address);
+        from.clear();
+    }
+
+    //! Call fn(address, amount) for each balance of assetName, in address order.
+    template <typename Fn>
+    void ForEachAddress(const std::string& assetName, Fn&& fn) const
+    {
+        for (auto it = m_balances.lower_bound({assetName, std::string()}); it != m_balances.end() && it->first.first == assetName; ++it) {
+            fn(it->first.second, it->second);
+        }
+    }
+
+    //! Call fn(assetName, amount) for each balance held by address, in asset name order.
+    template <typename Fn>
+    void ForEachAsset(const std::string& address, Fn&& fn) const
+    {
+        for (auto it = m_by_address.lower_bound({address, std::string()}); it != m_by_address.end() && it->first == address; ++it) {
+            fn(it->second, m_balances.at({it->second, it->first}));
+        }
+    }
+
+    size_t DynamicMemoryUsage() const
+    {
+        return memusage::DynamicUsage(m_balances) + memusage::DynamicUsage(m_by_address);
+    }
+
+private:
+    Map m_balances;
+    //! (address, asset name) for every key of m_balances
+    std::set<std::pair<std::string, std::string>> m_by_address;
+};
+
+#endif // BITCOIN_ASSETS_ASSETBALANCEMAP_H
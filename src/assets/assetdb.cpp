@@ -9,14 +9,20 @@
 #include <serialize.h>
 
 static const uint8_t ASSET_FLAG = 'A';
-static const uint8_t ASSET_ADDRESS_QUANTITY_FLAG = 'B';
-static const uint8_t ADDRESS_ASSET_QUANTITY_FLAG = 'C';
+static const uint8_t ASSET_ADDRESS_QUANTITY_FLAG = 'b'; // <asset name, CAssetAddressKey> -> quantity
+static const uint8_t ADDRESS_ASSET_QUANTITY_FLAG = 'c'; // <CAssetAddressKey, asset name> -> quantity
+static const uint8_t LEGACY_ASSET_ADDRESS_QUANTITY_FLAG = 'B'; // <asset name, address string> -> quantity
+static const uint8_t LEGACY_ADDRESS_ASSET_QUANTITY_FLAG = 'C'; // <address string, asset name> -> quantity
 static const uint8_t MY_ASSET_FLAG = 'M';
 static const uint8_t BLOCK_ASSET_UNDO_DATA = 'U';
 static const uint8_t MEMPOOL_REISSUED_TX = 'Z';
 static const uint8_t ASSET_BEST_BLOCK_FLAG = 'T'; // Tip tracking
+static const uint8_t PENDING_RESTRICTED_FLAG = 'P'; // Restricted DB changes of an unfinished flush
+static const uint8_t HOT_ASSETS_FLAG = 'W'; // Assets to warm the cache with at startup
 
 [[maybe_unused]] static size_t MAX_DATABASE_RESULTS = 50000;
+//! Bytes of key rewrites to accumulate before writing them out
+static const size_t ASSET_DB_BATCH_SIZE = 16 << 20;
 
 CAssetsDB::CAssetsDB(const fs::path& datadir, size_t nCacheSize, bool fMemory, bool fWipe)
     : CDBWrapper(DBParams{
@@ -30,16 +36,71 @@ CAssetsDB::CAssetsDB(const fs::path& datadir, size_t nCacheSize, bool fMemory, b
 bool CAssetsDB::WriteAssetData(const CNewAsset &asset, const int nHeight, const uint256& blockHash)
 {
     CDatabasedAssetData data(asset, nHeight, blockHash);
-    return Write(std::make_pair(ASSET_FLAG, asset.strName), data);
+    bool ret = Write(std::make_pair(ASSET_FLAG, asset.strName), data);
+    ++m_asset_data_writes;
+    return ret;
 }
 
 bool CAssetsDB::WriteAssetAddressQuantity(const std::string &assetName, const std::string &address, const CAmount &quantity)
 {
-    return Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)), quantity);
+    return Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey::FromString(address))), quantity);
 }
 
 bool CAssetsDB::WriteAddressAssetQuantity(const std::string &address, const std::string &assetName, const CAmount& quantity) {
-    return Write(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)), quantity);
+    return Write(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(CAssetAddressKey::FromString(address), assetName)), quantity);
+}
+
+void CAssetsDB::WriteAssetData(CDBBatch& batch, const CNewAsset& asset, const int nHeight, const uint256& blockHash)
+{
+    batch.Write(std::make_pair(ASSET_FLAG, asset.strName), CDatabasedAssetData(asset, nHeight, blockHash));
+}
+
+void CAssetsDB::WriteAssetAddressQuantity(CDBBatch& batch, const std::string& assetName, const std::string& address, const CAmount& quantity)
+{
+    batch.Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey::FromString(address))), quantity);
+}
+
+void CAssetsDB::WriteAddressAssetQuantity(CDBBatch& batch, const std::string& address, const std::string& assetName, const CAmount& quantity)
+{
+    batch.Write(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(CAssetAddressKey::FromString(address), assetName)), quantity);
+}
+
+void CAssetsDB::EraseAssetData(CDBBatch& batch, const std::string& assetName)
+{
+    batch.Erase(std::make_pair(ASSET_FLAG, assetName));
+}
+
+void CAssetsDB::EraseAssetAddressQuantity(CDBBatch& batch, const std::string& assetName, const std::string& address)
+{
+    batch.Erase(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey::FromString(address))));
+}
+
+void CAssetsDB::EraseAddressAssetQuantity(CDBBatch& batch, const std::string& address, const std::string& assetName)
+{
+    batch.Erase(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(CAssetAddressKey::FromString(address), assetName)));
+}
+
+bool CAssetsDB::WriteFlushBatch(CDBBatch& batch, const CRestrictedDBBatch& restricted, const uint256& bestBlock)
+{
+    if (!restricted.IsEmpty()) {
+        batch.Write(PENDING_RESTRICTED_FLAG, restricted);
+    }
+    if (!bestBlock.IsNull()) {
+        batch.Write(ASSET_BEST_BLOCK_FLAG, bestBlock);
+    }
+    bool ret = WriteBatch(batch, true);
+    ++m_asset_data_writes;
+    return ret;
+}
+
+bool CAssetsDB::ReadPendingRestrictedBatch(CRestrictedDBBatch& restricted)
+{
+    return Read(PENDING_RESTRICTED_FLAG, restricted);
+}
+
+bool CAssetsDB::ErasePendingRestrictedBatch()
+{
+    return Erase(PENDING_RESTRICTED_FLAG, true);
 }
 
 bool CAssetsDB::ReadAssetData(const std::string& strName, CNewAsset& asset, int& nHeight, uint256& blockHash)
@@ -58,7 +119,7 @@ bool CAssetsDB::ReadAssetData(const std::string& strName, CNewAsset& asset, int&
 
 bool CAssetsDB::ReadAssetAddressQuantity(const std::string& assetName, const std::string& address, CAmount& quantity)
 {
-    return Read(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)), quantity);
+    return Read(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey::FromString(address))), quantity);
 }
 
 bool CAssetsDB::WriteBestBlock(const uint256& blockHash)
@@ -72,12 +133,14 @@ bool CAssetsDB::ReadBestBlock(uint256& blockHash)
 }
 
 bool CAssetsDB::ReadAddressAssetQuantity(const std::string &address, const std::string &assetName, CAmount& quantity) {
-    return Read(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)), quantity);
+    return Read(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(CAssetAddressKey::FromString(address), assetName)), quantity);
 }
 
 bool CAssetsDB::EraseAssetData(const std::string& assetName)
 {
-    return Erase(std::make_pair(ASSET_FLAG, assetName));
+    bool ret = Erase(std::make_pair(ASSET_FLAG, assetName));
+    ++m_asset_data_writes;
+    return ret;
 }
 
 bool CAssetsDB::EraseMyAssetData(const std::string& assetName)
@@ -86,11 +149,11 @@ bool CAssetsDB::EraseMyAssetData(const std::string& assetName)
 }
 
 bool CAssetsDB::EraseAssetAddressQuantity(const std::string &assetName, const std::string &address) {
-    return Erase(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)));
+    return Erase(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey::FromString(address))));
 }
 
 bool CAssetsDB::EraseAddressAssetQuantity(const std::string &address, const std::string &assetName) {
-    return Erase(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, assetName)));
+    return Erase(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(CAssetAddressKey::FromString(address), assetName)));
 }
 
 bool CAssetsDB::EraseAllAssets()
@@ -106,37 +169,78 @@ bool CAssetsDB::EraseAllAssets()
             break;
         }
     }
+    ++m_asset_data_writes;
     return true;
 }
 
-bool CAssetsDB::EraseAllAddressQuantities()
+/** Erase every key under `flag`, where the part after the flag deserializes as T. */
+template <typename T>
+static void EraseKeySpace(CDBWrapper& db, uint8_t flag)
 {
-    // Erase 'B' keys: <assetName, address> -> amount
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), std::string())));
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(flag);
+    CDBBatch batch(db);
     while (pcursor->Valid()) {
-        std::pair<uint8_t, std::pair<std::string, std::string>> key;
-        if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG) {
-            Erase(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, key.second));
+        std::pair<uint8_t, T> key;
+        if (pcursor->GetKey(key) && key.first == flag) {
+            batch.Erase(key);
+            if (batch.ApproximateSize() > ASSET_DB_BATCH_SIZE) {
+                db.WriteBatch(batch);
+                batch.Clear();
+            }
             pcursor->Next();
         } else {
             break;
         }
     }
+    db.WriteBatch(batch);
+}
 
-    // Erase 'C' keys: <address, assetName> -> amount
-    std::unique_ptr<CDBIterator> pcursor2(NewIterator());
-    pcursor2->Seek(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(std::string(), std::string())));
-    while (pcursor2->Valid()) {
-        std::pair<uint8_t, std::pair<std::string, std::string>> key;
-        if (pcursor2->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG) {
-            Erase(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, key.second));
-            pcursor2->Next();
-        } else {
-            break;
+bool CAssetsDB::EraseAllAddressQuantities()
+{
+    EraseKeySpace<std::pair<std::string, CAssetAddressKey>>(*this, ASSET_ADDRESS_QUANTITY_FLAG);
+    EraseKeySpace<std::pair<CAssetAddressKey, std::string>>(*this, ADDRESS_ASSET_QUANTITY_FLAG);
+    EraseKeySpace<std::pair<std::string, std::string>>(*this, LEGACY_ASSET_ADDRESS_QUANTITY_FLAG);
+    EraseKeySpace<std::pair<std::string, std::string>>(*this, LEGACY_ADDRESS_ASSET_QUANTITY_FLAG);
+    return true;
+}
+
+bool CAssetsDB::UpgradeAddressQuantityKeys()
+{
+    // Both legacy key spaces are converted on their own, so a partially
+    // upgraded database (one interrupted between batches) finishes cleanly.
+    size_t upgraded{0};
+    for (const uint8_t legacy_flag : {LEGACY_ASSET_ADDRESS_QUANTITY_FLAG, LEGACY_ADDRESS_ASSET_QUANTITY_FLAG}) {
+        const bool asset_first{legacy_flag == LEGACY_ASSET_ADDRESS_QUANTITY_FLAG};
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(legacy_flag);
+        CDBBatch batch(*this);
+        while (pcursor->Valid()) {
+            std::pair<uint8_t, std::pair<std::string, std::string>> key;
+            if (!pcursor->GetKey(key) || key.first != legacy_flag) break;
+            CAmount quantity;
+            if (!pcursor->GetValue(quantity)) {
+                LogError("%s: failed to read address quantity from database\n", __func__);
+                return false;
+            }
+            if (asset_first) {
+                batch.Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(key.second.first, CAssetAddressKey::FromString(key.second.second))), quantity);
+            } else {
+                batch.Write(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(CAssetAddressKey::FromString(key.second.first), key.second.second)), quantity);
+            }
+            batch.Erase(key);
+            if (batch.ApproximateSize() > ASSET_DB_BATCH_SIZE) {
+                if (!WriteBatch(batch, true)) return false;
+                batch.Clear();
+            }
+            ++upgraded;
+            pcursor->Next();
         }
+        if (!WriteBatch(batch, true)) return false;
+    }
+    if (upgraded > 0) {
+        LogPrintf("Upgraded %u asset balance keys to binary address keys\n", upgraded);
     }
-
     return true;
 }
 
@@ -173,61 +277,29 @@ bool CAssetsDB::ReadReissuedMempoolState(std::map<std::string, uint256>& mapReis
     return rv;
 }
 
-bool CAssetsDB::LoadAssets(CLRUCache<std::string, CDatabasedAssetData>& cache,
-                           std::map<std::pair<std::string, std::string>, CAmount>* pMapAssetsAddressAmount,
-                           bool fAssetIndex)
+bool CAssetsDB::WriteHotAssets(const std::vector<std::string>& names)
 {
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    return Write(HOT_ASSETS_FLAG, names);
+}
 
+bool CAssetsDB::ReadHotAssets(std::vector<std::string>& names)
+{
+    names.clear();
+    return Read(HOT_ASSETS_FLAG, names);
+}
+
+bool CAssetsDB::ReadAssetNames(std::vector<std::string>& names, size_t max_count)
+{
+    names.clear();
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
     pcursor->Seek(std::make_pair(ASSET_FLAG, std::string()));
 
-    // Load assets
-    while (pcursor->Valid()) {
+    while (pcursor->Valid() && names.size() < max_count) {
         std::pair<uint8_t, std::string> key;
-        if (pcursor->GetKey(key) && key.first == ASSET_FLAG) {
-            CDatabasedAssetData data;
-            if (pcursor->GetValue(data)) {
-                cache.Put(data.asset.strName, data);
-                pcursor->Next();
-
-                // Loaded enough from database to have in memory.
-                // No need to load everything if it is just going to be removed from the cache
-                if (cache.Size() == (cache.MaxSize() / 2))
-                    break;
-            } else {
-                LogError("%s: failed to read asset\n", __func__);
-                return false;
-            }
-        } else {
-            break;
-        }
-    }
-
-    if (fAssetIndex && pMapAssetsAddressAmount) {
-        std::unique_ptr<CDBIterator> pcursor3(NewIterator());
-        pcursor3->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), std::string())));
-
-        // Load mapAssetAddressAmount
-        while (pcursor3->Valid()) {
-            std::pair<uint8_t, std::pair<std::string, std::string> > key; // <Asset Name, Address> -> Quantity
-            if (pcursor3->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG) {
-                CAmount value;
-                if (pcursor3->GetValue(value)) {
-                    pMapAssetsAddressAmount->insert(
-                            std::make_pair(std::make_pair(key.second.first, key.second.second), value));
-                    if (pMapAssetsAddressAmount->size() > MAX_DATABASE_RESULTS)
-                        break;
-                    pcursor3->Next();
-                } else {
-                    LogError("%s: failed to read address quantity from database\n", __func__);
-                    return false;
-                }
-            } else {
-                break;
-            }
-        }
+        if (!pcursor->GetKey(key) || key.first != ASSET_FLAG) break;
+        names.push_back(std::move(key.second));
+        pcursor->Next();
     }
-
     return true;
 }
 
@@ -298,15 +370,19 @@ bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::st
 
 bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start)
 {
+    const CAssetAddressKey address_key{CAssetAddressKey::FromString(address)};
+    const auto seek_key{std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address_key, std::string()))};
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, std::string())));
+    pcursor->Seek(seek_key);
 
     if (fGetTotal) {
         totalEntries = 0;
         while (pcursor->Valid()) {
-            std::pair<uint8_t, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
+            std::pair<uint8_t, std::pair<CAssetAddressKey, std::string> > key;
+            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address_key) {
                 totalEntries++;
+            } else {
+                break;
             }
             pcursor->Next();
         }
@@ -321,14 +397,16 @@ bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAss
         // compute table size for backwards offset
         long table_size = 0;
         while (pcursor->Valid()) {
-            std::pair<uint8_t, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
+            std::pair<uint8_t, std::pair<CAssetAddressKey, std::string> > key;
+            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address_key) {
                 table_size += 1;
+            } else {
+                break;
             }
             pcursor->Next();
         }
         skip = table_size + start;
-        pcursor->SeekToFirst();
+        pcursor->Seek(seek_key);
     }
 
     size_t loaded = 0;
@@ -336,8 +414,8 @@ bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAss
 
     // Load assets
     while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
-        std::pair<uint8_t, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
+        std::pair<uint8_t, std::pair<CAssetAddressKey, std::string> > key;
+        if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address_key) {
                 if (offset < skip) {
                     offset += 1;
                 }
@@ -364,14 +442,17 @@ bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAss
 bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, std::string())));
+    const auto seek_key{std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey()))};
+    pcursor->Seek(seek_key);
 
     if (fGetTotal) {
         totalEntries = 0;
         while (pcursor->Valid()) {
-            std::pair<uint8_t, std::pair<std::string, std::string> > key;
+            std::pair<uint8_t, std::pair<std::string, CAssetAddressKey> > key;
             if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
                 totalEntries += 1;
+            } else {
+                break;
             }
             pcursor->Next();
         }
@@ -386,14 +467,16 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
         // compute table size for backwards offset
         long table_size = 0;
         while (pcursor->Valid()) {
-            std::pair<uint8_t, std::pair<std::string, std::string> > key;
+            std::pair<uint8_t, std::pair<std::string, CAssetAddressKey> > key;
             if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
                 table_size += 1;
+            } else {
+                break;
             }
             pcursor->Next();
         }
         skip = table_size + start;
-        pcursor->SeekToFirst();
+        pcursor->Seek(seek_key);
     }
 
     size_t loaded = 0;
@@ -401,7 +484,7 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
 
     // Load assets
     while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
-        std::pair<uint8_t, std::pair<std::string, std::string> > key;
+        std::pair<uint8_t, std::pair<std::string, CAssetAddressKey> > key;
         if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
             if (offset < skip) {
                 offset += 1;
@@ -409,7 +492,7 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
             else {
                 CAmount amount;
                 if (pcursor->GetValue(amount)) {
-                    vecAddressAmount.emplace_back(std::make_pair(key.second.second, amount));
+                    vecAddressAmount.emplace_back(std::make_pair(key.second.second.ToString(), amount));
                     loaded += 1;
                 } else {
                     LogError("%s: failed to read asset address quantity\n", __func__);
@@ -425,6 +508,44 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
     return true;
 }
 
+bool CAssetsDB::ForEachAssetHolder(const std::string& assetName, const std::function<bool(const CAssetAddressKey&, CAmount)>& fn)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, CAssetAddressKey())));
+
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, std::pair<std::string, CAssetAddressKey> > key;
+        if (!pcursor->GetKey(key) || key.first != ASSET_ADDRESS_QUANTITY_FLAG || key.second.first != assetName) break;
+        CAmount amount;
+        if (!pcursor->GetValue(amount)) {
+            LogError("%s: failed to read asset address quantity\n", __func__);
+            return false;
+        }
+        if (!fn(key.second.second, amount)) return false;
+        pcursor->Next();
+    }
+    return true;
+}
+
+bool CAssetsDB::ForEachAddressAsset(CDBIterator& cursor, const std::string& address, const std::function<bool(const std::string&, CAmount)>& fn)
+{
+    const CAssetAddressKey address_key{CAssetAddressKey::FromString(address)};
+    cursor.Seek(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address_key, std::string())));
+
+    while (cursor.Valid()) {
+        std::pair<uint8_t, std::pair<CAssetAddressKey, std::string> > key;
+        if (!cursor.GetKey(key) || key.first != ADDRESS_ASSET_QUANTITY_FLAG || !(key.second.first == address_key)) break;
+        CAmount amount;
+        if (!cursor.GetValue(amount)) {
+            LogError("%s: failed to read address asset quantity\n", __func__);
+            return false;
+        }
+        if (!fn(key.second.second, amount)) return false;
+        cursor.Next();
+    }
+    return true;
+}
+
 bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets)
 {
     return CAssetsDB::AssetDir(assets, "*", MAX_SIZE, 0);
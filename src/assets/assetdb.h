@@ -6,11 +6,16 @@
 #ifndef BITCOIN_ASSETS_ASSETDB_H
 #define BITCOIN_ASSETS_ASSETDB_H
 
+#include <assets/assetlookup.h>
+#include <assets/restricteddb.h>
 #include <dbwrapper.h>
 #include <serialize.h>
 #include <util/fs.h>
 #include <consensus/amount.h>
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -20,9 +25,7 @@ class CNewAsset;
 class uint256;
 class COutPoint;
 class CDatabasedAssetData;
-
-template <typename Key, typename Value>
-class CLRUCache;
+class CAssetAddressKey;
 
 struct CBlockAssetUndo
 {
@@ -101,6 +104,20 @@ public:
     bool WriteBestBlock(const uint256& blockHash);
     bool ReadBestBlock(uint256& blockHash);
 
+    // Batched writes of an asset flush, committed by WriteFlushBatch
+    void WriteAssetData(CDBBatch& batch, const CNewAsset& asset, const int nHeight, const uint256& blockHash);
+    void WriteAssetAddressQuantity(CDBBatch& batch, const std::string& assetName, const std::string& address, const CAmount& quantity);
+    void WriteAddressAssetQuantity(CDBBatch& batch, const std::string& address, const std::string& assetName, const CAmount& quantity);
+    void EraseAssetData(CDBBatch& batch, const std::string& assetName);
+    void EraseAssetAddressQuantity(CDBBatch& batch, const std::string& assetName, const std::string& address);
+    void EraseAddressAssetQuantity(CDBBatch& batch, const std::string& address, const std::string& assetName);
+
+    // Commit an asset flush. The restricted database changes are kept until
+    // ErasePendingRestrictedBatch, so they can be replayed after a crash.
+    bool WriteFlushBatch(CDBBatch& batch, const CRestrictedDBBatch& restricted, const uint256& bestBlock);
+    bool ReadPendingRestrictedBatch(CRestrictedDBBatch& restricted);
+    bool ErasePendingRestrictedBatch();
+
     // Erase from database functions
     bool EraseAssetData(const std::string& assetName);
     bool EraseMyAssetData(const std::string& assetName);
@@ -109,15 +126,37 @@ public:
     bool EraseAllAssets();
     bool EraseAllAddressQuantities();
 
+    // Rewrite balances stored under address strings to binary address keys
+    bool UpgradeAddressQuantityKeys();
+
     // Helper functions
-    bool LoadAssets(class CLRUCache<std::string, CDatabasedAssetData>& cache,
-                    std::map<std::pair<std::string, std::string>, CAmount>* pMapAssetsAddressAmount,
-                    bool fAssetIndex);
+    // Names of the assets cached at the last shutdown, hottest first, used
+    // to warm the asset cache on the next start
+    bool WriteHotAssets(const std::vector<std::string>& names);
+    bool ReadHotAssets(std::vector<std::string>& names);
+    // Names of the first max_count assets in key order
+    bool ReadAssetNames(std::vector<std::string>& names, size_t max_count);
     bool AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start);
     bool AssetDir(std::vector<CDatabasedAssetData>& assets);
 
     bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start);
     bool AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start);
+
+    // Visit every holder of an asset in one pass over a single iterator, so
+    // all of them are read from the same view of the database. Returns false
+    // if a value can't be read or fn returns false.
+    bool ForEachAssetHolder(const std::string& assetName, const std::function<bool(const CAssetAddressKey&, CAmount)>& fn);
+
+    // Visit every asset held by an address through the given iterator, so a
+    // caller can create it under a lock and read the database after releasing it.
+    bool ForEachAddressAsset(CDBIterator& cursor, const std::string& address, const std::function<bool(const std::string&, CAmount)>& fn);
+
+    // Counts the writes that may change asset data. Asset data read without
+    // cs_main can be cached only if this hasn't changed since it was read.
+    uint64_t AssetDataWrites() const { return m_asset_data_writes; }
+
+private:
+    std::atomic<uint64_t> m_asset_data_writes{0};
 };
 
 
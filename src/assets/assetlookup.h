@@ -0,0 +1,303 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ASSETS_ASSETLOOKUP_H
+#define BITCOIN_ASSETS_ASSETLOOKUP_H
+
+#include <assets/assettypes.h>
+#include <memusage.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Heap memory owned by a cached asset value, beyond the value itself. */
+inline size_t AssetLookupValueUsage(int8_t) { return 0; }
+inline size_t AssetLookupValueUsage(const CNullAssetTxVerifierString& value)
+{
+    return memusage::DynamicUsage(value.verifier_string);
+}
+inline size_t AssetLookupValueUsage(const CDatabasedAssetData& value)
+{
+    return memusage::DynamicUsage(value.asset.strName) + memusage::DynamicUsage(value.asset.strIPFSHash) +
+           memusage::DynamicUsage(value.asset.strANSID);
+}
+
+struct AssetLookupStats {
+    size_t entries{0};
+    /** Bytes used by the slot arrays and the entries' heap memory. */
+    size_t usage{0};
+    size_t budget{0};
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+};
+
+/**
+ * Memory-bounded lookup table for asset database reads.
+ *
+ * Keys are spread over a fixed number of shards, each with its own lock, so
+ * lookups of different assets rarely contend. A shard is an open-addressing
+ * table with linear probing, and evicts with the CLOCK policy: a lookup marks
+ * its entry as referenced, and the clock hand skips (and unmarks) referenced
+ * entries before evicting the first unreferenced one.
+ *
+ * The budget covers each shard's slot array as well as the heap memory of the
+ * entries in it. A slot array doubles when it is more than three quarters
+ * full and halves when it is less than a quarter full.
+ */
+template <typename Key, typename Value, typename Hasher = std::hash<Key>>
+class AssetLookupTable
+{
+public:
+    explicit AssetLookupTable(size_t max_usage) : m_budget(max_usage) { Clear(); }
+
+    AssetLookupTable(const AssetLookupTable&) = delete;
+    AssetLookupTable& operator=(const AssetLookupTable&) = delete;
+
+    void Put(const Key& key, const Value& value)
+    {
+        const size_t hash{Hasher{}(key)};
+        Shard& shard{ShardFor(hash)};
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (const size_t pos{shard.Find(hash, key)}; pos != NOT_FOUND) shard.EraseAt(pos);
+
+        const size_t usage{memusage::DynamicUsage(key) + AssetLookupValueUsage(value)};
+        const size_t shard_budget{m_budget / SHARDS};
+        const auto fits = [&] { return SlotsUsage(shard.SlotsFor(shard.count + 1)) + shard.usage + usage <= shard_budget; };
+        while (shard.count > 0 && !fits()) {
+            shard.EvictOne();
+        }
+        if (!fits()) {
+            shard.Resize(shard.SlotsFor(shard.count));
+            return;
+        }
+        shard.Resize(shard.SlotsFor(shard.count + 1));
+        shard.Insert(Slot{key, value, hash, usage, /*used=*/true, /*referenced=*/false});
+    }
+
+    void Erase(const Key& key)
+    {
+        const size_t hash{Hasher{}(key)};
+        Shard& shard{ShardFor(hash)};
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (const size_t pos{shard.Find(hash, key)}; pos != NOT_FOUND) {
+            shard.EraseAt(pos);
+            shard.Resize(shard.SlotsFor(shard.count));
+        }
+    }
+
+    /** Return a copy of the cached value, counting a hit or a miss. */
+    std::optional<Value> Get(const Key& key)
+    {
+        const size_t hash{Hasher{}(key)};
+        Shard& shard{ShardFor(hash)};
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const size_t pos{shard.Find(hash, key)};
+        if (pos == NOT_FOUND) {
+            ++shard.misses;
+            return std::nullopt;
+        }
+        ++shard.hits;
+        shard.slots[pos].referenced = true;
+        return shard.slots[pos].value;
+    }
+
+    /** Like Get(), for callers that only need to know whether key is cached. */
+    bool Exists(const Key& key)
+    {
+        const size_t hash{Hasher{}(key)};
+        Shard& shard{ShardFor(hash)};
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const size_t pos{shard.Find(hash, key)};
+        if (pos == NOT_FOUND) {
+            ++shard.misses;
+            return false;
+        }
+        ++shard.hits;
+        shard.slots[pos].referenced = true;
+        return true;
+    }
+
+    void Clear()
+    {
+        for (Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            // Swap rather than assign, which would keep the old capacity.
+            std::vector<Slot>(MIN_SLOTS).swap(shard.slots);
+            shard.count = 0;
+            shard.usage = 0;
+            shard.hand = 0;
+        }
+    }
+
+    size_t DynamicMemoryUsage() const
+    {
+        size_t usage{0};
+        for (const Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            usage += shard.MemoryUsage();
+        }
+        return usage;
+    }
+
+    size_t MaxMemoryUsage() const { return m_budget; }
+
+    /** Return the cached keys, those looked up since the clock hand last passed them first. */
+    std::vector<Key> GetKeys() const
+    {
+        std::vector<Key> referenced;
+        std::vector<Key> rest;
+        for (const Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const Slot& slot : shard.slots) {
+                if (slot.used) (slot.referenced ? referenced : rest).push_back(slot.key);
+            }
+        }
+        referenced.insert(referenced.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+        return referenced;
+    }
+
+    AssetLookupStats GetStats() const
+    {
+        AssetLookupStats stats;
+        stats.budget = m_budget;
+        for (const Shard& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.entries += shard.count;
+            stats.usage += shard.MemoryUsage();
+            stats.hits += shard.hits;
+            stats.misses += shard.misses;
+            stats.evictions += shard.evictions;
+        }
+        return stats;
+    }
+
+private:
+    static constexpr size_t SHARDS{16};
+    static constexpr size_t MIN_SLOTS{16};
+    static constexpr size_t NOT_FOUND{~size_t{0}};
+
+    struct Slot {
+        Key key{};
+        Value value{};
+        size_t hash{0};
+        /** Heap memory of key and value. */
+        size_t usage{0};
+        bool used{false};
+        bool referenced{false};
+    };
+
+    static size_t SlotsUsage(size_t slots) { return memusage::MallocUsage(slots * sizeof(Slot)); }
+
+    struct Shard {
+        mutable std::mutex mutex;
+        /** Power-of-two sized, never more than three quarters full. */
+        std::vector<Slot> slots;
+        size_t count{0};
+        /** Heap memory of the entries, excluding the slot array. */
+        size_t usage{0};
+        /** CLOCK hand. */
+        size_t hand{0};
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+
+        size_t MemoryUsage() const { return memusage::DynamicUsage(slots) + usage; }
+
+        /** Slot array size for n entries, with hysteresis around the current size. */
+        size_t SlotsFor(size_t n) const
+        {
+            size_t size{slots.size()};
+            while (n * 4 > size * 3) size *= 2;
+            while (size > MIN_SLOTS && n * 4 < size) size /= 2;
+            return size;
+        }
+
+        size_t Home(size_t hash) const { return (hash / SHARDS) & (slots.size() - 1); }
+
+        size_t Find(size_t hash, const Key& key) const
+        {
+            const size_t mask{slots.size() - 1};
+            for (size_t pos{Home(hash)}; slots[pos].used; pos = (pos + 1) & mask) {
+                if (slots[pos].hash == hash && slots[pos].key == key) return pos;
+            }
+            return NOT_FOUND;
+        }
+
+        void Insert(Slot&& slot)
+        {
+            const size_t mask{slots.size() - 1};
+            size_t pos{Home(slot.hash)};
+            while (slots[pos].used) pos = (pos + 1) & mask;
+            usage += slot.usage;
+            ++count;
+            slots[pos] = std::move(slot);
+        }
+
+        /** Remove the entry at pos, shifting later entries of its probe run back. */
+        void EraseAt(size_t pos)
+        {
+            const size_t mask{slots.size() - 1};
+            usage -= slots[pos].usage;
+            --count;
+            for (size_t next{(pos + 1) & mask}; slots[next].used; next = (next + 1) & mask) {
+                // The entry at next may fill the hole unless its home lies
+                // cyclically within (pos, next].
+                const size_t home{Home(slots[next].hash)};
+                const bool stays{pos <= next ? (pos < home && home <= next) : (pos < home || home <= next)};
+                if (!stays) {
+                    slots[pos] = std::move(slots[next]);
+                    pos = next;
+                }
+            }
+            slots[pos] = Slot{};
+        }
+
+        void EvictOne()
+        {
+            const size_t mask{slots.size() - 1};
+            while (true) {
+                Slot& slot{slots[hand]};
+                if (slot.used && !slot.referenced) {
+                    // Backward shifting may move an unvisited entry under the
+                    // hand, so it stays in place.
+                    EraseAt(hand);
+                    ++evictions;
+                    return;
+                }
+                slot.referenced = false;
+                hand = (hand + 1) & mask;
+            }
+        }
+
+        /** Rehash into a slot array of the given power-of-two size. */
+        void Resize(size_t size)
+        {
+            if (size == slots.size()) return;
+            std::vector<Slot> old(size);
+            old.swap(slots);
+            count = 0;
+            usage = 0;
+            hand = 0;
+            for (Slot& slot : old) {
+                if (slot.used) Insert(std::move(slot));
+            }
+        }
+    };
+
+    Shard& ShardFor(size_t hash) { return m_shards[hash % SHARDS]; }
+
+    const size_t m_budget;
+    std::array<Shard, SHARDS> m_shards;
+};
+
+#endif // BITCOIN_ASSETS_ASSETLOOKUP_H
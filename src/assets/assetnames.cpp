@@ -0,0 +1,49 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <assets/assetnames.h>
+
+#include <util/check.h>
+
+#include <mutex>
+
+AssetId CAssetNameTable::Intern(std::string_view name)
+{
+    if (const auto id{Find(name)}) return *id;
+
+    std::unique_lock lock(m_mutex);
+    // Another thread may have interned it between the two locks.
+    if (const auto it{m_ids.find(name)}; it != m_ids.end()) return it->second;
+    const std::string& stored{m_names.emplace_back(name)};
+    const AssetId id{static_cast<AssetId>(m_names.size())};
+    m_ids.emplace(stored, id);
+    return id;
+}
+
+std::optional<AssetId> CAssetNameTable::Find(std::string_view name) const
+{
+    std::shared_lock lock(m_mutex);
+    const auto it{m_ids.find(name)};
+    if (it == m_ids.end()) return std::nullopt;
+    return it->second;
+}
+
+const std::string& CAssetNameTable::Name(AssetId id) const
+{
+    std::shared_lock lock(m_mutex);
+    Assert(id != NULL_ASSET_ID && id <= m_names.size());
+    return m_names[id - 1];
+}
+
+size_t CAssetNameTable::Size() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_names.size();
+}
+
+CAssetNameTable& AssetNames()
+{
+    static CAssetNameTable table;
+    return table;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ASSETS_ASSETNAMES_H
+#define BITCOIN_ASSETS_ASSETNAMES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/** Small integer standing in for an asset name, see CAssetNameTable. */
+using AssetId = uint32_t;
+
+/** Never assigned to a name; marks an entry that has not been interned. */
+static constexpr AssetId NULL_ASSET_ID = 0;
+
+/**
+ * Process-wide table of asset names, each given a stable AssetId the first
+ * time it is interned. Hot validation and mempool maps key on the id, so
+ * lookups hash and compare a 32-bit integer instead of a string.
+ *
+ * Ids are never reused or released, so only names of confirmed coins are
+ * interned: the table then holds no more names than the chain has assets,
+ * each of which paid for its issuance. Look up anything else, including the
+ * names of mempool transactions, with Find().
+ */
+class CAssetNameTable
+{
+public:
+    CAssetNameTable() = default;
+    CAssetNameTable(const CAssetNameTable&) = delete;
+    CAssetNameTable& operator=(const CAssetNameTable&) = delete;
+
+    /** Return the id of name, assigning the next free one if it is new. */
+    AssetId Intern(std::string_view name);
+
+    /** Return the id of name if it has been interned. */
+    std::optional<AssetId> Find(std::string_view name) const;
+
+    /** Return the name of an interned id. The reference stays valid. */
+    const std::string& Name(AssetId id) const;
+
+    size_t Size() const;
+
+private:
+    mutable std::shared_mutex m_mutex;
+    //! Names by id - 1. A deque never moves its elements, so the keys of
+    //! m_ids and the references returned by Name() stay valid.
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string_view, AssetId> m_ids;
+};
+
+/** The table shared by the node. */
+CAssetNameTable& AssetNames();
+
+#endif // BITCOIN_ASSETS_ASSETNAMES_H
@@ -3,6 +3,8 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
+#include <iterator>
 #include <regex>
 #include <script/script.h>
 #include <streams.h>
@@ -92,12 +94,12 @@ std::map<std::string, uint256> mapReissuedAssets;
 // Asset global state definitions
 CAssetsCache* passets = nullptr;
 CAssetsDB* passetsdb = nullptr;
-CLRUCache<std::string, CDatabasedAssetData>* passetsCache = nullptr;
+AssetLookupTable<std::string, CDatabasedAssetData>* passetsCache = nullptr;
 CRestrictedDB* prestricteddb = nullptr;
-CLRUCache<std::string, CNullAssetTxVerifierString>* passetsVerifierCache = nullptr;
-CLRUCache<std::string, int8_t>* passetsQualifierCache = nullptr;
-CLRUCache<std::string, int8_t>* passetsRestrictionCache = nullptr;
-CLRUCache<std::string, int8_t>* passetsGlobalRestrictionCache = nullptr;
+AssetLookupTable<std::string, CNullAssetTxVerifierString>* passetsVerifierCache = nullptr;
+AssetLookupTable<std::string, int8_t>* passetsQualifierCache = nullptr;
+AssetLookupTable<std::string, int8_t>* passetsRestrictionCache = nullptr;
+AssetLookupTable<std::string, int8_t>* passetsGlobalRestrictionCache = nullptr;
 bool fAssetIndex = false;
 
 bool AreAssetsDeployed()
@@ -775,6 +777,19 @@ bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::s
     return OwnerAssetFromScript(scriptPubKey, ownerName, strAddress);
 }
 
+/** ExtractDestination() returns no destination for asset scripts. The asset
+ *  payload follows a P2PKH script, whose key hash Solver() returns. */
+static void ExtractAssetDestination(const CScript& scriptPubKey, CTxDestination& destination)
+{
+    std::vector<std::vector<unsigned char>> solutions;
+    Solver(scriptPubKey, solutions);
+    if (solutions.size() == 1 && solutions[0].size() == uint160::size()) {
+        destination = PKHash(uint160(solutions[0]));
+    } else {
+        destination = CNoDestination(scriptPubKey);
+    }
+}
+
 bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress)
 {
     if (!IsScriptTransferAsset(scriptPubKey)) {
@@ -782,7 +797,7 @@ bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetT
     }
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -809,7 +824,7 @@ bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::stri
         return false;
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -835,7 +850,7 @@ bool MsgChannelAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew,
         return false;
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -861,7 +876,7 @@ bool QualifierAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew,
         return false;
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -887,7 +902,7 @@ bool RestrictedAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew,
         return false;
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -913,7 +928,7 @@ bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, s
         return false;
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -939,7 +954,7 @@ bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue,
         return false;
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -966,7 +981,7 @@ bool AssetNullDataFromScript(const CScript& scriptPubKey, CNullAssetTxData& asse
     }
 
     CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    ExtractAssetDestination(scriptPubKey, destination);
 
     strAddress = EncodeDestination(destination);
 
@@ -1814,47 +1829,19 @@ void CAssetsCache::AddToAssetBalance(const std::string& strName, const std::stri
     }
 }
 
-bool CAssetsCache::TrySpendCoin(const COutPoint& out, const CTxOut& txOut)
+bool CAssetsCache::TrySpendCoin(const COutPoint& out, const Coin& coin)
 {
-    // Placeholder strings that will get set if you successfully get the transfer or asset from the script
-    std::string address = "";
-    std::string assetName = "";
-    CAmount nAmount = -1;
+    // If it isn't an asset tx return true, we only fail if an error occurs
+    if (!coin.out.scriptPubKey.IsAssetScript())
+        return true;
 
-    // Get the asset tx data
-    int nType = -1;
-    bool fIsOwner = false;
-    if (txOut.scriptPubKey.IsAssetScript(nType, fIsOwner)) {
+    const CAssetOutputEntry* data = GetAssetOutput(coin);
+    if (!data)
+        return error("%s : ERROR Failed to get asset from the OutPoint: %s", __func__, out.ToString());
 
-        // Get the New Asset or Transfer Asset from the scriptPubKey
-        if (nType == TX_NEW_ASSET && !fIsOwner) {
-            CNewAsset asset;
-            if (AssetFromScript(txOut.scriptPubKey, asset, address)) {
-                assetName = asset.strName;
-                nAmount = asset.nAmount;
-            }
-        } else if (nType == TX_TRANSFER_ASSET) {
-            CAssetTransfer transfer;
-            if (TransferAssetFromScript(txOut.scriptPubKey, transfer, address)) {
-                assetName = transfer.strName;
-                nAmount = transfer.nAmount;
-            }
-        } else if (nType == TX_NEW_ASSET && fIsOwner) {
-            if (!OwnerAssetFromScript(txOut.scriptPubKey, assetName, address))
-                return error("%s : ERROR Failed to get owner asset from the OutPoint: %s", __func__,
-                             out.ToString());
-            nAmount = OWNER_ASSET_AMOUNT;
-        } else if (nType == TX_REISSUE_ASSET) {
-            CReissueAsset reissue;
-            if (ReissueAssetFromScript(txOut.scriptPubKey, reissue, address)) {
-                assetName = reissue.strName;
-                nAmount = reissue.nAmount;
-            }
-        }
-    } else {
-        // If it isn't an asset tx return true, we only fail if an error occurs
-        return true;
-    }
+    const std::string address = EncodeDestination(data->destination);
+    const std::string& assetName = data->assetName;
+    const CAmount nAmount = data->nAmount;
 
     // If we got the address and the assetName, proceed to remove it from the database, and in memory objects
     if (address != "" && assetName != "") {
@@ -1889,65 +1876,6 @@ bool CAssetsCache::ContainsAsset(const std::string& assetName)
     return CheckIfAssetExists(assetName);
 }
 
-bool CAssetsCache::UndoAssetCoin(const Coin& coin, const COutPoint& out)
-{
-    std::string strAddress = "";
-    std::string assetName = "";
-    CAmount nAmount = 0;
-
-    // Get the asset tx from the script
-    int nType = -1;
-    bool fIsOwner = false;
-    if(coin.out.scriptPubKey.IsAssetScript(nType, fIsOwner)) {
-
-        if (nType == TX_NEW_ASSET && !fIsOwner) {
-            CNewAsset asset;
-            if (!AssetFromScript(coin.out.scriptPubKey, asset, strAddress)) {
-                return error("%s : Failed to get asset from script while trying to undo asset spend. OutPoint : %s",
-                             __func__,
-                             out.ToString());
-            }
-            assetName = asset.strName;
-
-            nAmount = asset.nAmount;
-        } else if (nType == TX_TRANSFER_ASSET) {
-            CAssetTransfer transfer;
-            if (!TransferAssetFromScript(coin.out.scriptPubKey, transfer, strAddress))
-                return error(
-                        "%s : Failed to get transfer asset from script while trying to undo asset spend. OutPoint : %s",
-                        __func__,
-                        out.ToString());
-
-            assetName = transfer.strName;
-            nAmount = transfer.nAmount;
-        } else if (nType == TX_NEW_ASSET && fIsOwner) {
-            std::string ownerName;
-            if (!OwnerAssetFromScript(coin.out.scriptPubKey, ownerName, strAddress))
-                return error(
-                        "%s : Failed to get owner asset from script while trying to undo asset spend. OutPoint : %s",
-                        __func__, out.ToString());
-            assetName = ownerName;
-            nAmount = OWNER_ASSET_AMOUNT;
-        } else if (nType == TX_REISSUE_ASSET) {
-            CReissueAsset reissue;
-            if (!ReissueAssetFromScript(coin.out.scriptPubKey, reissue, strAddress))
-                return error(
-                        "%s : Failed to get reissue asset from script while trying to undo asset spend. OutPoint : %s",
-                        __func__, out.ToString());
-            assetName = reissue.strName;
-            nAmount = reissue.nAmount;
-        }
-    }
-
-    if (assetName == "" || strAddress == "" || nAmount == 0)
-        return error("%s : AssetName, Address or nAmount is invalid., Asset Name: %s, Address: %s, Amount: %d", __func__, assetName, strAddress, nAmount);
-
-    if (!AddBackSpentAsset(coin, assetName, strAddress, nAmount, out))
-        return error("%s : Failed to add back the spent asset. OutPoint : %s", __func__, out.ToString());
-
-    return true;
-}
-
 //! Changes Memory Only
 bool CAssetsCache::AddBackSpentAsset(const Coin& coin, const std::string& assetName, const std::string& address, const CAmount& nAmount, const COutPoint& out)
 {
@@ -2405,224 +2333,96 @@ bool CAssetsCache::RemoveRestrictedVerifier(const std::string& assetName, const
     return true;
 }
 
-bool CAssetsCache::DumpCacheToDatabase()
+bool CAssetsCache::DumpCacheToDatabase(const uint256& bestBlock)
 {
     try {
-        bool dirty = false;
-        std::string message;
+        // Collect every change into one batch per database, so the asset
+        // database moves to bestBlock in a single atomic write.
+        CDBBatch batch(*passetsdb);
+        CRestrictedDBBatch restrictedBatch;
 
         // Remove new assets from the database
-        for (auto newAsset : setNewAssetsToRemove) {
+        for (const auto& newAsset : setNewAssetsToRemove) {
             passetsCache->Erase(newAsset.asset.strName);
-            if (!passetsdb->EraseAssetData(newAsset.asset.strName)) {
-                dirty = true;
-                message = "_Failed Erasing New Asset Data from database";
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
-
-            if (!prestricteddb->EraseVerifier(newAsset.asset.strName)) {
-                dirty = true;
-                message = "_Failed Erasing verifier of new asset removal data from database";
-            }
+            passetsdb->EraseAssetData(batch, newAsset.asset.strName);
+            restrictedBatch.EraseVerifier(newAsset.asset.strName);
 
             if (fAssetIndex) {
-                if (!passetsdb->EraseAssetAddressQuantity(newAsset.asset.strName, newAsset.address)) {
-                    dirty = true;
-                    message = "_Failed Erasing Address Balance from database";
-                }
-
-                if (!passetsdb->EraseAddressAssetQuantity(newAsset.address, newAsset.asset.strName)) {
-                    dirty = true;
-                    message = "_Failed Erasing New Asset Address Balance from AddressAsset database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                passetsdb->EraseAssetAddressQuantity(batch, newAsset.asset.strName, newAsset.address);
+                passetsdb->EraseAddressAssetQuantity(batch, newAsset.address, newAsset.asset.strName);
             }
         }
 
         // Add the new assets to the database
-        for (auto newAsset : setNewAssetsToAdd) {
+        for (const auto& newAsset : setNewAssetsToAdd) {
             passetsCache->Put(newAsset.asset.strName, CDatabasedAssetData(newAsset.asset, newAsset.blockHeight, newAsset.blockHash));
-            if (!passetsdb->WriteAssetData(newAsset.asset, newAsset.blockHeight, newAsset.blockHash)) {
-                dirty = true;
-                message = "_Failed Writing New Asset Data to database";
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
+            passetsdb->WriteAssetData(batch, newAsset.asset, newAsset.blockHeight, newAsset.blockHash);
 
             if (fAssetIndex) {
-                if (!passetsdb->WriteAssetAddressQuantity(newAsset.asset.strName, newAsset.address,
-                                                          newAsset.asset.nAmount)) {
-                    dirty = true;
-                    message = "_Failed Writing Address Balance to database";
-                }
-
-                if (!passetsdb->WriteAddressAssetQuantity(newAsset.address, newAsset.asset.strName,
-                                                          newAsset.asset.nAmount)) {
-                    dirty = true;
-                    message = "_Failed Writing Address Balance to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                passetsdb->WriteAssetAddressQuantity(batch, newAsset.asset.strName, newAsset.address, newAsset.asset.nAmount);
+                passetsdb->WriteAddressAssetQuantity(batch, newAsset.address, newAsset.asset.strName, newAsset.asset.nAmount);
             }
         }
 
         if (fAssetIndex) {
             // Remove the new owners from database
-            for (auto ownerAsset : setNewOwnerAssetsToRemove) {
-                if (!passetsdb->EraseAssetAddressQuantity(ownerAsset.assetName, ownerAsset.address)) {
-                    dirty = true;
-                    message = "_Failed Erasing Owner Address Balance from database";
-                }
-
-                if (!passetsdb->EraseAddressAssetQuantity(ownerAsset.address, ownerAsset.assetName)) {
-                    dirty = true;
-                    message = "_Failed Erasing New Owner Address Balance from AddressAsset database";
-                }
-
-                if (dirty) {
-                    return error("%s : %s", __func__, message);
-                }
+            for (const auto& ownerAsset : setNewOwnerAssetsToRemove) {
+                passetsdb->EraseAssetAddressQuantity(batch, ownerAsset.assetName, ownerAsset.address);
+                passetsdb->EraseAddressAssetQuantity(batch, ownerAsset.address, ownerAsset.assetName);
             }
 
             // Add the new owners to database
-            for (auto ownerAsset : setNewOwnerAssetsToAdd) {
-                auto pair = std::make_pair(ownerAsset.assetName, ownerAsset.address);
-                if (mapAssetsAddressAmount.count(pair) && mapAssetsAddressAmount.at(pair) > 0) {
-                    if (!passetsdb->WriteAssetAddressQuantity(ownerAsset.assetName, ownerAsset.address,
-                                                              mapAssetsAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Owner Address Balance to database";
-                    }
-
-                    if (!passetsdb->WriteAddressAssetQuantity(ownerAsset.address, ownerAsset.assetName,
-                                                              mapAssetsAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Address Balance to database";
-                    }
-
-                    if (dirty) {
-                        return error("%s : %s", __func__, message);
-                    }
+            for (const auto& ownerAsset : setNewOwnerAssetsToAdd) {
+                auto it = mapAssetsAddressAmount.find(std::make_pair(ownerAsset.assetName, ownerAsset.address));
+                if (it != mapAssetsAddressAmount.end() && it->second > 0) {
+                    passetsdb->WriteAssetAddressQuantity(batch, ownerAsset.assetName, ownerAsset.address, it->second);
+                    passetsdb->WriteAddressAssetQuantity(batch, ownerAsset.address, ownerAsset.assetName, it->second);
                 }
             }
 
             // Undo the transfering by updating the balances in the database
-
-            for (auto undoTransfer : setNewTransferAssetsToRemove) {
-                auto pair = std::make_pair(undoTransfer.transfer.strName, undoTransfer.address);
-                if (mapAssetsAddressAmount.count(pair)) {
-                    if (mapAssetsAddressAmount.at(pair) == 0) {
-                        if (!passetsdb->EraseAssetAddressQuantity(undoTransfer.transfer.strName,
-                                                                  undoTransfer.address)) {
-                            dirty = true;
-                            message = "_Failed Erasing Address Quantity from database";
-                        }
-
-                        if (!passetsdb->EraseAddressAssetQuantity(undoTransfer.address,
-                                                                  undoTransfer.transfer.strName)) {
-                            dirty = true;
-                            message = "_Failed Erasing UndoTransfer Address Balance from AddressAsset database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+            for (const auto& undoTransfer : setNewTransferAssetsToRemove) {
+                auto it = mapAssetsAddressAmount.find(std::make_pair(undoTransfer.transfer.strName, undoTransfer.address));
+                if (it != mapAssetsAddressAmount.end()) {
+                    if (it->second == 0) {
+                        passetsdb->EraseAssetAddressQuantity(batch, undoTransfer.transfer.strName, undoTransfer.address);
+                        passetsdb->EraseAddressAssetQuantity(batch, undoTransfer.address, undoTransfer.transfer.strName);
                     } else {
-                        if (!passetsdb->WriteAssetAddressQuantity(undoTransfer.transfer.strName,
-                                                                  undoTransfer.address,
-                                                                  mapAssetsAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing updated Address Quantity to database when undoing transfers";
-                        }
-
-                        if (!passetsdb->WriteAddressAssetQuantity(undoTransfer.address,
-                                                                  undoTransfer.transfer.strName,
-                                                                  mapAssetsAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing Address Balance to database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+                        passetsdb->WriteAssetAddressQuantity(batch, undoTransfer.transfer.strName, undoTransfer.address, it->second);
+                        passetsdb->WriteAddressAssetQuantity(batch, undoTransfer.address, undoTransfer.transfer.strName, it->second);
                     }
                 }
             }
 
-
             // Save the new transfers by updating the quantity in the database
-            for (auto newTransfer : setNewTransferAssetsToAdd) {
-                auto pair = std::make_pair(newTransfer.transfer.strName, newTransfer.address);
+            for (const auto& newTransfer : setNewTransferAssetsToAdd) {
                 // During init and reindex it disconnects and verifies blocks, can create a state where vNewTransfer will contain transfers that have already been spent. So if they aren't in the map, we can skip them.
-                if (mapAssetsAddressAmount.count(pair)) {
-                    if (!passetsdb->WriteAssetAddressQuantity(newTransfer.transfer.strName, newTransfer.address,
-                                                              mapAssetsAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing new address quantity to database";
-                    }
-
-                    if (!passetsdb->WriteAddressAssetQuantity(newTransfer.address, newTransfer.transfer.strName,
-                                                              mapAssetsAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Address Balance to database";
-                    }
-
-                    if (dirty) {
-                        return error("%s : %s", __func__, message);
-                    }
+                auto it = mapAssetsAddressAmount.find(std::make_pair(newTransfer.transfer.strName, newTransfer.address));
+                if (it != mapAssetsAddressAmount.end()) {
+                    passetsdb->WriteAssetAddressQuantity(batch, newTransfer.transfer.strName, newTransfer.address, it->second);
+                    passetsdb->WriteAddressAssetQuantity(batch, newTransfer.address, newTransfer.transfer.strName, it->second);
                 }
             }
         }
 
-        for (auto newReissue : setNewReissueToAdd) {
-            auto reissue_name = newReissue.reissue.strName;
-            auto pair = make_pair(reissue_name, newReissue.address);
-            if (mapReissuedAssetData.count(reissue_name)) {
-                if(!passetsdb->WriteAssetData(mapReissuedAssetData.at(reissue_name), newReissue.blockHeight, newReissue.blockHash)) {
-                    dirty = true;
-                    message = "_Failed Writing reissue asset data to database";
-                }
-
-                if (dirty) {
-                    return error("%s : %s", __func__, message);
-                }
-
+        for (const auto& newReissue : setNewReissueToAdd) {
+            const auto& reissue_name = newReissue.reissue.strName;
+            auto reissued = mapReissuedAssetData.find(reissue_name);
+            if (reissued != mapReissuedAssetData.end()) {
+                passetsdb->WriteAssetData(batch, reissued->second, newReissue.blockHeight, newReissue.blockHash);
                 passetsCache->Erase(reissue_name);
 
                 if (fAssetIndex) {
-
-                    if (mapAssetsAddressAmount.count(pair) && mapAssetsAddressAmount.at(pair) > 0) {
-                        if (!passetsdb->WriteAssetAddressQuantity(pair.first, pair.second,
-                                                                  mapAssetsAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing reissue asset quantity to the address quantity database";
-                        }
-
-                        if (!passetsdb->WriteAddressAssetQuantity(pair.second, pair.first,
-                                                                  mapAssetsAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing Address Balance to database";
-                        }
-
-                        if (dirty) {
-                            return error("%s, %s", __func__, message);
-                        }
+                    auto it = mapAssetsAddressAmount.find(std::make_pair(reissue_name, newReissue.address));
+                    if (it != mapAssetsAddressAmount.end() && it->second > 0) {
+                        passetsdb->WriteAssetAddressQuantity(batch, reissue_name, newReissue.address, it->second);
+                        passetsdb->WriteAddressAssetQuantity(batch, newReissue.address, reissue_name, it->second);
                     }
                 }
             }
         }
 
-        for (auto undoReissue : setNewReissueToRemove) {
+        for (const auto& undoReissue : setNewReissueToRemove) {
             // In the case the the issue and reissue are both being removed
             // we can skip this call because the removal of the issue should remove all data pertaining the to asset
             // Fixes the issue where the reissue data will write over the removed asset meta data that was removed above
@@ -2632,312 +2432,162 @@ bool CAssetsCache::DumpCacheToDatabase()
                 continue;
             }
 
-            auto reissue_name = undoReissue.reissue.strName;
-            if (mapReissuedAssetData.count(reissue_name)) {
-                if(!passetsdb->WriteAssetData(mapReissuedAssetData.at(reissue_name), undoReissue.blockHeight, undoReissue.blockHash)) {
-                    dirty = true;
-                    message = "_Failed Writing undo reissue asset data to database";
-                }
+            const auto& reissue_name = undoReissue.reissue.strName;
+            auto reissued = mapReissuedAssetData.find(reissue_name);
+            if (reissued != mapReissuedAssetData.end()) {
+                passetsdb->WriteAssetData(batch, reissued->second, undoReissue.blockHeight, undoReissue.blockHash);
 
                 if (fAssetIndex) {
-                    auto pair = make_pair(undoReissue.reissue.strName, undoReissue.address);
-                    if (mapAssetsAddressAmount.count(pair)) {
-                        if (mapAssetsAddressAmount.at(pair) == 0) {
-                            if (!passetsdb->EraseAssetAddressQuantity(reissue_name, undoReissue.address)) {
-                                dirty = true;
-                                message = "_Failed Erasing Address Balance from database";
-                            }
-
-                            if (!passetsdb->EraseAddressAssetQuantity(undoReissue.address, reissue_name)) {
-                                dirty = true;
-                                message = "_Failed Erasing UndoReissue Balance from AddressAsset database";
-                            }
+                    auto it = mapAssetsAddressAmount.find(std::make_pair(reissue_name, undoReissue.address));
+                    if (it != mapAssetsAddressAmount.end()) {
+                        if (it->second == 0) {
+                            passetsdb->EraseAssetAddressQuantity(batch, reissue_name, undoReissue.address);
+                            passetsdb->EraseAddressAssetQuantity(batch, undoReissue.address, reissue_name);
                         } else {
-                            if (!passetsdb->WriteAssetAddressQuantity(reissue_name, undoReissue.address,
-                                                                      mapAssetsAddressAmount.at(pair))) {
-                                dirty = true;
-                                message = "_Failed Writing the undo of reissue of asset from database";
-                            }
-
-                            if (!passetsdb->WriteAddressAssetQuantity(undoReissue.address, reissue_name,
-                                                                      mapAssetsAddressAmount.at(pair))) {
-                                dirty = true;
-                                message = "_Failed Writing Address Balance to database";
-                            }
+                            passetsdb->WriteAssetAddressQuantity(batch, reissue_name, undoReissue.address, it->second);
+                            passetsdb->WriteAddressAssetQuantity(batch, undoReissue.address, reissue_name, it->second);
                         }
                     }
                 }
 
-                if (dirty) {
-                    return error("%s : %s", __func__, message);
-                }
-
                 passetsCache->Erase(reissue_name);
             }
         }
 
         // Add new verifier strings for restricted assets
-        for (auto newVerifier : setNewRestrictedVerifierToAdd) {
-            auto assetName = newVerifier.assetName;
-            if (!prestricteddb->WriteVerifier(assetName, newVerifier.verifier)) {
-                dirty = true;
-                message = "_Failed Writing restricted verifier to database";
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
-
-            passetsVerifierCache->Erase(assetName);
+        for (const auto& newVerifier : setNewRestrictedVerifierToAdd) {
+            restrictedBatch.WriteVerifier(newVerifier.assetName, newVerifier.verifier);
+            passetsVerifierCache->Erase(newVerifier.assetName);
         }
 
         // Undo verifier string for restricted assets
-        for (auto undoVerifiers : setNewRestrictedVerifierToRemove) {
-            auto assetName = undoVerifiers.assetName;
-
+        for (const auto& undoVerifiers : setNewRestrictedVerifierToRemove) {
             // If we are undoing a reissue, we need to save back the old verifier string to database
             if (undoVerifiers.fUndoingRessiue) {
-                if (!prestricteddb->WriteVerifier(assetName, undoVerifiers.verifier)) {
-                    dirty = true;
-                    message = "_Failed Writing undo restricted verifer to database";
-                }
+                restrictedBatch.WriteVerifier(undoVerifiers.assetName, undoVerifiers.verifier);
             } else {
-                if (!prestricteddb->EraseVerifier(assetName)) {
-                    dirty = true;
-                    message = "_Failed Writing undo restricted verifer to database";
-                }
+                restrictedBatch.EraseVerifier(undoVerifiers.assetName);
             }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
-
-            passetsVerifierCache->Erase(assetName);
+            passetsVerifierCache->Erase(undoVerifiers.assetName);
         }
 
         // Add the new qualifier commands to the database
-        for (auto newQualifierAddress : setNewQualifierAddressToAdd) {
+        for (const auto& newQualifierAddress : setNewQualifierAddressToAdd) {
             if (newQualifierAddress.type == QualifierType::REMOVE_QUALIFIER) {
                 passetsQualifierCache->Erase(newQualifierAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseAddressQualifier(newQualifierAddress.address, newQualifierAddress.assetName)) {
-                    dirty = true;
-                    message = "_Failed Erasing address qualifier from database";
-                }
-                if (fAssetIndex && !dirty) {
-                    if (!prestricteddb->EraseQualifierAddress(newQualifierAddress.address,
-                                                              newQualifierAddress.assetName)) {
-                        dirty = true;
-                        message = "_Failed Erasing qualifier address from database";
-                    }
+                restrictedBatch.EraseAddressQualifier(newQualifierAddress.address, newQualifierAddress.assetName);
+                if (fAssetIndex) {
+                    restrictedBatch.EraseQualifierAddress(newQualifierAddress.address, newQualifierAddress.assetName);
                 }
             } else if (newQualifierAddress.type == QualifierType::ADD_QUALIFIER) {
                 passetsQualifierCache->Put(newQualifierAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteAddressQualifier(newQualifierAddress.address, newQualifierAddress.assetName))
-                {
-                    dirty = true;
-                    message = "_Failed Writing address qualifier to database";
-                }
-                if (fAssetIndex & !dirty) {
-                    if (!prestricteddb->WriteQualifierAddress(newQualifierAddress.address, newQualifierAddress.assetName))
-                    {
-                        dirty = true;
-                        message = "_Failed Writing qualifier address to database";
-                    }
+                restrictedBatch.WriteAddressQualifier(newQualifierAddress.address, newQualifierAddress.assetName);
+                if (fAssetIndex) {
+                    restrictedBatch.WriteQualifierAddress(newQualifierAddress.address, newQualifierAddress.assetName);
                 }
             }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
         }
 
         // Undo the qualifier commands
-        for (auto undoQualifierAddress : setNewQualifierAddressToRemove) {
+        for (const auto& undoQualifierAddress : setNewQualifierAddressToRemove) {
             if (undoQualifierAddress.type == QualifierType::REMOVE_QUALIFIER) { // If we are undoing a removal, we write the data to database
                 passetsQualifierCache->Put(undoQualifierAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.assetName)) {
-                    dirty = true;
-                    message = "_Failed undoing a removal of a address qualifier  from database";
-                }
-                if (fAssetIndex & !dirty) {
-                    if (!prestricteddb->WriteQualifierAddress(undoQualifierAddress.address, undoQualifierAddress.assetName))
-                    {
-                        dirty = true;
-                        message = "_Failed undoing a removal of a qualifier address from database";
-                    }
+                restrictedBatch.WriteAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.assetName);
+                if (fAssetIndex) {
+                    restrictedBatch.WriteQualifierAddress(undoQualifierAddress.address, undoQualifierAddress.assetName);
                 }
             } else if (undoQualifierAddress.type == QualifierType::ADD_QUALIFIER) { // If we are undoing an addition, we remove the data from the database
                 passetsQualifierCache->Erase(undoQualifierAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.assetName))
-                {
-                    dirty = true;
-                    message = "_Failed undoing a addition of a address qualifier to database";
-                }
-                if (fAssetIndex && !dirty) {
-                    if (!prestricteddb->EraseQualifierAddress(undoQualifierAddress.address,
-                                                              undoQualifierAddress.assetName)) {
-                        dirty = true;
-                        message = "_Failed undoing a addition of a qualifier address from database";
-                    }
+                restrictedBatch.EraseAddressQualifier(undoQualifierAddress.address, undoQualifierAddress.assetName);
+                if (fAssetIndex) {
+                    restrictedBatch.EraseQualifierAddress(undoQualifierAddress.address, undoQualifierAddress.assetName);
                 }
             }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
-            }
         }
 
         // Add new restricted address commands
-        for (auto newRestrictedAddress : setNewRestrictedAddressToAdd) {
+        for (const auto& newRestrictedAddress : setNewRestrictedAddressToAdd) {
             if (newRestrictedAddress.type == RestrictedType::UNFREEZE_ADDRESS) {
                 passetsRestrictionCache->Erase(newRestrictedAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.assetName)) {
-                    dirty = true;
-                    message = "_Failed Erasing restricted address from database";
-                }
+                restrictedBatch.EraseRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.assetName);
             } else if (newRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) {
                 passetsRestrictionCache->Put(newRestrictedAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.assetName))
-                {
-                    dirty = true;
-                    message = "_Failed Writing restricted address to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                restrictedBatch.WriteRestrictedAddress(newRestrictedAddress.address, newRestrictedAddress.assetName);
             }
         }
 
         // Undo the qualifier addresses from database
-        for (auto undoRestrictedAddress : setNewRestrictedAddressToRemove) {
+        for (const auto& undoRestrictedAddress : setNewRestrictedAddressToRemove) {
             if (undoRestrictedAddress.type == RestrictedType::UNFREEZE_ADDRESS) { // If we are undoing an unfreeze, we need to freeze the address
                 passetsRestrictionCache->Put(undoRestrictedAddress.GetHash().GetHex(), 1);
-                if (!prestricteddb->WriteRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.assetName)) {
-                    dirty = true;
-                    message = "_Failed undoing a removal of a restricted address from database";
-                }
+                restrictedBatch.WriteRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.assetName);
             } else if (undoRestrictedAddress.type == RestrictedType::FREEZE_ADDRESS) { // If we are undoing a freeze, we need to unfreeze the address
                 passetsRestrictionCache->Erase(undoRestrictedAddress.GetHash().GetHex());
-                if (!prestricteddb->EraseRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.assetName))
-                {
-                    dirty = true;
-                    message = "_Failed undoing a addition of a restricted address to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                restrictedBatch.EraseRestrictedAddress(undoRestrictedAddress.address, undoRestrictedAddress.assetName);
             }
         }
 
         // Add new global restriction commands
-        for (auto newGlobalRestriction : setNewRestrictedGlobalToAdd) {
+        for (const auto& newGlobalRestriction : setNewRestrictedGlobalToAdd) {
             if (newGlobalRestriction.type == RestrictedType::GLOBAL_UNFREEZE) {
                 passetsGlobalRestrictionCache->Erase(newGlobalRestriction.assetName);
-                if (!prestricteddb->EraseGlobalRestriction(newGlobalRestriction.assetName)) {
-                    dirty = true;
-                    message = "_Failed Erasing global restriction from database";
-                }
+                restrictedBatch.EraseGlobalRestriction(newGlobalRestriction.assetName);
             } else if (newGlobalRestriction.type == RestrictedType::GLOBAL_FREEZE) {
                 passetsGlobalRestrictionCache->Put(newGlobalRestriction.assetName, 1);
-                if (!prestricteddb->WriteGlobalRestriction(newGlobalRestriction.assetName))
-                {
-                    dirty = true;
-                    message = "_Failed Writing global restriction to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                restrictedBatch.WriteGlobalRestriction(newGlobalRestriction.assetName);
             }
         }
 
         // Undo the global restriction commands
-        for (auto undoGlobalRestriction : setNewRestrictedGlobalToRemove) {
+        for (const auto& undoGlobalRestriction : setNewRestrictedGlobalToRemove) {
             if (undoGlobalRestriction.type == RestrictedType::GLOBAL_UNFREEZE) { // If we are undoing an global unfreeze, we need to write a global freeze
                 passetsGlobalRestrictionCache->Put(undoGlobalRestriction.assetName, 1);
-                if (!prestricteddb->WriteGlobalRestriction(undoGlobalRestriction.assetName)) {
-                    dirty = true;
-                    message = "_Failed undoing a global unfreeze of a restricted asset from database";
-                }
+                restrictedBatch.WriteGlobalRestriction(undoGlobalRestriction.assetName);
             } else if (undoGlobalRestriction.type == RestrictedType::GLOBAL_FREEZE) { // If we are undoing a global freeze, erase the freeze from the database
                 passetsGlobalRestrictionCache->Erase(undoGlobalRestriction.assetName);
-                if (!prestricteddb->EraseGlobalRestriction(undoGlobalRestriction.assetName))
-                {
-                    dirty = true;
-                    message = "_Failed undoing a global freeze of a restricted asset to database";
-                }
-            }
-
-            if (dirty) {
-                return error("%s : %s", __func__, message);
+                restrictedBatch.EraseGlobalRestriction(undoGlobalRestriction.assetName);
             }
         }
 
         if (fAssetIndex) {
             // Undo the asset spends by updating there balance in the database
-            for (auto undoSpend : vUndoAssetAmount) {
-                auto pair = std::make_pair(undoSpend.assetName, undoSpend.address);
-                if (mapAssetsAddressAmount.count(pair)) {
-                    if (!passetsdb->WriteAssetAddressQuantity(undoSpend.assetName, undoSpend.address,
-                                                              mapAssetsAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing updated Address Quantity to database when undoing spends";
-                    }
-
-                    if (!passetsdb->WriteAddressAssetQuantity(undoSpend.address, undoSpend.assetName,
-                                                              mapAssetsAddressAmount.at(pair))) {
-                        dirty = true;
-                        message = "_Failed Writing Address Balance to database";
-                    }
-
-                    if (dirty) {
-                        return error("%s : %s", __func__, message);
-                    }
+            for (const auto& undoSpend : vUndoAssetAmount) {
+                auto it = mapAssetsAddressAmount.find(std::make_pair(undoSpend.assetName, undoSpend.address));
+                if (it != mapAssetsAddressAmount.end()) {
+                    passetsdb->WriteAssetAddressQuantity(batch, undoSpend.assetName, undoSpend.address, it->second);
+                    passetsdb->WriteAddressAssetQuantity(batch, undoSpend.address, undoSpend.assetName, it->second);
                 }
             }
 
-
             // Save the assets that have been spent by erasing the quantity in the database
-            for (auto spentAsset : vSpentAssets) {
-                auto pair = make_pair(spentAsset.assetName, spentAsset.address);
-                if (mapAssetsAddressAmount.count(pair)) {
-                    if (mapAssetsAddressAmount.at(pair) == 0) {
-                        if (!passetsdb->EraseAssetAddressQuantity(spentAsset.assetName, spentAsset.address)) {
-                            dirty = true;
-                            message = "_Failed Erasing a Spent Asset, from database";
-                        }
-
-                        if (!passetsdb->EraseAddressAssetQuantity(spentAsset.address, spentAsset.assetName)) {
-                            dirty = true;
-                            message = "_Failed Erasing a Spent Asset from AddressAsset database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+            for (const auto& spentAsset : vSpentAssets) {
+                auto it = mapAssetsAddressAmount.find(std::make_pair(spentAsset.assetName, spentAsset.address));
+                if (it != mapAssetsAddressAmount.end()) {
+                    if (it->second == 0) {
+                        passetsdb->EraseAssetAddressQuantity(batch, spentAsset.assetName, spentAsset.address);
+                        passetsdb->EraseAddressAssetQuantity(batch, spentAsset.address, spentAsset.assetName);
                     } else {
-                        if (!passetsdb->WriteAssetAddressQuantity(spentAsset.assetName, spentAsset.address,
-                                                                  mapAssetsAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Erasing a Spent Asset, from database";
-                        }
-
-                        if (!passetsdb->WriteAddressAssetQuantity(spentAsset.address, spentAsset.assetName,
-                                                                  mapAssetsAddressAmount.at(pair))) {
-                            dirty = true;
-                            message = "_Failed Writing Address Balance to database";
-                        }
-
-                        if (dirty) {
-                            return error("%s : %s", __func__, message);
-                        }
+                        passetsdb->WriteAssetAddressQuantity(batch, spentAsset.assetName, spentAsset.address, it->second);
+                        passetsdb->WriteAddressAssetQuantity(batch, spentAsset.address, spentAsset.assetName, it->second);
                     }
                 }
             }
         }
 
+        // The restricted changes are committed with the asset batch first, and
+        // only dropped from it once the restricted database has them.
+        if (!passetsdb->WriteFlushBatch(batch, restrictedBatch, bestBlock)) {
+            return error("%s : %s", __func__, "_Failed Writing asset batch to database");
+        }
+        if (!restrictedBatch.IsEmpty()) {
+            if (!prestricteddb->WriteFlushBatch(restrictedBatch)) {
+                return error("%s : %s", __func__, "_Failed Writing restricted batch to database");
+            }
+            if (!passetsdb->ErasePendingRestrictedBatch()) {
+                return error("%s : %s", __func__, "_Failed Erasing pending restricted batch from database");
+            }
+        }
+
         ClearDirtyCache();
 
         return true;
@@ -2948,6 +2598,43 @@ bool CAssetsCache::DumpCacheToDatabase()
 
 // This function will put all current cache data into the global passets cache.
 //! Do not call this function on the passets pointer
+/** Move every entry of from into to, dropping its match from opposite. An
+ * equal entry already in to is kept, unless overwrite is set. */
+template <typename Set>
+static void SpliceDirtySet(Set& from, Set& to, Set& opposite, bool overwrite)
+{
+    for (const auto& item : from) {
+        opposite.erase(item);
+        if (overwrite) to.erase(item);
+    }
+    // merge() relinks the nodes instead of copying them
+    to.merge(from);
+    from.clear();
+}
+
+/** Move every entry of from into to, replacing the value of existing keys. */
+template <typename Map>
+static void SpliceDirtyMap(Map& from, Map& to)
+{
+    to.merge(from);
+    // Whatever merge() left behind has a key that is already in to
+    for (auto& [key, value] : from) {
+        to.find(key)->second = std::move(value);
+    }
+    from.clear();
+}
+
+template <typename T>
+static void AppendDirtyVector(std::vector<T>& from, std::vector<T>& to)
+{
+    if (to.empty()) {
+        to.swap(from);
+    } else {
+        to.insert(to.end(), std::make_move_iterator(from.begin()), std::make_move_iterator(from.end()));
+    }
+    from.clear();
+}
+
 bool CAssetsCache::Flush()
 {
 
@@ -2955,176 +2642,48 @@ bool CAssetsCache::Flush()
         return error("%s: Couldn't find passets pointer while trying to flush assets cache", __func__);
 
     try {
-        for (auto &item : setNewAssetsToAdd) {
-            if (passets->setNewAssetsToRemove.count(item))
-                passets->setNewAssetsToRemove.erase(item);
-            passets->setNewAssetsToAdd.insert(item);
-        }
-
-        for (auto &item : setNewAssetsToRemove) {
-            if (passets->setNewAssetsToAdd.count(item))
-                passets->setNewAssetsToAdd.erase(item);
-            passets->setNewAssetsToRemove.insert(item);
-        }
-
-        for (auto &item : mapAssetsAddressAmount)
-            passets->mapAssetsAddressAmount[item.first] = item.second;
-
-        for (auto &item : mapReissuedAssetData)
-            passets->mapReissuedAssetData[item.first] = item.second;
-
-        for (auto &item : setNewOwnerAssetsToAdd) {
-            if (passets->setNewOwnerAssetsToRemove.count(item))
-                passets->setNewOwnerAssetsToRemove.erase(item);
-            passets->setNewOwnerAssetsToAdd.insert(item);
-        }
-
-        for (auto &item : setNewOwnerAssetsToRemove) {
-            if (passets->setNewOwnerAssetsToAdd.count(item))
-                passets->setNewOwnerAssetsToAdd.erase(item);
-            passets->setNewOwnerAssetsToRemove.insert(item);
-        }
-
-        for (auto &item : setNewReissueToAdd) {
-            if (passets->setNewReissueToRemove.count(item))
-                passets->setNewReissueToRemove.erase(item);
-            passets->setNewReissueToAdd.insert(item);
-        }
-
-        for (auto &item : setNewReissueToRemove) {
-            if (passets->setNewReissueToAdd.count(item))
-                passets->setNewReissueToAdd.erase(item);
-            passets->setNewReissueToRemove.insert(item);
-        }
-
-        for (auto &item : setNewTransferAssetsToAdd) {
-            if (passets->setNewTransferAssetsToRemove.count(item))
-                passets->setNewTransferAssetsToRemove.erase(item);
-            passets->setNewTransferAssetsToAdd.insert(item);
-        }
-
-        for (auto &item : setNewTransferAssetsToRemove) {
-            if (passets->setNewTransferAssetsToAdd.count(item))
-                passets->setNewTransferAssetsToAdd.erase(item);
-            passets->setNewTransferAssetsToRemove.insert(item);
-        }
-
-        for (auto &item : vSpentAssets) {
-            passets->vSpentAssets.emplace_back(item);
-        }
-
-        for (auto &item : vUndoAssetAmount) {
-            passets->vUndoAssetAmount.emplace_back(item);
-        }
-
-        for(auto &item : setNewQualifierAddressToAdd) {
-            if (passets->setNewQualifierAddressToRemove.count(item)) {
-                passets->setNewQualifierAddressToRemove.erase(item);
-            }
-
-            if (passets->setNewQualifierAddressToAdd.count(item)) {
-                passets->setNewQualifierAddressToAdd.erase(item);
-            }
-
-            passets->setNewQualifierAddressToAdd.insert(item);
-        }
-
-        for(auto &item : setNewQualifierAddressToRemove) {
-            if (passets->setNewQualifierAddressToAdd.count(item)) {
-                passets->setNewQualifierAddressToAdd.erase(item);
-            }
-
-            if (passets->setNewQualifierAddressToRemove.count(item)) {
-                passets->setNewQualifierAddressToRemove.erase(item);
-            }
-
-            passets->setNewQualifierAddressToRemove.insert(item);
-        }
-
-        for(auto &item : setNewRestrictedAddressToAdd) {
-            if (passets->setNewRestrictedAddressToRemove.count(item)) {
-                passets->setNewRestrictedAddressToRemove.erase(item);
-            }
-
-            if (passets->setNewRestrictedAddressToAdd.count(item)) {
-                passets->setNewRestrictedAddressToAdd.erase(item);
-            }
-
-            passets->setNewRestrictedAddressToAdd.insert(item);
-        }
-
-        for(auto &item : setNewRestrictedAddressToRemove) {
-            if (passets->setNewRestrictedAddressToAdd.count(item)) {
-                passets->setNewRestrictedAddressToAdd.erase(item);
-            }
-
-            if (passets->setNewRestrictedAddressToRemove.count(item)) {
-                passets->setNewRestrictedAddressToRemove.erase(item);
-            }
+        SpliceDirtySet(setNewAssetsToAdd, passets->setNewAssetsToAdd, passets->setNewAssetsToRemove, false);
+        SpliceDirtySet(setNewAssetsToRemove, passets->setNewAssetsToRemove, passets->setNewAssetsToAdd, false);
 
-            passets->setNewRestrictedAddressToRemove.insert(item);
-        }
+        passets->mapAssetsAddressAmount.Merge(mapAssetsAddressAmount);
+        SpliceDirtyMap(mapReissuedAssetData, passets->mapReissuedAssetData);
 
-        for(auto &item : setNewRestrictedGlobalToAdd) {
-            if (passets->setNewRestrictedGlobalToRemove.count(item)) {
-                passets->setNewRestrictedGlobalToRemove.erase(item);
-            }
+        SpliceDirtySet(setNewOwnerAssetsToAdd, passets->setNewOwnerAssetsToAdd, passets->setNewOwnerAssetsToRemove, false);
+        SpliceDirtySet(setNewOwnerAssetsToRemove, passets->setNewOwnerAssetsToRemove, passets->setNewOwnerAssetsToAdd, false);
 
-            if (passets->setNewRestrictedGlobalToAdd.count(item)) {
-                passets->setNewRestrictedGlobalToAdd.erase(item);
-            }
+        SpliceDirtySet(setNewReissueToAdd, passets->setNewReissueToAdd, passets->setNewReissueToRemove, false);
+        SpliceDirtySet(setNewReissueToRemove, passets->setNewReissueToRemove, passets->setNewReissueToAdd, false);
 
-            passets->setNewRestrictedGlobalToAdd.insert(item);
-        }
+        SpliceDirtySet(setNewTransferAssetsToAdd, passets->setNewTransferAssetsToAdd, passets->setNewTransferAssetsToRemove, false);
+        SpliceDirtySet(setNewTransferAssetsToRemove, passets->setNewTransferAssetsToRemove, passets->setNewTransferAssetsToAdd, false);
 
-        for(auto &item : setNewRestrictedGlobalToRemove) {
-            if (passets->setNewRestrictedGlobalToAdd.count(item)) {
-                passets->setNewRestrictedGlobalToAdd.erase(item);
-            }
+        AppendDirtyVector(vSpentAssets, passets->vSpentAssets);
+        AppendDirtyVector(vUndoAssetAmount, passets->vUndoAssetAmount);
 
-            if (passets->setNewRestrictedGlobalToRemove.count(item)) {
-                passets->setNewRestrictedGlobalToRemove.erase(item);
-            }
+        // Entries of these sets compare by key only, so the newer flag or
+        // verifier string has to replace an equal entry already in passets
+        SpliceDirtySet(setNewQualifierAddressToAdd, passets->setNewQualifierAddressToAdd, passets->setNewQualifierAddressToRemove, true);
+        SpliceDirtySet(setNewQualifierAddressToRemove, passets->setNewQualifierAddressToRemove, passets->setNewQualifierAddressToAdd, true);
 
-            passets->setNewRestrictedGlobalToRemove.insert(item);
-        }
+        SpliceDirtySet(setNewRestrictedAddressToAdd, passets->setNewRestrictedAddressToAdd, passets->setNewRestrictedAddressToRemove, true);
+        SpliceDirtySet(setNewRestrictedAddressToRemove, passets->setNewRestrictedAddressToRemove, passets->setNewRestrictedAddressToAdd, true);
 
-        for (auto &item : setNewRestrictedVerifierToAdd) {
-            if (passets->setNewRestrictedVerifierToRemove.count(item)) {
-                passets->setNewRestrictedVerifierToRemove.erase(item);
-            }
+        SpliceDirtySet(setNewRestrictedGlobalToAdd, passets->setNewRestrictedGlobalToAdd, passets->setNewRestrictedGlobalToRemove, true);
+        SpliceDirtySet(setNewRestrictedGlobalToRemove, passets->setNewRestrictedGlobalToRemove, passets->setNewRestrictedGlobalToAdd, true);
 
-            if (passets->setNewRestrictedVerifierToAdd.count(item)) {
-                passets->setNewRestrictedVerifierToAdd.erase(item);
-            }
-
-            passets->setNewRestrictedVerifierToAdd.insert(item);
-        }
-
-        for (auto &item : setNewRestrictedVerifierToRemove) {
-            if (passets->setNewRestrictedVerifierToAdd.count(item)) {
-                passets->setNewRestrictedVerifierToAdd.erase(item);
-            }
-
-            if (passets->setNewRestrictedVerifierToRemove.count(item)) {
-                passets->setNewRestrictedVerifierToRemove.erase(item);
-            }
-
-            passets->setNewRestrictedVerifierToRemove.insert(item);
-        }
+        SpliceDirtySet(setNewRestrictedVerifierToAdd, passets->setNewRestrictedVerifierToAdd, passets->setNewRestrictedVerifierToRemove, true);
+        SpliceDirtySet(setNewRestrictedVerifierToRemove, passets->setNewRestrictedVerifierToRemove, passets->setNewRestrictedVerifierToAdd, true);
 
         for (auto &item : mapRootQualifierAddressesAdd) {
-            for (auto asset : item.second) {
-                passets->mapRootQualifierAddressesAdd[item.first].insert(asset);
-            }
+            passets->mapRootQualifierAddressesAdd[item.first].merge(item.second);
         }
 
         for (auto &item : mapRootQualifierAddressesRemove) {
-            for (auto asset : item.second) {
-                passets->mapRootQualifierAddressesAdd[item.first].insert(asset);
-            }
+            passets->mapRootQualifierAddressesAdd[item.first].merge(item.second);
         }
 
+        ClearDirtyCache();
+
         return true;
 
     } catch (const std::runtime_error& e) {
@@ -3136,7 +2695,7 @@ bool CAssetsCache::Flush()
 size_t CAssetsCache::DynamicMemoryUsage() const
 {
     // TODO make sure this is accurate
-    return memusage::DynamicUsage(mapAssetsAddressAmount) + memusage::DynamicUsage(mapReissuedAssetData);
+    return mapAssetsAddressAmount.DynamicMemoryUsage() + memusage::DynamicUsage(mapReissuedAssetData);
 }
 
 //! Get an estimated size of the cache in bytes that will be needed inorder to save to database
@@ -3589,12 +3148,10 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsCache) {
-        if (passetsCache->Exists(name)) {
-            CDatabasedAssetData data;
-            data = passetsCache->Get(name);
-            asset = data.asset;
-            nHeight = data.nHeight;
-            blockHash = data.blockHash;
+        if (const auto data = passetsCache->Get(name)) {
+            asset = data->asset;
+            nHeight = data->nHeight;
+            blockHash = data->blockHash;
             return true;
         }
     }
@@ -3633,7 +3190,90 @@ bool GetAssetInfoFromScript(const CScript& scriptPubKey, std::string& strName, C
 
 bool GetAssetInfoFromCoin(const Coin& coin, std::string& strName, CAmount& nAmount)
 {
-    return GetAssetInfoFromScript(coin.out.scriptPubKey, strName, nAmount);
+    const CAssetOutputEntry* data = GetAssetOutput(coin);
+    if (!data)
+        return false;
+
+    strName = data->assetName;
+    nAmount = data->nAmount;
+
+    return true;
+}
+
+//! Assets inserted per cs_main hold while warming the cache
+static const size_t ASSET_WARMUP_BATCH = 256;
+//! Assets considered when there is no hot set to warm the cache with
+static const size_t ASSET_WARMUP_MAX_NAMES = 50000;
+
+void WarmAssetCache(const std::atomic<bool>& interrupt)
+{
+    if (!passetsdb || !passetsCache)
+        return;
+
+    std::vector<std::string> names;
+    bool fHotSet = passetsdb->ReadHotAssets(names) && !names.empty();
+    if (!fHotSet && !passetsdb->ReadAssetNames(names, ASSET_WARMUP_MAX_NAMES)) {
+        LogPrintf("%s: Failed to read asset names\n", __func__);
+        return;
+    }
+
+    const auto start = SteadyClock::now();
+    size_t loaded = 0;
+    bool fFull = false;
+    std::vector<std::pair<std::string, CDatabasedAssetData>> batch;
+    for (size_t i = 0; i < names.size() && !fFull && !interrupt;) {
+        // Read the batch without cs_main. If asset data was written in the
+        // meantime, what was read may be older than the database, so the
+        // batch is read again.
+        const uint64_t writes = passetsdb->AssetDataWrites();
+        batch.clear();
+        for (size_t j = i; j < std::min(names.size(), i + ASSET_WARMUP_BATCH); j++) {
+            CDatabasedAssetData data;
+            if (passetsdb->ReadAssetData(names[j], data.asset, data.nHeight, data.blockHash))
+                batch.emplace_back(names[j], std::move(data));
+        }
+
+        LOCK(cs_main);
+        if (passetsdb->AssetDataWrites() != writes)
+            continue;
+        for (const auto& [name, data] : batch) {
+            if (passetsCache->DynamicMemoryUsage() >= passetsCache->MaxMemoryUsage() / 2) {
+                fFull = true;
+                break;
+            }
+            if (passetsCache->Exists(name))
+                continue;
+
+            passetsCache->Put(name, data);
+            loaded++;
+        }
+        i += ASSET_WARMUP_BATCH;
+    }
+
+    LogPrintf("Warmed asset cache with %u %s assets in %.2fs\n", loaded, fHotSet ? "recently used" : "stored",
+              Ticks<SecondsDouble>(SteadyClock::now() - start));
+}
+
+const CAssetOutputEntry* GetAssetOutput(const Coin& coin)
+{
+    if (!coin.m_asset_output) {
+        if (!coin.out.scriptPubKey.IsAssetScript())
+            return nullptr;
+        auto data = std::make_shared<CAssetOutputEntry>();
+        if (!GetAssetData(coin.out.scriptPubKey, *data))
+            return nullptr;
+        // Only names of confirmed coins are interned, so the table grows with
+        // the assets on the chain. Outputs of mempool transactions may name
+        // assets that are never confirmed; those keep NULL_ASSET_ID until
+        // the name is interned.
+        if (coin.nHeight == MEMPOOL_HEIGHT) {
+            data->assetId = AssetNames().Find(data->assetName).value_or(NULL_ASSET_ID);
+        } else {
+            data->assetId = AssetNames().Intern(data->assetName);
+        }
+        coin.m_asset_output = std::move(data);
+    }
+    return coin.m_asset_output.get();
 }
 
 bool GetAssetData(const CScript& script, CAssetOutputEntry& data)
@@ -4164,8 +3804,8 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsVerifierCache) {
-        if (passetsVerifierCache->Exists(name)) {
-            verifierString = passetsVerifierCache->Get(name);
+        if (const auto cached = passetsVerifierCache->Get(name)) {
+            verifierString = *cached;
             return true;
         }
     }
@@ -8,8 +8,11 @@
 
 #include <consensus/amount.h>
 #include <tinyformat.h>
+#include <assets/assetbalancemap.h>
+#include <assets/assetlookup.h>
 #include <assets/assettypes.h>
 
+#include <atomic>
 #include <string>
 #include <set>
 #include <map>
@@ -68,9 +71,6 @@ class CRestrictedDB;
 struct CAssetOutputEntry;
 struct CBlockAssetUndo;
 
-// 2500 * 82 Bytes == 205 KB (kilobytes) of memory
-#define MAX_CACHE_ASSETS_SIZE 2500
-
 // Create map that store that state of current reissued transaction that the mempool as accepted.
 // If an asset name is in this map, any other reissue transactions wont be accepted into the mempool
 extern std::map<uint256, std::string> mapReissuedTx;
@@ -79,19 +79,19 @@ extern std::map<std::string, uint256> mapReissuedAssets;
 // Asset global state
 extern CAssetsCache* passets;
 extern CAssetsDB* passetsdb;
-extern CLRUCache<std::string, CDatabasedAssetData>* passetsCache;
+extern AssetLookupTable<std::string, CDatabasedAssetData>* passetsCache;
 extern CRestrictedDB* prestricteddb;
-extern CLRUCache<std::string, CNullAssetTxVerifierString>* passetsVerifierCache;
-extern CLRUCache<std::string, int8_t>* passetsQualifierCache;
-extern CLRUCache<std::string, int8_t>* passetsRestrictionCache;
-extern CLRUCache<std::string, int8_t>* passetsGlobalRestrictionCache;
+extern AssetLookupTable<std::string, CNullAssetTxVerifierString>* passetsVerifierCache;
+extern AssetLookupTable<std::string, int8_t>* passetsQualifierCache;
+extern AssetLookupTable<std::string, int8_t>* passetsRestrictionCache;
+extern AssetLookupTable<std::string, int8_t>* passetsGlobalRestrictionCache;
 extern bool fAssetIndex;
 
 CAssetsCache* GetCurrentAssetCache();
 
 class CAssets {
 public:
-    std::map<std::pair<std::string, std::string>, CAmount> mapAssetsAddressAmount; // pair < Asset Name , Address > -> Quantity of tokens in the address
+    CAssetBalanceMap mapAssetsAddressAmount; // pair < Asset Name , Address > -> Quantity of tokens in the address
 
     // Dirty, Gets wiped once flushed to database
     std::map<std::string, CNewAsset> mapReissuedAssetData; // Asset Name -> New Asset Data
@@ -141,6 +141,12 @@ struct ErrorReport {
 
 std::string GetUserErrorString(const ErrorReport& report);
 
+/**
+ * Dirty asset state layered over the database. passets is the node-wide
+ * layer; ConnectTip/DisconnectTip stack a short-lived cache on top of it
+ * that records only the block's own changes and falls back to passets for
+ * reads, the way a CCoinsViewCache sits on top of its backing view.
+ */
 class CAssetsCache : public CAssets
 {
 private:
@@ -194,103 +200,15 @@ public :
         ClearDirtyCache();
     }
 
-    CAssetsCache(const CAssetsCache& cache) : CAssets(cache)
-    {
-        //! Copy dirty cache also
-        this->vSpentAssets = cache.vSpentAssets;
-        this->vUndoAssetAmount = cache.vUndoAssetAmount;
-
-        //! Transfer Caches
-        this->setNewTransferAssetsToAdd = cache.setNewTransferAssetsToAdd;
-        this->setNewTransferAssetsToRemove = cache.setNewTransferAssetsToRemove;
-
-        //! Issue Caches
-        this->setNewAssetsToRemove = cache.setNewAssetsToRemove;
-        this->setNewAssetsToAdd = cache.setNewAssetsToAdd;
-
-        //! Reissue Caches
-        this->setNewReissueToRemove = cache.setNewReissueToRemove;
-        this->setNewReissueToAdd = cache.setNewReissueToAdd;
-
-        //! Owner Caches
-        this->setNewOwnerAssetsToAdd = cache.setNewOwnerAssetsToAdd;
-        this->setNewOwnerAssetsToRemove = cache.setNewOwnerAssetsToRemove;
-
-        //! Qualifier Caches
-        this->setNewQualifierAddressToAdd = cache.setNewQualifierAddressToAdd;
-        this->setNewQualifierAddressToRemove = cache.setNewQualifierAddressToRemove;
-
-        //! Restricted Address Caches
-        this->setNewRestrictedAddressToAdd = cache.setNewRestrictedAddressToAdd;
-        this->setNewRestrictedAddressToRemove = cache.setNewRestrictedAddressToRemove;
-
-        //! Restricted Global Caches
-        this->setNewRestrictedGlobalToAdd = cache.setNewRestrictedGlobalToAdd;
-        this->setNewRestrictedGlobalToRemove = cache.setNewRestrictedGlobalToRemove;
-
-        //! Restricted Verifier Caches
-        this->setNewRestrictedVerifierToAdd = cache.setNewRestrictedVerifierToAdd;
-        this->setNewRestrictedVerifierToRemove = cache.setNewRestrictedVerifierToRemove;
-
-        //! Root Qualifier Address Map
-        this->mapRootQualifierAddressesAdd = cache.mapRootQualifierAddressesAdd;
-        this->mapRootQualifierAddressesRemove = cache.mapRootQualifierAddressesRemove;
-    }
-
-    CAssetsCache& operator=(const CAssetsCache& cache)
-    {
-        this->mapAssetsAddressAmount = cache.mapAssetsAddressAmount;
-        this->mapReissuedAssetData = cache.mapReissuedAssetData;
-
-        //! Copy dirty cache also
-        this->vSpentAssets = cache.vSpentAssets;
-        this->vUndoAssetAmount = cache.vUndoAssetAmount;
-
-        //! Transfer Caches
-        this->setNewTransferAssetsToAdd = cache.setNewTransferAssetsToAdd;
-        this->setNewTransferAssetsToRemove = cache.setNewTransferAssetsToRemove;
-
-        //! Issue Caches
-        this->setNewAssetsToRemove = cache.setNewAssetsToRemove;
-        this->setNewAssetsToAdd = cache.setNewAssetsToAdd;
-
-        //! Reissue Caches
-        this->setNewReissueToRemove = cache.setNewReissueToRemove;
-        this->setNewReissueToAdd = cache.setNewReissueToAdd;
-
-        //! Owner Caches
-        this->setNewOwnerAssetsToAdd = cache.setNewOwnerAssetsToAdd;
-        this->setNewOwnerAssetsToRemove = cache.setNewOwnerAssetsToRemove;
-
-        //! Qualifier Caches
-        this->setNewQualifierAddressToAdd = cache.setNewQualifierAddressToAdd;
-        this->setNewQualifierAddressToRemove = cache.setNewQualifierAddressToRemove;
-
-        //! Restricted Address Caches
-        this->setNewRestrictedAddressToAdd = cache.setNewRestrictedAddressToAdd;
-        this->setNewRestrictedAddressToRemove = cache.setNewRestrictedAddressToRemove;
-
-        //! Restricted Global Caches
-        this->setNewRestrictedGlobalToAdd = cache.setNewRestrictedGlobalToAdd;
-        this->setNewRestrictedGlobalToRemove = cache.setNewRestrictedGlobalToRemove;
-
-        //! Restricted Verifier Caches
-        this->setNewRestrictedVerifierToAdd = cache.setNewRestrictedVerifierToAdd;
-        this->setNewRestrictedVerifierToRemove = cache.setNewRestrictedVerifierToRemove;
-
-        //! Root Qualifier Address Map
-        this->mapRootQualifierAddressesAdd = cache.mapRootQualifierAddressesAdd;
-        this->mapRootQualifierAddressesRemove = cache.mapRootQualifierAddressesRemove;
-
-        return *this;
-    }
+    //! A per-block view is merged into passets by Flush(), never copied
+    CAssetsCache(const CAssetsCache&) = delete;
+    CAssetsCache& operator=(const CAssetsCache&) = delete;
 
     //! Cache only undo functions
     bool RemoveNewAsset(const CNewAsset& asset, const std::string address);
     bool RemoveTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& out);
     bool RemoveOwnerAsset(const std::string& assetsName, const std::string address);
     bool RemoveReissueAsset(const CReissueAsset& reissue, const std::string address, const COutPoint& out, const std::vector<std::pair<std::string, CBlockAssetUndo> >& vUndoData);
-    bool UndoAssetCoin(const Coin& coin, const COutPoint& out);
     bool RemoveQualifierAddress(const std::string& assetName, const std::string& address, const QualifierType type);
     bool RemoveRestrictedAddress(const std::string& assetName, const std::string& address, const RestrictedType type);
     bool RemoveGlobalRestricted(const std::string& assetName, const RestrictedType type);
@@ -307,7 +225,7 @@ public :
     bool AddRestrictedVerifier(const std::string& assetName, const std::string& verifier);
 
     //! Cache only validation functions
-    bool TrySpendCoin(const COutPoint& out, const CTxOut& coin);
+    bool TrySpendCoin(const COutPoint& out, const Coin& coin);
 
     //! Help functions
     bool ContainsAsset(const CNewAsset& asset);
@@ -339,11 +257,11 @@ public :
     size_t GetCacheSize() const;
     size_t GetCacheSizeV2() const;
 
-    //! Flush all new cache entries into the passets global cache
+    //! Move all new cache entries into the passets global cache, leaving this cache empty
     bool Flush();
 
-    //! Write asset cache data to database
-    bool DumpCacheToDatabase();
+    //! Write asset cache data to database, and record bestBlock as its tip unless it is null
+    bool DumpCacheToDatabase(const uint256& bestBlock = uint256());
 
     //! Clear all dirty cache sets, vetors, and maps
     void ClearDirtyCache() {
@@ -534,8 +452,21 @@ bool GetAssetInfoFromScript(const CScript& scriptPubKey, std::string& strName, C
 
 bool GetAssetData(const CScript& script, CAssetOutputEntry& data);
 
+/** The asset payload of a coin, decoded once and kept with the coin. Null if the coin is not a valid asset output. */
+const CAssetOutputEntry* GetAssetOutput(const Coin& coin);
+
 bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName, const std::string& address);
 
+/**
+ * Fill passetsCache with the assets that were cached at the last shutdown,
+ * hottest first, or with the first assets in key order if none were
+ * recorded, until half of its budget is used. Meant for a background thread:
+ * it reads the database without cs_main and holds it only to insert one small
+ * batch at a time, and lookups keep falling through to the database until it
+ * is done.
+ */
+void WarmAssetCache(const std::atomic<bool>& interrupt);
+
 //! Decode and Encode IPFS hashes, ANS IDs, or OIP hashes
 std::string DecodeAssetData(std::string encoded);
 std::string EncodeAssetData(std::string decoded);
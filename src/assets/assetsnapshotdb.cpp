@@ -5,10 +5,69 @@
 #include <assets/assetsnapshotdb.h>
 #include <assets/assets.h>
 #include <assets/assetdb.h>
+#include <assets/assettypes.h>
 #include <key_io.h>
 #include <logging.h>
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 static const uint8_t SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check
+static const uint8_t SNAPSHOTCHUNK_FLAG = 'O'; // Snapshot owner chunk
+static const uint8_t SNAPSHOTRANGE_FLAG = 'R'; // Snapshot owner chunk range
+
+typedef std::vector<std::pair<std::string, CAmount>> SnapshotChunk;
+
+typedef std::pair<uint32_t, uint32_t> SnapshotChunkRange;
+
+static const SnapshotChunkRange ALL_CHUNKS{0, std::numeric_limits<uint32_t>::max()};
+
+//  Call fn for each owner chunk key of a snapshot. The indexes are not visited
+//  in numeric order.
+static void ForEachChunkKey(CDBIterator& cursor, const std::string& heightAndName, const std::function<bool(uint32_t)>& fn)
+{
+    cursor.Seek(std::make_pair(SNAPSHOTCHUNK_FLAG, std::make_pair(heightAndName, uint32_t{0})));
+
+    while (cursor.Valid()) {
+        std::pair<uint8_t, std::pair<std::string, uint32_t>> key;
+        if (!cursor.GetKey(key) || key.first != SNAPSHOTCHUNK_FLAG || key.second.first != heightAndName) break;
+        if (!fn(key.second.second)) break;
+        cursor.Next();
+    }
+}
+
+//  The chunks that belong to the current header of a snapshot. Chunks outside
+//  of it are left over from a replacement that has not completed. Snapshots
+//  written without a range keep their owners in the header and own no chunks.
+static SnapshotChunkRange ReadChunkRange(CDBWrapper& db, const std::string& heightAndName)
+{
+    SnapshotChunkRange range;
+    if (!db.Read(std::make_pair(SNAPSHOTRANGE_FLAG, heightAndName), range)) return {0, 0};
+    return range;
+}
+
+//  Call fn for each owner stored in the chunks of a snapshot
+static bool ForEachChunkOwner(CDBWrapper& db, const std::string& heightAndName, const std::function<bool(const std::string&, CAmount)>& fn)
+{
+    const SnapshotChunkRange range = ReadChunkRange(db, heightAndName);
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    bool succeeded = true;
+
+    ForEachChunkKey(*pcursor, heightAndName, [&](uint32_t index) {
+        if (index < range.first || index >= range.second) return true;
+        SnapshotChunk chunk;
+        if (!pcursor->GetValue(chunk)) {
+            LogPrintf( "%s : Failed to read owner chunk %d of snapshot '%s'\n", __func__, index, heightAndName);
+            return succeeded = false;
+        }
+        for (const auto& [address, amount] : chunk) {
+            if (!fn(address, amount)) return succeeded = false;
+        }
+        return true;
+    });
+    return succeeded;
+}
 
 CAssetSnapshotDBEntry::CAssetSnapshotDBEntry()
 {
@@ -52,63 +111,73 @@ bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
         return false;
     }
 
-    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
-    std::vector<std::pair<std::string, CAmount>> tempOwnersAndAmounts;
-    int totalEntryCount;
-
-    if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, true, p_assetName, INT_MAX, 0)) {
-        LogPrintf( "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
-        return false;
+    //  New chunks are numbered after every existing chunk of this snapshot, so
+    //  a snapshot that is being replaced stays intact until the final batch,
+    //  which writes the header and the new chunk range and erases the old
+    //  chunks. A snapshot that is interrupted part way is not visible.
+    CAssetSnapshotDBEntry snapshotEntry(p_assetName, p_height, {});
+    uint32_t firstChunk = 0;
+    {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        ForEachChunkKey(*pcursor, snapshotEntry.heightAndName, [&](uint32_t index) {
+            firstChunk = std::max(firstChunk, index + 1);
+            return true;
+        });
     }
 
-    //  Retrieve all of the addresses/amounts in batches
-    const int MAX_RETRIEVAL_COUNT = 100;
-    bool errorsOccurred = false;
+    CDBBatch batch(*this);
+    SnapshotChunk chunk;
+    chunk.reserve(SNAPSHOT_CHUNK_SIZE);
+    uint32_t chunkIndex = firstChunk;
+    size_t ownerCount = 0;
 
-    for (int retrievalOffset = 0; retrievalOffset < totalEntryCount; retrievalOffset += MAX_RETRIEVAL_COUNT) {
-        //  Retrieve the specified segment of addresses
-        if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, false, p_assetName, MAX_RETRIEVAL_COUNT, retrievalOffset)) {
-            LogPrintf( "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
-            errorsOccurred = true;
-            break;
-        }
+    const auto addChunk = [&]() {
+        batch.Write(std::make_pair(SNAPSHOTCHUNK_FLAG, std::make_pair(snapshotEntry.heightAndName, chunkIndex++)), chunk);
+        chunk.clear();
+    };
 
-        //  Verify that some addresses were returned
-        if (tempOwnersAndAmounts.size() == 0) {
-            LogPrintf( "AddAssetOwnershipSnapshot: No addresses were retrieved.\n");
-            continue;
+    //  One pass over a single iterator reads every owner from the same view
+    //  of the assets DB, and neither it nor the writes below need cs_main.
+    bool succeeded = passetsdb->ForEachAssetHolder(p_assetName, [&](const CAssetAddressKey& addressKey, CAmount amount) {
+        std::string address = addressKey.ToString();
+        //  Verify that the address is valid
+        if (!IsValidDestination(DecodeDestination(address))) {
+            LogPrintf( "AddAssetOwnershipSnapshot: Address '%s' is invalid.\n", address.c_str());
+            return true;
         }
 
-        //  Move these into the main set
-        for (auto const & currPair : tempOwnersAndAmounts) {
-            //  Verify that the address is valid
-            CTxDestination dest = DecodeDestination(currPair.first);
-            if (IsValidDestination(dest)) {
-                ownersAndAmounts.insert(currPair);
-            }
-            else {
-                LogPrintf( "AddAssetOwnershipSnapshot: Address '%s' is invalid.\n", currPair.first.c_str());
-            }
-        }
+        chunk.emplace_back(std::move(address), amount);
+        ++ownerCount;
+        if (chunk.size() < SNAPSHOT_CHUNK_SIZE) return true;
 
-        tempOwnersAndAmounts.clear();
-    }
+        addChunk();
+        if (!WriteBatch(batch)) return false;
+        batch.Clear();
+        return true;
+    });
 
-    if (errorsOccurred) {
-        LogPrintf( "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
-        return false;
-    }
-    if (ownersAndAmounts.size() == 0) {
-        LogPrintf( "AddAssetOwnershipSnapshot: No owners exist for asset '%s'.\n", p_assetName.c_str());
+    if (!succeeded || ownerCount == 0) {
+        if (!succeeded) {
+            LogPrintf( "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
+        } else {
+            LogPrintf( "AddAssetOwnershipSnapshot: No owners exist for asset '%s'.\n", p_assetName.c_str());
+        }
+        //  Drop the chunks already written, leaving any previous snapshot
+        batch.Clear();
+        EraseSnapshotChunks(batch, snapshotEntry.heightAndName, firstChunk, chunkIndex);
+        WriteBatch(batch);
         return false;
     }
 
-    //  Write the snapshot to the database. We don't care if we overwrite, because it should be identical.
-    CAssetSnapshotDBEntry snapshotEntry(p_assetName, p_height, ownersAndAmounts);
+    if (!chunk.empty()) addChunk();
+    EraseSnapshotChunks(batch, snapshotEntry.heightAndName, 0, firstChunk);
+    EraseSnapshotChunks(batch, snapshotEntry.heightAndName, chunkIndex, ALL_CHUNKS.second);
+    batch.Write(std::make_pair(SNAPSHOTRANGE_FLAG, snapshotEntry.heightAndName), SnapshotChunkRange{firstChunk, chunkIndex});
+    batch.Write(std::make_pair(SNAPSHOTCHECK_FLAG, snapshotEntry.heightAndName), snapshotEntry);
 
-    if (Write(std::make_pair(SNAPSHOTCHECK_FLAG, snapshotEntry.heightAndName), snapshotEntry)) {
+    if (WriteBatch(batch, true)) {
         LogPrintf( "AddAssetOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d).\n",
-            p_assetName.c_str(), p_height, ownersAndAmounts.size());
+            p_assetName.c_str(), p_height, ownerCount);
         return true;
     }
     return false;
@@ -125,7 +194,11 @@ bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), p_snapshotEntry);
+    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), p_snapshotEntry) &&
+        ForEachChunkOwner(*this, heightAndName, [&](const std::string& address, CAmount amount) {
+            p_snapshotEntry.ownersAndAmounts.emplace(address, amount);
+            return true;
+        });
 
     LogPrintf( "%s : Retrieval of snapshot for '%s' %s!\n",
         __func__,
@@ -145,7 +218,11 @@ bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), true);
+    CDBBatch batch(*this);
+    batch.Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName));
+    batch.Erase(std::make_pair(SNAPSHOTRANGE_FLAG, heightAndName));
+    EraseSnapshotChunks(batch, heightAndName, ALL_CHUNKS.first, ALL_CHUNKS.second);
+    bool succeeded = WriteBatch(batch, true);
 
     LogPrintf( "%s : Removal of snapshot for '%s' %s!\n",
         __func__,
@@ -154,3 +231,33 @@ bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
 
     return succeeded;
 }
+
+bool CAssetSnapshotDB::ForEachSnapshotOwner(
+    const std::string & p_assetName, int p_height,
+    const std::function<bool(const std::string&, CAmount)>& fn)
+{
+    std::string heightAndName = std::to_string(p_height) + p_assetName;
+
+    CAssetSnapshotDBEntry snapshotEntry;
+    if (!Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), snapshotEntry)) {
+        return false;
+    }
+
+    //  Snapshots taken before owners were chunked keep them in the header
+    for (const auto& [address, amount] : snapshotEntry.ownersAndAmounts) {
+        if (!fn(address, amount)) return false;
+    }
+
+    return ForEachChunkOwner(*this, heightAndName, fn);
+}
+
+void CAssetSnapshotDB::EraseSnapshotChunks(CDBBatch& batch, const std::string& heightAndName, uint32_t begin, uint32_t end)
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    ForEachChunkKey(*pcursor, heightAndName, [&](uint32_t index) {
+        if (index >= begin && index < end) {
+            batch.Erase(std::make_pair(SNAPSHOTCHUNK_FLAG, std::make_pair(heightAndName, index)));
+        }
+        return true;
+    });
+}
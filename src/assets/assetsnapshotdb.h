@@ -5,7 +5,11 @@
 #ifndef BITCOIN_ASSETS_ASSETSNAPSHOTDB_H
 #define BITCOIN_ASSETS_ASSETSNAPSHOTDB_H
 
+#include <cstdint>
+#include <functional>
 #include <set>
+#include <string>
+#include <utility>
 
 #include <dbwrapper.h>
 #include <consensus/amount.h>
@@ -51,6 +55,9 @@ public:
     }
 };
 
+//  Number of owners stored under each snapshot chunk key
+static const size_t SNAPSHOT_CHUNK_SIZE = 10000;
+
 class CAssetSnapshotDB  : public CDBWrapper {
 public:
     explicit CAssetSnapshotDB(const fs::path& datadir, size_t nCacheSize, bool fMemory = false, bool fWipe = false);
@@ -58,7 +65,9 @@ public:
     CAssetSnapshotDB(const CAssetSnapshotDB&) = delete;
     CAssetSnapshotDB& operator=(const CAssetSnapshotDB&) = delete;
 
-    //  Add an entry to the snapshot at the specified height
+    //  Add an entry to the snapshot at the specified height. Owners are
+    //      streamed from the assets DB and written out in chunks of
+    //      SNAPSHOT_CHUNK_SIZE, so the full owner list is never in memory.
     bool AddAssetOwnershipSnapshot(
         const std::string & p_assetName, int p_height);
 
@@ -67,9 +76,20 @@ public:
         const std::string & p_assetName, int p_height,
         CAssetSnapshotDBEntry & p_snapshotEntry);
 
+    //  Visit the owners in the snapshot at a specified height one chunk at a
+    //      time, without loading the whole snapshot. Stops if fn returns false.
+    bool ForEachSnapshotOwner(
+        const std::string & p_assetName, int p_height,
+        const std::function<bool(const std::string&, CAmount)>& fn);
+
     //  Remove the asset snapshot at the specified height
     bool RemoveOwnershipSnapshot(
         const std::string & p_assetName, int p_height);
+
+private:
+    //  Add the erasure of the owner chunks of a snapshot with an index in
+    //      [begin, end) to the batch
+    void EraseSnapshotChunks(CDBBatch& batch, const std::string& heightAndName, uint32_t begin, uint32_t end);
 };
 
 
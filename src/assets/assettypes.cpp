@@ -6,7 +6,9 @@
 #include <assets/assettypes.h>
 
 #include <hash.h>
+#include <key_io.h>
 #include <span.h>
+#include <util/overloaded.h>
 
 int IntFromAssetType(AssetType type) {
     return (int)type;
@@ -16,14 +18,74 @@ AssetType AssetTypeFromInt(int nType) {
     return (AssetType)nType;
 }
 
-uint256 CAssetCacheQualifierAddress::GetHash() {
+CAssetAddressKey CAssetAddressKey::FromDestination(const CTxDestination& dest)
+{
+    CAssetAddressKey key;
+    const auto set_hash = [&key](Type type, std::span<const unsigned char> hash) {
+        key.m_type = type;
+        key.m_data.assign(hash.begin(), hash.end());
+    };
+    std::visit(util::Overloaded{
+        [&](const PKHash& id) { set_hash(PKHASH, id); },
+        [&](const ScriptHash& id) { set_hash(SCRIPTHASH, id); },
+        [&](const WitnessV0KeyHash& id) { set_hash(WITNESS_V0_KEYHASH, id); },
+        [&](const WitnessV0ScriptHash& id) { set_hash(WITNESS_V0_SCRIPTHASH, id); },
+        [&](const WitnessV1Taproot& tap) { set_hash(WITNESS_V1_TAPROOT, tap); },
+        [&](const WitnessV2MLDsa44& id) { set_hash(WITNESS_V2_MLDSA44, id); },
+        [&](const auto&) {
+            const std::string address{EncodeDestination(dest)};
+            key.m_type = STRING;
+            key.m_data.assign(address.begin(), address.end());
+        },
+    }, dest);
+    return key;
+}
+
+CAssetAddressKey CAssetAddressKey::FromString(const std::string& address)
+{
+    const CTxDestination dest{DecodeDestination(address)};
+    CAssetAddressKey key{FromDestination(dest)};
+    if (key.m_type == STRING) {
+        // Not a hash destination, or not a valid address at all.
+        key.m_data.assign(address.begin(), address.end());
+    }
+    return key;
+}
+
+std::string CAssetAddressKey::ToString() const
+{
+    const std::span<const unsigned char> data{m_data.data(), m_data.size()};
+    switch (m_type) {
+    case PKHASH:
+        if (data.size() == uint160::size()) return EncodeDestination(PKHash{uint160{data}});
+        break;
+    case SCRIPTHASH:
+        if (data.size() == uint160::size()) return EncodeDestination(ScriptHash{uint160{data}});
+        break;
+    case WITNESS_V0_KEYHASH:
+        if (data.size() == uint160::size()) return EncodeDestination(WitnessV0KeyHash{uint160{data}});
+        break;
+    case WITNESS_V0_SCRIPTHASH:
+        if (data.size() == uint256::size()) return EncodeDestination(WitnessV0ScriptHash{uint256{data}});
+        break;
+    case WITNESS_V1_TAPROOT:
+        if (data.size() == XOnlyPubKey::size()) return EncodeDestination(WitnessV1Taproot{XOnlyPubKey{data}});
+        break;
+    case WITNESS_V2_MLDSA44:
+        if (data.size() == uint256::size()) return EncodeDestination(WitnessV2MLDsa44{uint256{data}});
+        break;
+    }
+    return std::string(m_data.begin(), m_data.end());
+}
+
+uint256 CAssetCacheQualifierAddress::GetHash() const {
     return Hash(MakeUCharSpan(assetName), MakeUCharSpan(address));
 }
 
-uint256 CAssetCacheRestrictedAddress::GetHash() {
+uint256 CAssetCacheRestrictedAddress::GetHash() const {
     return Hash(MakeUCharSpan(assetName), MakeUCharSpan(address));
 }
 
-uint256 CAssetCacheRootQualifierChecker::GetHash() {
+uint256 CAssetCacheRootQualifierChecker::GetHash() const {
     return Hash(MakeUCharSpan(rootAssetName), MakeUCharSpan(address));
 }
@@ -7,7 +7,9 @@
 #define BITCOIN_ASSETS_ASSETTYPES_H
 
 #include <addresstype.h>
+#include <assets/assetnames.h>
 #include <consensus/amount.h>
+#include <prevector.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <uint256.h>
@@ -69,12 +71,54 @@ struct CAssetOutputEntry
 {
     int type;               // TX_NEW_ASSET, TX_TRANSFER_ASSET, TX_REISSUE_ASSET
     std::string assetName;
+    AssetId assetId{NULL_ASSET_ID}; // interned assetName, set for coins by GetAssetOutput()
     CTxDestination destination;
     CAmount nAmount;
     std::string message;    // for transfers with attached message
     int64_t expireTime{0};  // for transfers with expiration
 };
 
+/**
+ * Compact key for an address holding assets: the destination type and its
+ * 20 or 32 byte hash, instead of the encoded address string. Destinations
+ * without such a hash keep their address string, so any key converts back
+ * to the address it was made from.
+ */
+class CAssetAddressKey
+{
+public:
+    enum Type : uint8_t {
+        STRING = 0,
+        PKHASH = 1,
+        SCRIPTHASH = 2,
+        WITNESS_V0_KEYHASH = 3,
+        WITNESS_V0_SCRIPTHASH = 4,
+        WITNESS_V1_TAPROOT = 5,
+        WITNESS_V2_MLDSA44 = 6,
+    };
+
+    CAssetAddressKey() = default;
+
+    static CAssetAddressKey FromDestination(const CTxDestination& dest);
+    static CAssetAddressKey FromString(const std::string& address);
+    std::string ToString() const;
+
+    friend bool operator==(const CAssetAddressKey& a, const CAssetAddressKey& b)
+    {
+        return a.m_type == b.m_type && a.m_data == b.m_data;
+    }
+    friend bool operator<(const CAssetAddressKey& a, const CAssetAddressKey& b)
+    {
+        return a.m_type < b.m_type || (a.m_type == b.m_type && a.m_data < b.m_data);
+    }
+
+    SERIALIZE_METHODS(CAssetAddressKey, obj) { READWRITE(obj.m_type, obj.m_data); }
+
+private:
+    uint8_t m_type{STRING};
+    prevector<32, unsigned char> m_data;
+};
+
 static constexpr int8_t IPFS_SHA2_256 = 0x12;
 static constexpr int8_t TXID_NOTIFIER = 0x54;
 static constexpr int8_t IPFS_SHA2_256_LEN = 0x20;
@@ -521,7 +565,7 @@ struct CAssetCacheQualifierAddress {
         return assetName < rhs.assetName || (assetName == rhs.assetName && address < rhs.address);
     }
 
-    uint256 GetHash();
+    uint256 GetHash() const;
 };
 
 struct CAssetCacheRootQualifierChecker {
@@ -537,7 +581,7 @@ struct CAssetCacheRootQualifierChecker {
         return rootAssetName < rhs.rootAssetName || (rootAssetName == rhs.rootAssetName && address < rhs.address);
     }
 
-    uint256 GetHash();
+    uint256 GetHash() const;
 };
 
 struct CAssetCacheRestrictedAddress
@@ -558,7 +602,7 @@ struct CAssetCacheRestrictedAddress
         return assetName < rhs.assetName || (assetName == rhs.assetName && address < rhs.address);
     }
 
-    uint256 GetHash();
+    uint256 GetHash() const;
 };
 
 struct CAssetCacheRestrictedGlobal
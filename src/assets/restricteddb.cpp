@@ -111,6 +111,93 @@ bool CRestrictedDB::EraseGlobalRestriction(const std::string& assetName)
     return Erase(std::make_pair(GLOBAL_RESTRICTION_FLAG, assetName));
 }
 
+void CRestrictedDBBatch::WriteVerifier(const std::string& assetName, const std::string& verifier)
+{
+    ops.push_back({VERIFIER_FLAG, false, assetName, verifier});
+}
+
+void CRestrictedDBBatch::EraseVerifier(const std::string& assetName)
+{
+    ops.push_back({VERIFIER_FLAG, true, assetName, ""});
+}
+
+void CRestrictedDBBatch::WriteAddressQualifier(const std::string& address, const std::string& tag)
+{
+    ops.push_back({ADDRESS_QULAIFIER_FLAG, false, address, tag});
+}
+
+void CRestrictedDBBatch::EraseAddressQualifier(const std::string& address, const std::string& tag)
+{
+    ops.push_back({ADDRESS_QULAIFIER_FLAG, true, address, tag});
+}
+
+void CRestrictedDBBatch::WriteQualifierAddress(const std::string& address, const std::string& tag)
+{
+    ops.push_back({QULAIFIER_ADDRESS_FLAG, false, tag, address});
+}
+
+void CRestrictedDBBatch::EraseQualifierAddress(const std::string& address, const std::string& tag)
+{
+    ops.push_back({QULAIFIER_ADDRESS_FLAG, true, tag, address});
+}
+
+void CRestrictedDBBatch::WriteRestrictedAddress(const std::string& address, const std::string& assetName)
+{
+    ops.push_back({RESTRICTED_ADDRESS_FLAG, false, address, assetName});
+}
+
+void CRestrictedDBBatch::EraseRestrictedAddress(const std::string& address, const std::string& assetName)
+{
+    ops.push_back({RESTRICTED_ADDRESS_FLAG, true, address, assetName});
+}
+
+void CRestrictedDBBatch::WriteGlobalRestriction(const std::string& assetName)
+{
+    ops.push_back({GLOBAL_RESTRICTION_FLAG, false, assetName, ""});
+}
+
+void CRestrictedDBBatch::EraseGlobalRestriction(const std::string& assetName)
+{
+    ops.push_back({GLOBAL_RESTRICTION_FLAG, true, assetName, ""});
+}
+
+bool CRestrictedDB::WriteFlushBatch(const CRestrictedDBBatch& restricted)
+{
+    const int8_t i = 1;
+    CDBBatch batch(*this);
+    for (const auto& op : restricted.ops) {
+        switch (op.flag) {
+        case VERIFIER_FLAG:
+            // The verifier string is stored as the value, not in the key.
+            if (op.erase) {
+                batch.Erase(std::make_pair(VERIFIER_FLAG, op.first));
+            } else {
+                batch.Write(std::make_pair(VERIFIER_FLAG, op.first), op.second);
+            }
+            break;
+        case GLOBAL_RESTRICTION_FLAG:
+            if (op.erase) {
+                batch.Erase(std::make_pair(GLOBAL_RESTRICTION_FLAG, op.first));
+            } else {
+                batch.Write(std::make_pair(GLOBAL_RESTRICTION_FLAG, op.first), i);
+            }
+            break;
+        case ADDRESS_QULAIFIER_FLAG:
+        case QULAIFIER_ADDRESS_FLAG:
+        case RESTRICTED_ADDRESS_FLAG:
+            if (op.erase) {
+                batch.Erase(std::make_pair(op.flag, std::make_pair(op.first, op.second)));
+            } else {
+                batch.Write(std::make_pair(op.flag, std::make_pair(op.first, op.second)), i);
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return WriteBatch(batch, true);
+}
+
 bool CRestrictedDB::WriteFlag(const std::string &name, bool fValue)
 {
     return Write(std::make_pair(DB_FLAG, name), fValue ? static_cast<uint8_t>('1') : static_cast<uint8_t>('0'));
@@ -7,11 +7,49 @@
 #define BITCOIN_ASSETS_RESTRICTEDDB_H
 
 #include <dbwrapper.h>
+#include <serialize.h>
 #include <util/fs.h>
 
 #include <string>
 #include <vector>
 
+/**
+ * Changes to the restricted database collected during an asset flush, in the
+ * order they were made. The asset database keeps a copy until they have been
+ * written, so a flush interrupted between the two databases can be replayed.
+ */
+class CRestrictedDBBatch
+{
+public:
+    void WriteVerifier(const std::string& assetName, const std::string& verifier);
+    void EraseVerifier(const std::string& assetName);
+    void WriteAddressQualifier(const std::string& address, const std::string& tag);
+    void EraseAddressQualifier(const std::string& address, const std::string& tag);
+    void WriteQualifierAddress(const std::string& address, const std::string& tag);
+    void EraseQualifierAddress(const std::string& address, const std::string& tag);
+    void WriteRestrictedAddress(const std::string& address, const std::string& assetName);
+    void EraseRestrictedAddress(const std::string& address, const std::string& assetName);
+    void WriteGlobalRestriction(const std::string& assetName);
+    void EraseGlobalRestriction(const std::string& assetName);
+
+    bool IsEmpty() const { return ops.empty(); }
+
+    SERIALIZE_METHODS(CRestrictedDBBatch, obj) { READWRITE(obj.ops); }
+
+private:
+    friend class CRestrictedDB;
+
+    struct Op {
+        uint8_t flag{0};
+        bool erase{false};
+        std::string first;
+        std::string second;
+
+        SERIALIZE_METHODS(Op, obj) { READWRITE(obj.flag, obj.erase, obj.first, obj.second); }
+    };
+    std::vector<Op> ops;
+};
+
 class CRestrictedDB : public CDBWrapper {
 
 public:
@@ -45,6 +83,9 @@ public:
     bool ReadGlobalRestriction(const std::string& assetName);
     bool EraseGlobalRestriction(const std::string& assetName);
 
+    // Apply the changes of an asset flush in one synchronous write
+    bool WriteFlushBatch(const CRestrictedDBBatch& batch);
+
     // Write / Read Database flags
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
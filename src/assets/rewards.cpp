@@ -10,6 +10,7 @@
 #include <key_io.h>
 #include <logging.h>
 #include <chainparams.h>
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
@@ -117,29 +118,29 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
         }
     }
 
-    std::set<OwnerAndAmount> nonExceptionOwnerships;
-    CAmount totalAmtOwned = 0;
+    //  Ignore exception and burn addresses
+    const auto isPaid = [&](const std::string& address) {
+        return exceptionAddressSet.find(address) == exceptionAddressSet.end() && !IsBurnAddress(address);
+    };
 
-    CAssetSnapshotDBEntry snapshotEntry;
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    //  The snapshot is streamed twice, once for the total and once for the
+    //  rewards, so only the distribution list itself is held in memory.
+    CAmount totalAmtOwned = 0;
+    size_t ownerCount = 0;
+    if (!pAssetSnapshotDb->ForEachSnapshotOwner(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight,
+            [&](const std::string& address, CAmount amount) {
+                if (isPaid(address)) {
+                    totalAmtOwned += amount;
+                    ++ownerCount;
+                }
+                return true;
+            })) {
         LogPrintf("%s: Failed to retrieve ownership snapshot list!\n", __func__);
         return false;
     }
 
-    for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
-        //  Ignore exception and burn addresses
-        if (
-                exceptionAddressSet.find(currPair.first) == exceptionAddressSet.end()
-                && !IsBurnAddress(currPair.first)
-                ) {
-            //  Address is valid so add it to the payment list
-            nonExceptionOwnerships.insert(OwnerAndAmount(currPair.first, currPair.second));
-            totalAmtOwned += currPair.second;
-        }
-    }
-
     //  Make sure we have some addresses to pay to
-    if (nonExceptionOwnerships.size() == 0) {
+    if (ownerCount == 0) {
         LogPrintf("%s: Ownership of '%s' includes only exception/burn addresses.\n", __func__,
                  p_rewardSnapshot.strOwnershipAsset.c_str());
         return false;
@@ -151,29 +152,42 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
     LogPrintf("%s: Total payout amount %d\n", __func__,
              modifiedPaymentInAssetUnits);
 
+    vecDistributionList.reserve(ownerCount);
     CAmount totalSentAsRewards = 0;
     //  Loop through asset owners
-    for (auto & ownership : nonExceptionOwnerships) {
-        // Get percentage of total ownership
-        long double percent = (long double)ownership.amount / (long double)totalAmtOwned;
-        // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
-        CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-        // Remove all none accurate units e.g with units 4 90054100 => 9005
-        rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-        // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
-        rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-
-        totalSentAsRewards += rewardAmt;
-
-        LogPrintf("%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
-                 p_rewardSnapshot.strOwnershipAsset.c_str(), ownership.address.c_str(),
-                 ownership.amount, rewardAmt);
-
-        //  Save it into our list if the reward payment is above zero
-        if (rewardAmt > 0)
-            vecDistributionList.push_back(OwnerAndAmount(ownership.address, rewardAmt));
+    if (!pAssetSnapshotDb->ForEachSnapshotOwner(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight,
+            [&](const std::string& address, CAmount amount) {
+                if (!isPaid(address)) return true;
+
+                // Get percentage of total ownership
+                long double percent = (long double)amount / (long double)totalAmtOwned;
+                // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
+                CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+                // Remove all none accurate units e.g with units 4 90054100 => 9005
+                rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+                // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
+                rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+
+                totalSentAsRewards += rewardAmt;
+
+                LogPrintf("%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
+                         p_rewardSnapshot.strOwnershipAsset.c_str(), address.c_str(),
+                         amount, rewardAmt);
+
+                //  Save it into our list if the reward payment is above zero
+                if (rewardAmt > 0)
+                    vecDistributionList.push_back(OwnerAndAmount(address, rewardAmt));
+                return true;
+            })) {
+        LogPrintf("%s: Failed to retrieve ownership snapshot list!\n", __func__);
+        vecDistributionList.clear();
+        return false;
     }
 
+    //  Payments are batched by position in this list, so keep the address
+    //  order the list has always had
+    std::sort(vecDistributionList.begin(), vecDistributionList.end());
+
     CAmount change = totalAmtOwned - totalSentAsRewards;
     if (change > 0) {
         LogPrintf("%s: Found change amount of %u\n", __func__, change);
@@ -5,13 +5,54 @@
 #include <assets/snapshotrequestdb.h>
 
 #include <logging.h>
+#include <serialize.h>
+
+#include <ios>
 #include <set>
 
-static const uint8_t SNAPSHOTREQUEST_FLAG = 'S';
+//! Requests keyed by the ambiguous string height + name, upgraded at startup
+static const uint8_t LEGACY_SNAPSHOTREQUEST_FLAG = 'S';
+static const uint8_t SNAPSHOTREQUEST_FLAG = 'H';
 
 static const uint8_t DISTRIBUTEREQUEST_FLAG = 'D';
 static const uint8_t DISTRIBUTETRANSACTION_FLAG = 'T';
 
+static const size_t SNAPSHOTREQUEST_BATCH_SIZE = 16 << 20;
+
+namespace {
+/**
+ * Snapshot request key. The height is written big-endian so requests are
+ * ordered by height and then asset name, and the requests of one height
+ * form a single key range.
+ */
+struct SnapshotRequestKey {
+    int height;
+    std::string assetName;
+
+    SnapshotRequestKey() : height(0) {}
+    SnapshotRequestKey(int height_in, const std::string& asset_name) : height(height_in), assetName(asset_name) {}
+
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, SNAPSHOTREQUEST_FLAG);
+        ser_writedata32be(s, height);
+        s << assetName;
+    }
+
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != SNAPSHOTREQUEST_FLAG) {
+            throw std::ios_base::failure("Invalid format for snapshot request key");
+        }
+        height = ser_readdata32be(s);
+        s >> assetName;
+    }
+};
+} // namespace
+
 CSnapshotRequestDBEntry::CSnapshotRequestDBEntry()
 {
     SetNull();
@@ -50,7 +91,7 @@ bool CSnapshotRequestDB::ScheduleSnapshot(
     CSnapshotRequestDBEntry snapshotRequest(p_assetName, p_heightForSnapshot);
 
     //  Add the entry to the database
-    bool succeeded = Write(std::make_pair(SNAPSHOTREQUEST_FLAG, snapshotRequest.heightAndName), snapshotRequest);
+    bool succeeded = Write(SnapshotRequestKey(p_heightForSnapshot, p_assetName), snapshotRequest);
 
     LogPrintf( "%s : Snapshot request for '%s' at height %d %s!\n",
         __func__,
@@ -71,7 +112,7 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequest(
     LogPrintf( "%s : Looking for snapshot request '%s'\n",
         __func__, heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTREQUEST_FLAG, heightAndName), p_snapshotRequest);
+    bool succeeded = Read(SnapshotRequestKey(p_heightForSnapshot, p_assetName), p_snapshotRequest);
 
     LogPrintf( "%s : Retrieval of snapshot request for '%s' %s!\n",
         __func__,
@@ -83,10 +124,7 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequest(
 
 bool CSnapshotRequestDB::ContainsSnapshotRequest(const std::string & p_assetName, int p_heightForSnapshot)
 {
-    std::string heightAndName = std::to_string(p_heightForSnapshot) + p_assetName;
-
-    CSnapshotRequestDBEntry snapshotRequest;
-    return Read(std::make_pair(SNAPSHOTREQUEST_FLAG, heightAndName), snapshotRequest);
+    return Exists(SnapshotRequestKey(p_heightForSnapshot, p_assetName));
 }
 
 bool CSnapshotRequestDB::RemoveSnapshotRequest(
@@ -101,7 +139,7 @@ bool CSnapshotRequestDB::RemoveSnapshotRequest(
         heightAndName.c_str());
 
     //  Otherwise, erase the entire entry since none are left.
-    bool succeeded = Erase(std::make_pair(SNAPSHOTREQUEST_FLAG, heightAndName), true);
+    bool succeeded = Erase(SnapshotRequestKey(p_heightForSnapshot, p_assetName), true);
 
     LogPrintf( "%s : Removal of snapshot request for '%s' %s!\n",
         __func__,
@@ -131,24 +169,20 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequestsForHeight(
 
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
-    pcursor->SeekToFirst();
+    //  A height of zero means all heights, which is the whole key range
+    pcursor->Seek(SnapshotRequestKey(p_blockHeight, assetNameProvided ? p_assetName : ""));
 
-    // Load all pending rewards
     while (pcursor->Valid()) {
-        std::pair<uint8_t, int> key;
+        SnapshotRequestKey key;
+        if (!pcursor->GetKey(key)) break;
+        if (p_blockHeight != 0 && key.height != p_blockHeight) break;
 
-        //  Only retrieve entries at the provided block height
-        if (pcursor->GetKey(key) && key.first == SNAPSHOTREQUEST_FLAG) {
+        //  If an asset was specified, only add entries for it.
+        //  Otherwise, retrieve all entries.
+        if (!assetNameProvided || p_assetName == key.assetName) {
             CSnapshotRequestDBEntry reqDbEntry;
-
             if (pcursor->GetValue(reqDbEntry)) {
-                if (p_blockHeight == 0 || reqDbEntry.heightForSnapshot == p_blockHeight) {
-                    //  If an asset was specified, only add entries for it.
-                    //  Otherwise, retrieve all entries.
-                    if (!assetNameProvided || p_assetName == reqDbEntry.assetName) {
-                        p_assetsToSnapshot.insert(reqDbEntry);
-                    }
-                }
+                p_assetsToSnapshot.insert(reqDbEntry);
             } else {
                 LogPrintf( "%s: Failed to read snapshot request\n", __func__);
             }
@@ -160,6 +194,36 @@ bool CSnapshotRequestDB::RetrieveSnapshotRequestsForHeight(
     return true;
 }
 
+bool CSnapshotRequestDB::UpgradeSnapshotRequestKeys()
+{
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(LEGACY_SNAPSHOTREQUEST_FLAG);
+    CDBBatch batch(*this);
+    size_t upgraded{0};
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, std::string> key;
+        if (!pcursor->GetKey(key) || key.first != LEGACY_SNAPSHOTREQUEST_FLAG) break;
+        CSnapshotRequestDBEntry reqDbEntry;
+        if (!pcursor->GetValue(reqDbEntry)) {
+            LogError("%s: failed to read snapshot request from database\n", __func__);
+            return false;
+        }
+        batch.Write(SnapshotRequestKey(reqDbEntry.heightForSnapshot, reqDbEntry.assetName), reqDbEntry);
+        batch.Erase(key);
+        if (batch.ApproximateSize() > SNAPSHOTREQUEST_BATCH_SIZE) {
+            if (!WriteBatch(batch, true)) return false;
+            batch.Clear();
+        }
+        ++upgraded;
+        pcursor->Next();
+    }
+    if (!WriteBatch(batch, true)) return false;
+    if (upgraded > 0) {
+        LogPrintf("Upgraded %u snapshot requests to height-ordered keys\n", upgraded);
+    }
+    return true;
+}
+
 CDistributeSnapshotRequestDB::CDistributeSnapshotRequestDB(
         const fs::path& datadir, size_t nCacheSize, bool fMemory, bool fWipe)
         : CDBWrapper(DBParams{
@@ -21,7 +21,7 @@ public:
     std::string assetName;
     int heightForSnapshot;
 
-    //  Used as the DB key for the snapshot request
+    //  Was the DB key for the snapshot request, kept for the stored format
     std::string heightAndName;
 
     CSnapshotRequestDBEntry();
@@ -39,7 +39,8 @@ public:
 
     bool operator<(const CSnapshotRequestDBEntry &rhs) const
     {
-        return heightAndName < rhs.heightAndName;
+        return heightForSnapshot < rhs.heightForSnapshot ||
+               (heightForSnapshot == rhs.heightForSnapshot && assetName < rhs.assetName);
     }
 
     // Serialization methods
@@ -82,6 +83,10 @@ public:
         const std::string & p_assetName, int p_blockHeight,
         std::set<CSnapshotRequestDBEntry> & p_assetsToSnapshot
     );
+
+    //  Move requests stored under the old string keys to the height-ordered
+    //      keys, so a lookup by height is a single range scan
+    bool UpgradeSnapshotRequestKeys();
 };
 
 class CDistributeSnapshotRequestDB  : public CDBWrapper
@@ -17,6 +17,7 @@
 #include <script/script.h>
 
 #include <algorithm>
+#include <iterator>
 
 namespace {
 /** Log an error and return false (replaces old error() convenience). */
@@ -170,20 +171,18 @@ CAuxPow::initAuxPow(CBlockHeader& header)
     std::vector<unsigned char> vchRootHash(merkleRoot.begin(), merkleRoot.end());
     std::reverse(vchRootHash.begin(), vchRootHash.end());
 
-    // Start with the merged-mining header
-    CScript scriptSig;
-    scriptSig << std::vector<unsigned char>(pchMergedMiningHeader, pchMergedMiningHeader + 4);
-
-    // Then add the merkle root hash
-    scriptSig << vchRootHash;
+    // check() looks for the merged-mining header immediately followed by the
+    // root, tree size and nonce, so they must be one contiguous push rather
+    // than separate pushes with opcodes in between.
+    std::vector<unsigned char> inputData(pchMergedMiningHeader, pchMergedMiningHeader + sizeof(pchMergedMiningHeader));
+    inputData.insert(inputData.end(), vchRootHash.begin(), vchRootHash.end());
 
-    // Finally add tree size (1) and nonce (0)
-    uint32_t nSize = 1;  // Tree size of 1 (encoded as little-endian)
-    uint32_t nNonce = 0; // Nonce of 0 (encoded as little-endian)
+    // Finally add tree size (1) and nonce (0), both little-endian
+    const unsigned char sizeAndNonce[8] = {1, 0, 0, 0, 0, 0, 0, 0};
+    inputData.insert(inputData.end(), std::begin(sizeAndNonce), std::end(sizeAndNonce));
 
-    // Add the size and nonce in little-endian format
-    scriptSig << nSize;
-    scriptSig << nNonce;
+    CScript scriptSig;
+    scriptSig << inputData;
 
     /* Fake a parent-block coinbase with just the required input
        script and no outputs.  */
@@ -0,0 +1,99 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addressindex.h>
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <uint256.h>
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Writing the address index deltas of a block with 1000 transactions of one
+// input and two outputs each, a quarter of them asset transfers, to a
+// database on disk: version 1 keys against the compact version 2 ones. The
+// name of each benchmark carries the compacted size of the keys it writes.
+
+static std::vector<std::pair<CAddressIndexKey, CAmount>> BlockDeltas(int height)
+{
+    FastRandomContext rng(true);
+    const std::string assets[]{"MEOWTOKEN", "CAT/KITTEN", "DOG#COLLAR"};
+    std::vector<std::pair<CAddressIndexKey, CAmount>> deltas;
+    for (unsigned int tx = 1; tx <= 1000; ++tx) {
+        const uint256 txhash{rng.rand256()};
+        const std::string& asset{tx % 4 == 0 ? assets[tx % std::size(assets)] : MEWC};
+        for (size_t i = 0; i < 3; ++i) {
+            uint256 hashBytes;
+            const auto hash160{rng.randbytes(20)};
+            std::copy(hash160.begin(), hash160.end(), hashBytes.begin());
+            deltas.emplace_back(CAddressIndexKey(1, hashBytes, asset, height, tx, txhash, i, /*isSpending=*/i == 0), i == 0 ? -2000 : 1000);
+        }
+    }
+    return deltas;
+}
+
+template <typename WriteDelta>
+static void WriteAddressDeltas(benchmark::Bench& bench, const char* name, std::span<const uint8_t> prefixes, WriteDelta&& write_delta)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    std::vector<std::vector<std::pair<CAddressIndexKey, CAmount>>> blocks;
+    for (int height = 0; height < 16; ++height) {
+        blocks.push_back(BlockDeltas(100000 + height));
+    }
+    const auto write_block = [&](CDBWrapper& db, const std::vector<std::pair<CAddressIndexKey, CAmount>>& deltas) {
+        CDBBatch batch{db};
+        for (const auto& [key, amount] : deltas) {
+            write_delta(batch, key, amount);
+        }
+        db.WriteBatch(batch);
+    };
+
+    // Measure the size of all the blocks once compacted, as leveldb only
+    // estimates the size of what has left the memtable.
+    const fs::path size_path{testing_setup->m_path_root / "size"};
+    {
+        CDBWrapper db{DBParams{.path = size_path, .cache_bytes = 1 << 20, .wipe_data = true}};
+        for (const auto& deltas : blocks) write_block(db, deltas);
+    }
+    CDBWrapper sized{DBParams{.path = size_path, .cache_bytes = 1 << 20, .options = {.force_compact = true}}};
+    size_t size{0};
+    for (const uint8_t prefix : prefixes) {
+        size += sized.EstimateSize(prefix, uint8_t(prefix + 1));
+    }
+    bench.name(strprintf("%s (%.1f bytes/delta on disk)", name, double(size) / (blocks.size() * blocks[0].size())));
+
+    CDBWrapper db{DBParams{.path = testing_setup->m_path_root / "bench", .cache_bytes = 1 << 20, .wipe_data = true}};
+    size_t block{0};
+    bench.batch(blocks[0].size()).unit("delta").run([&] {
+        write_block(db, blocks[block++ % blocks.size()]);
+    });
+}
+
+static void AddressIndexWriteLegacy(benchmark::Bench& bench)
+{
+    constexpr uint8_t prefixes[]{'a'};
+    WriteAddressDeltas(bench, __func__, prefixes, [](CDBBatch& batch, const CAddressIndexKey& key, CAmount amount) {
+        batch.Write(std::make_pair(uint8_t{'a'}, key), amount);
+    });
+}
+
+static void AddressIndexWriteCompact(benchmark::Bench& bench)
+{
+    constexpr uint8_t prefixes[]{'d', 't'};
+    WriteAddressDeltas(bench, __func__, prefixes, [](CDBBatch& batch, const CAddressIndexKey& key, CAmount amount) {
+        // Asset ids as the index would have interned them
+        const uint32_t assetId = key.asset == MEWC ? 0 : key.asset.size();
+        batch.Write(std::make_pair(uint8_t{'d'}, CAddressIndexCompactKey(key, assetId)), amount);
+        batch.Write(std::make_pair(uint8_t{'t'}, CAddressIndexTxKey(key.blockHeight, key.txindex)), key.txhash);
+    });
+}
+
+BENCHMARK(AddressIndexWriteLegacy, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddressIndexWriteCompact, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,66 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <assets/assettypes.h>
+#include <bench/bench.h>
+#include <key_io.h>
+#include <random.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Building the two asset balance database keys for every output of an
+// asset-heavy block: 2000 transfers of a handful of assets to distinct
+// addresses.
+
+static std::vector<CTxDestination> BlockDestinations()
+{
+    FastRandomContext rng(true);
+    std::vector<CTxDestination> destinations;
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 4 == 0) {
+            destinations.emplace_back(ScriptHash{uint160{rng.randbytes(20)}});
+        } else {
+            destinations.emplace_back(PKHash{uint160{rng.randbytes(20)}});
+        }
+    }
+    return destinations;
+}
+
+template <typename AddressKey>
+static void BuildBalanceKeys(benchmark::Bench& bench, AddressKey&& address_key)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    const std::vector<CTxDestination> destinations{BlockDestinations()};
+    const std::string assets[]{"MEOWTOKEN", "CAT/KITTEN", "DOG#COLLAR", "PAW"};
+
+    DataStream keys;
+    bench.batch(destinations.size()).unit("output").run([&] {
+        keys.clear();
+        for (size_t i = 0; i < destinations.size(); ++i) {
+            const std::string& asset{assets[i % std::size(assets)]};
+            const auto address{address_key(destinations[i])};
+            keys << std::make_pair(uint8_t{'b'}, std::make_pair(asset, address));
+            keys << std::make_pair(uint8_t{'c'}, std::make_pair(address, asset));
+        }
+    });
+}
+
+static void AssetBalanceKeysString(benchmark::Bench& bench)
+{
+    BuildBalanceKeys(bench, [](const CTxDestination& dest) { return EncodeDestination(dest); });
+}
+
+static void AssetBalanceKeysBinary(benchmark::Bench& bench)
+{
+    BuildBalanceKeys(bench, [](const CTxDestination& dest) { return CAssetAddressKey::FromDestination(dest); });
+}
+
+BENCHMARK(AssetBalanceKeysString, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AssetBalanceKeysBinary, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,104 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <assets/assetdb.h>
+#include <assets/assets.h>
+#include <assets/assettypes.h>
+#include <bench/bench.h>
+#include <coins.h>
+#include <consensus/tx_verify.h>
+#include <consensus/validation.h>
+#include <key_io.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/assets.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The asset steps ConnectBlock takes for every transaction of an asset-heavy
+// block, in the same order: 1000 transactions that each spend two outputs of
+// one of a handful of assets and pay them to two new addresses. The balances
+// of the spent outputs are in the asset cache and those of the new addresses
+// are looked up in the database, as with -assetindex.
+
+static CScript TransferTo(FastRandomContext& rng, const std::string& asset, CAmount amount)
+{
+    CScript script{GetScriptForDestination(PKHash{uint160{rng.randbytes(20)}})};
+    CAssetTransfer(asset, amount).ConstructTransaction(script);
+    return script;
+}
+
+static void ConnectBlockAssetTransfers(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    FastRandomContext rng(true);
+    const std::string assets[]{"MEOWTOKEN", "CATNIP", "DOGBONE", "PAWS"};
+
+    AssetsCacheGuard guard;
+    CAssetsDB assetsdb(testing_setup->m_path_root, 1 << 20, /*fMemory=*/true);
+    CAssetsDB* const prev_assetsdb{passetsdb};
+    passetsdb = &assetsdb;
+    const bool prev_asset_index{fAssetIndex};
+    fAssetIndex = true;
+
+    CCoinsView base;
+    CCoinsViewCache tip(&base);
+    std::vector<CTransactionRef> block;
+    for (int i = 0; i < 1000; ++i) {
+        const std::string& asset{assets[i % std::size(assets)]};
+        CMutableTransaction mtx;
+        for (uint32_t n = 0; n < 2; ++n) {
+            const COutPoint outpoint{Txid::FromUint256(rng.rand256()), n};
+            const CScript script{TransferTo(rng, asset, 5 * COIN)};
+            tip.AddCoin(outpoint, Coin(CTxOut{0, script}, 100, false), false);
+            const CAssetOutputEntry* data{GetAssetOutput(tip.AccessCoin(outpoint))};
+            assert(data);
+            guard.cache.mapAssetsAddressAmount[{asset, EncodeDestination(data->destination)}] = 5 * COIN;
+            mtx.vin.emplace_back(outpoint);
+        }
+        mtx.vout.emplace_back(0, TransferTo(rng, asset, 3 * COIN));
+        mtx.vout.emplace_back(0, TransferTo(rng, asset, 7 * COIN));
+        block.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+
+    bench.batch(block.size()).unit("tx").run([&] {
+        CCoinsViewCache view(&tip);
+        CAssetsCache cache;
+        for (const auto& tx : block) {
+            TxValidationState state;
+            std::vector<std::pair<std::string, uint256>> reissued;
+            const bool valid{Consensus::CheckTxAssets(*tx, state, view, &cache, nullptr, reissued,
+                                                      /*fRunningUnitTests=*/true, nullptr, 0, nullptr, 200)};
+            assert(valid);
+
+            CTxUndo undo;
+            for (const auto& txin : tx->vin) {
+                view.SpendCoin(txin.prevout, &undo.vprevout.emplace_back());
+            }
+            AddCoins(view, *tx, 200);
+            for (size_t j = 0; j < tx->vin.size(); ++j) {
+                cache.TrySpendCoin(tx->vin[j].prevout, undo.vprevout[j]);
+            }
+            for (size_t j = 0; j < tx->vout.size(); ++j) {
+                CAssetOutputEntry data;
+                const bool decoded{GetAssetData(tx->vout[j].scriptPubKey, data)};
+                assert(decoded);
+                const CAssetTransfer transfer(data.assetName, data.nAmount, data.message, data.expireTime);
+                cache.AddTransferAsset(transfer, EncodeDestination(data.destination), COutPoint(tx->GetHash(), j), tx->vout[j]);
+            }
+        }
+    });
+
+    fAssetIndex = prev_asset_index;
+    passetsdb = prev_assetsdb;
+}
+
+BENCHMARK(ConnectBlockAssetTransfers, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,178 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <auxpow.h>
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <checkqueue.h>
+#include <common/args.h>
+#include <common/system.h>
+#include <consensus/validation.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <streams.h>
+#include <util/chaintype.h>
+#include <validation.h>
+
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Proof-of-work part of header validation, as run for every header received
+// during sync, for each of the mainnet proof-of-work eras.
+
+static CBlockHeader MainnetEraHeader(uint32_t nTime)
+{
+    FastRandomContext rng(true);
+    CBlockHeader header;
+    header.nVersion = 0x30000000;
+    header.hashPrevBlock = rng.rand256();
+    header.hashMerkleRoot = rng.rand256();
+    header.nTime = nTime;
+    header.nBits = 0x1b00ffff;
+    header.nNonce = rng.rand32();
+    header.nHeight = 1;
+    header.nNonce64 = rng.rand64();
+    header.mix_hash = rng.rand256();
+    return header;
+}
+
+/** Mainnet parameters; creating them also sets the global activation times. */
+static std::unique_ptr<const CChainParams> MainParams()
+{
+    ArgsManager bench_args;
+    return CreateChainParams(bench_args, ChainType::MAIN);
+}
+
+static void CheckHeaderPoW(benchmark::Bench& bench, const CChainParams& chain_params, const CBlockHeader& header)
+{
+    const Consensus::Params& params{chain_params.GetConsensus()};
+    DataStream wire;
+    wire << header;
+    const std::vector<std::byte> bytes{wire.begin(), wire.end()};
+    bench.unit("header").run([&] {
+        // Decode a fresh header each time, as it would arrive from a peer;
+        // copies would share the memoized proof-of-work hash.
+        DataStream stream{bytes};
+        CBlockHeader received;
+        stream >> received;
+        std::optional<BlockValidationState> result;
+        CHeaderPoWCheck{received, params, result}();
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+}
+
+//! Headers in one batch of the header check queue, as for part of a headers message
+static constexpr size_t HEADER_BATCH{64};
+
+// The batched path of ProcessNewBlockHeaders: the proof of work of a batch of
+// headers checked on the header check queue, with or without the full mix
+// verification that may be deferred for deep headers during sync.
+static void CheckHeaderBatchPoW(benchmark::Bench& bench, const CChainParams& chain_params, uint32_t nTime, bool check_mix_hash)
+{
+    // Like the block check queue, the header check queue is not used on a single core.
+    if (GetNumCores() <= 1) return;
+
+    const Consensus::Params& params{chain_params.GetConsensus()};
+    DataStream wire;
+    for (uint32_t i = 0; i < HEADER_BATCH; ++i) {
+        CBlockHeader header{MainnetEraHeader(nTime)};
+        header.nNonce += i;
+        header.nNonce64 += i;
+        wire << header;
+    }
+    const std::vector<std::byte> bytes{wire.begin(), wire.end()};
+    CCheckQueue<CHeaderPoWCheck> queue{/*batch_size=*/16, GetNumCores() - 1};
+    bench.batch(HEADER_BATCH).unit("header").run([&] {
+        DataStream stream{bytes};
+        std::vector<CBlockHeader> headers(HEADER_BATCH);
+        for (auto& header : headers) stream >> header;
+        std::vector<std::optional<BlockValidationState>> results(HEADER_BATCH);
+        std::vector<CHeaderPoWCheck> checks;
+        checks.reserve(HEADER_BATCH);
+        for (size_t i = 0; i < HEADER_BATCH; ++i) {
+            checks.emplace_back(headers[i], params, results[i], check_mix_hash);
+        }
+        CCheckQueueControl<CHeaderPoWCheck> control{queue};
+        control.Add(std::move(checks));
+        control.Complete();
+        ankerl::nanobench::doNotOptimizeAway(results);
+    });
+}
+
+static void CheckHeaderBatchX16RV2(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderBatchPoW(bench, *chain_params, nKAWPOWActivationTime - 1, /*check_mix_hash=*/true);
+}
+
+static void CheckHeaderBatchKAWPOW(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderBatchPoW(bench, *chain_params, nKAWPOWActivationTime, /*check_mix_hash=*/true);
+}
+
+static void CheckHeaderBatchKAWPOWDeferredMix(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderBatchPoW(bench, *chain_params, nKAWPOWActivationTime, /*check_mix_hash=*/false);
+}
+
+static void CheckHeaderBatchMEOWPOW(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderBatchPoW(bench, *chain_params, nMEOWPOWActivationTime, /*check_mix_hash=*/true);
+}
+
+static void CheckBlockHeaderX16RV2(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderPoW(bench, *chain_params, MainnetEraHeader(nKAWPOWActivationTime - 1));
+}
+
+static void CheckBlockHeaderKAWPOW(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderPoW(bench, *chain_params, MainnetEraHeader(nKAWPOWActivationTime));
+}
+
+static void CheckBlockHeaderMEOWPOW(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CheckHeaderPoW(bench, *chain_params, MainnetEraHeader(nMEOWPOWActivationTime));
+}
+
+static void CheckBlockHeaderAuxPoW(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    CBlockHeader header{MainnetEraHeader(nMEOWPOWActivationTime)};
+    header.nVersion.SetChainId(chain_params->GetConsensus().nAuxpowChainId);
+    CAuxPow::initAuxPow(header);
+    CheckHeaderPoW(bench, *chain_params, header);
+}
+
+static void AuxPowCheck(benchmark::Bench& bench)
+{
+    const auto chain_params{MainParams()};
+    const Consensus::Params& params{chain_params->GetConsensus()};
+    CBlockHeader header{MainnetEraHeader(nMEOWPOWActivationTime)};
+    header.nVersion.SetChainId(params.nAuxpowChainId);
+    CAuxPow::initAuxPow(header);
+    const uint256 hash{header.GetHash()};
+    assert(header.auxpow->check(hash, params.nAuxpowChainId, params));
+    bench.unit("auxpow").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(header.auxpow->check(hash, params.nAuxpowChainId, params));
+    });
+}
+
+BENCHMARK(AuxPowCheck, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckBlockHeaderAuxPoW, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckBlockHeaderKAWPOW, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckBlockHeaderMEOWPOW, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckBlockHeaderX16RV2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckHeaderBatchKAWPOW, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckHeaderBatchKAWPOWDeferredMix, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckHeaderBatchMEOWPOW, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CheckHeaderBatchX16RV2, benchmark::PriorityLevel::HIGH);
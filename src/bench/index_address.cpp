@@ -0,0 +1,67 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <chain.h>
+#include <index/addressindex.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <primitives/transaction.h>
+#include <pubkey.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/assets.h>
+#include <test/util/setup_common.h>
+#include <util/strencodings.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cassert>
+#include <vector>
+
+using namespace util::hex_literals;
+
+// Address index sync over coinbase outputs only, writing the entries of each
+// block on its own against collecting them in batches of the default size.
+static void AddressIndexSync(benchmark::Bench& bench, size_t batch_size)
+{
+    const AssetsCacheGuard guard;
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+
+    int CHAIN_SIZE = 600;
+    CPubKey pubkey{"02ed26169896db86ced4cbb7b3ecef9859b5952825adbeab998fb5b307e54949c9"_hex_u8};
+    CScript script = GetScriptForDestination(PKHash(pubkey));
+    std::vector<CMutableTransaction> noTxns;
+    for (int i = 0; i < CHAIN_SIZE - 100; i++) {
+        test_setup->CreateAndProcessBlock(noTxns, script);
+        SetMockTime(GetTime() + 1);
+    }
+    assert(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+
+    bench.minEpochIterations(5).run([&] {
+        AddressIndex address_index(interfaces::MakeChain(test_setup->m_node), /*n_cache_size=*/0,
+                                   /*f_memory=*/false, /*f_wipe=*/true, batch_size);
+        assert(address_index.Init());
+        assert(!address_index.BlockUntilSyncedToCurrentChain());
+        address_index.Sync();
+
+        IndexSummary summary = address_index.GetSummary();
+        assert(summary.synced);
+        assert(summary.best_block_hash == WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip()->GetBlockHash()));
+    });
+}
+
+static void AddressIndexSyncUnbatched(benchmark::Bench& bench)
+{
+    AddressIndexSync(bench, /*batch_size=*/0);
+}
+
+static void AddressIndexSyncBatched(benchmark::Bench& bench)
+{
+    AddressIndexSync(bench, DEFAULT_ADDRESSINDEX_BATCH << 20);
+}
+
+BENCHMARK(AddressIndexSyncUnbatched, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddressIndexSyncBatched, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,51 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <common/args.h>
+#include <consensus/params.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <util/chaintype.h>
+
+#include <vector>
+
+// Index linking and retargeting for each header of a long multi-algo header
+// sync, as done by AddToBlockIndex and ContextualCheckBlockHeader.
+
+static void LwmaMultiAlgoHeaderSync(benchmark::Bench& bench)
+{
+    ArgsManager bench_args;
+    const auto chain_params{CreateChainParams(bench_args, ChainType::MAIN)};
+    Consensus::Params params{chain_params->GetConsensus()};
+    params.nAuxpowStartHeight = 0;
+
+    // Merge-mined and native blocks in short runs, as when both are mined.
+    FastRandomContext rng(true);
+    std::vector<CBlockIndex> blocks(20000);
+    std::vector<CBlockHeader> headers(blocks.size());
+    bool auxpow{false};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (rng.randrange(3) == 0) auxpow = !auxpow;
+        blocks[i].pprev = i ? &blocks[i - 1] : nullptr;
+        blocks[i].nHeight = i;
+        blocks[i].nTime = 1700000000 + i * params.nPowTargetSpacing;
+        blocks[i].nBits = 0x1c00ffff;
+        blocks[i].nVersion.SetAuxpow(auxpow);
+        headers[i].nVersion.SetAuxpow(auxpow);
+    }
+
+    bench.batch(blocks.size() - 1).unit("header").run([&] {
+        for (size_t i = 1; i < blocks.size(); ++i) {
+            blocks[i].BuildSkip();
+            blocks[i].BuildSameAlgoLink(params.LwmaSearchDepth());
+            ankerl::nanobench::doNotOptimizeAway(GetNextWorkRequired(&blocks[i - 1], &headers[i], params));
+        }
+    });
+}
+
+BENCHMARK(LwmaMultiAlgoHeaderSync, benchmark::PriorityLevel::HIGH);
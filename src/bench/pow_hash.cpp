@@ -0,0 +1,208 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <crypto/ethash/helpers.hpp>
+#include <crypto/ethash/include/ethash/ethash.hpp>
+#include <crypto/ethash/include/ethash/meowpow.hpp>
+#include <crypto/ethash/include/ethash/progpow.hpp>
+#include <crypto/scrypt.h>
+#include <pow_hash.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <tinyformat.h>
+#include <uint256.h>
+
+#include <array>
+#include <cassert>
+#include <vector>
+
+static CBlockHeader ProgPowHeader()
+{
+    FastRandomContext rng(true);
+    CBlockHeader header;
+    header.hashPrevBlock = rng.rand256();
+    header.hashMerkleRoot = rng.rand256();
+    header.nTime = 1700000000;
+    header.nBits = 0x1b00ffff;
+    header.nHeight = 1000000;
+    header.nNonce64 = rng.rand64();
+    header.mix_hash = rng.rand256();
+    return header;
+}
+
+// The pre-optimization conversion path, kept here as a baseline: header hash
+// and mix hash through GetHex()/to_hash256() and the result back through
+// to_hex()/FromHex().
+static uint256 KAWPOWHash_OnlyMix_Hex(const CBlockHeader& header)
+{
+    const auto result = progpow::hash_no_verify(header.nHeight, to_hash256(header.GetKAWPOWHeaderHash().GetHex()),
+                                                to_hash256(header.mix_hash.GetHex()), header.nNonce64);
+    return uint256::FromHex(to_hex(result)).value_or(uint256{});
+}
+
+static uint256 MEOWPOWHash_OnlyMix_Hex(const CBlockHeader& header)
+{
+    const auto result = meowpow::hash_no_verify(header.nHeight, to_hash256(header.GetMEOWPOWHeaderHash().GetHex()),
+                                                to_hash256(header.mix_hash.GetHex()), header.nNonce64);
+    return uint256::FromHex(to_hex(result)).value_or(uint256{});
+}
+
+static void KAWPOWOnlyMix(benchmark::Bench& bench)
+{
+    CBlockHeader header{ProgPowHeader()};
+    bench.unit("header").run([&] {
+        ++header.nNonce64;
+        ankerl::nanobench::doNotOptimizeAway(KAWPOWHash_OnlyMix(header));
+    });
+}
+
+static void KAWPOWOnlyMixHex(benchmark::Bench& bench)
+{
+    CBlockHeader header{ProgPowHeader()};
+    assert(KAWPOWHash_OnlyMix_Hex(header) == KAWPOWHash_OnlyMix(header));
+    bench.unit("header").run([&] {
+        ++header.nNonce64;
+        ankerl::nanobench::doNotOptimizeAway(KAWPOWHash_OnlyMix_Hex(header));
+    });
+}
+
+static void MEOWPOWOnlyMix(benchmark::Bench& bench)
+{
+    CBlockHeader header{ProgPowHeader()};
+    bench.unit("header").run([&] {
+        ++header.nNonce64;
+        ankerl::nanobench::doNotOptimizeAway(MEOWPOWHash_OnlyMix(header));
+    });
+}
+
+static void MEOWPOWOnlyMixHex(benchmark::Bench& bench)
+{
+    CBlockHeader header{ProgPowHeader()};
+    assert(MEOWPOWHash_OnlyMix_Hex(header) == MEOWPOWHash_OnlyMix(header));
+    bench.unit("header").run([&] {
+        ++header.nNonce64;
+        ankerl::nanobench::doNotOptimizeAway(MEOWPOWHash_OnlyMix_Hex(header));
+    });
+}
+
+static std::array<unsigned char, 80> RandomHeaderBytes(FastRandomContext& rng)
+{
+    std::array<unsigned char, 80> data;
+    for (auto& byte : data) byte = rng.randbits<8>();
+    return data;
+}
+
+static void X16RSingle(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    auto data{RandomHeaderBytes(rng)};
+    const uint256 prev{rng.rand256()};
+    bench.unit("header").run([&] {
+        ++data[76];
+        ankerl::nanobench::doNotOptimizeAway(HashX16R(data.data(), data.data() + data.size(), prev));
+    });
+}
+
+static void X16RV2Single(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    auto data{RandomHeaderBytes(rng)};
+    const uint256 prev{rng.rand256()};
+    bench.unit("header").run([&] {
+        ++data[76];
+        ankerl::nanobench::doNotOptimizeAway(HashX16RV2(data.data(), data.data() + data.size(), prev));
+    });
+}
+
+// Full ProgPoW evaluation recomputes the mix from the light cache. Headers
+// stay in epoch 0 so the one-off context build (measured separately below)
+// stays out of the numbers; per-hash cost barely depends on the epoch.
+static CBlockHeader ProgPowEpochZeroHeader()
+{
+    CBlockHeader header{ProgPowHeader()};
+    header.nHeight = 1;
+    return header;
+}
+
+static void KAWPOWFull(benchmark::Bench& bench)
+{
+    CBlockHeader header{ProgPowEpochZeroHeader()};
+    uint256 mix;
+    KAWPOWHash(header, mix);
+    bench.unit("header").run([&] {
+        ++header.nNonce64;
+        ankerl::nanobench::doNotOptimizeAway(KAWPOWHash(header, mix));
+    });
+}
+
+static void MEOWPOWFull(benchmark::Bench& bench)
+{
+    CBlockHeader header{ProgPowEpochZeroHeader()};
+    uint256 mix;
+    MEOWPOWHash(header, mix);
+    bench.unit("header").run([&] {
+        ++header.nNonce64;
+        ankerl::nanobench::doNotOptimizeAway(MEOWPOWHash(header, mix));
+    });
+}
+
+static void ProgPowEpochContextBuild(benchmark::Bench& bench, int epoch_number)
+{
+    const int items{ethash_calculate_light_cache_num_items(epoch_number)};
+    bench.name(strprintf("%s epoch %d (light cache %.1f MiB)", __func__, epoch_number,
+                         ethash::get_light_cache_size(items) / (1024.0 * 1024.0)));
+    bench.epochs(1).epochIterations(1).unit("context").run([&] {
+        const auto context{ethash::create_epoch_context(epoch_number)};
+        assert(context);
+        ankerl::nanobench::doNotOptimizeAway(context->light_cache);
+    });
+}
+
+static void ProgPowEpochContextBuildFirst(benchmark::Bench& bench) { ProgPowEpochContextBuild(bench, 0); }
+// An epoch in the scaled range that recent mainnet blocks use.
+static void ProgPowEpochContextBuildScaled(benchmark::Bench& bench) { ProgPowEpochContextBuild(bench, 200); }
+
+static void ScryptGeneric(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    auto data{RandomHeaderBytes(rng)};
+    std::vector<char> scratchpad(SCRYPT_SCRATCHPAD_SIZE);
+    char out[32];
+    bench.unit("header").run([&] {
+        ++data[76];
+        scrypt_1024_1_1_256_sp_generic(reinterpret_cast<const char*>(data.data()), out, scratchpad.data());
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+
+#if defined(USE_SSE2)
+static void ScryptSSE2(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    auto data{RandomHeaderBytes(rng)};
+    std::vector<char> scratchpad(SCRYPT_SCRATCHPAD_SIZE);
+    char out[32];
+    bench.unit("header").run([&] {
+        ++data[76];
+        scrypt_1024_1_1_256_sp_sse2(reinterpret_cast<const char*>(data.data()), out, scratchpad.data());
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+#endif
+
+BENCHMARK(KAWPOWOnlyMix, benchmark::PriorityLevel::HIGH);
+BENCHMARK(KAWPOWOnlyMixHex, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MEOWPOWOnlyMix, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MEOWPOWOnlyMixHex, benchmark::PriorityLevel::HIGH);
+BENCHMARK(X16RSingle, benchmark::PriorityLevel::HIGH);
+BENCHMARK(X16RV2Single, benchmark::PriorityLevel::HIGH);
+BENCHMARK(KAWPOWFull, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MEOWPOWFull, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ProgPowEpochContextBuildFirst, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ProgPowEpochContextBuildScaled, benchmark::PriorityLevel::LOW);
+BENCHMARK(ScryptGeneric, benchmark::PriorityLevel::HIGH);
+#if defined(USE_SSE2)
+BENCHMARK(ScryptSSE2, benchmark::PriorityLevel::HIGH);
+#endif
@@ -0,0 +1,38 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <assets/snapshotrequestdb.h>
+#include <bench/bench.h>
+#include <test/util/setup_common.h>
+#include <util/check.h>
+
+#include <set>
+#include <string>
+
+// Looking up the snapshot requests due at one block height while 100k
+// requests are pending, spread over 10k future heights.
+
+static void SnapshotRequestsForHeight(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    CSnapshotRequestDB requestdb(testing_setup->m_path_root, 8 << 20, /*fMemory=*/true);
+    constexpr int REQUESTS{100000};
+    constexpr int HEIGHTS{10000};
+    // Stored under the old keys and upgraded, as on an existing node.
+    for (int i = 0; i < REQUESTS; ++i) {
+        const CSnapshotRequestDBEntry request("ASSET" + std::to_string(i), 1000 + i % HEIGHTS);
+        requestdb.Write(std::make_pair(uint8_t{'S'}, request.heightAndName), request);
+    }
+    Assert(requestdb.UpgradeSnapshotRequestKeys());
+
+    std::set<CSnapshotRequestDBEntry> requests;
+    int height{1000};
+    bench.run([&] {
+        requestdb.RetrieveSnapshotRequestsForHeight("", height, requests);
+        assert(requests.size() == REQUESTS / HEIGHTS);
+        if (++height == 1000 + HEIGHTS) height = 1000;
+    });
+}
+
+BENCHMARK(SnapshotRequestsForHeight, benchmark::PriorityLevel::HIGH);
@@ -123,6 +123,17 @@ void CBlockIndex::BuildSkip()
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
 }
 
+void CBlockIndex::BuildSameAlgoLink(int64_t max_depth)
+{
+    pprevSameAlgo = nullptr;
+    for (CBlockIndex* pindex = pprev; pindex && nHeight - pindex->nHeight <= max_depth; pindex = pindex->pprev) {
+        if (pindex->nVersion.IsAuxpow() == nVersion.IsAuxpow()) {
+            pprevSameAlgo = pindex;
+            return;
+        }
+    }
+}
+
 arith_uint256 GetBlockProof(const CBlockIndex& block)
 {
     arith_uint256 bnTarget;
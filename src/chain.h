@@ -149,6 +149,10 @@ public:
     //! pointer to the index of some further predecessor of this block
     CBlockIndex* pskip{nullptr};
 
+    //! pointer to the nearest predecessor mined the same way (merge-mined or
+    //! natively), if it is within the LWMA search depth
+    CBlockIndex* pprevSameAlgo{nullptr};
+
     //! height of the entry in the chain. The genesis block has height 0
     int nHeight{0};
 
@@ -332,6 +336,9 @@ public:
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
+    //! Build pprevSameAlgo, looking back at most max_depth blocks.
+    void BuildSameAlgoLink(int64_t max_depth);
+
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
@@ -4,6 +4,7 @@
 
 #include <coins.h>
 
+#include <assets/assettypes.h>
 #include <consensus/consensus.h>
 #include <logging.h>
 #include <random.h>
@@ -13,6 +14,18 @@ TRACEPOINT_SEMAPHORE(utxocache, add);
 TRACEPOINT_SEMAPHORE(utxocache, spent);
 TRACEPOINT_SEMAPHORE(utxocache, uncache);
 
+size_t Coin::DynamicMemoryUsage() const
+{
+    size_t usage{memusage::DynamicUsage(out.scriptPubKey)};
+    if (out.scriptPubKey.IsAssetScript()) {
+        // The decoded payload in m_asset_output: one shared allocation, plus
+        // its strings, which are no longer than the script they come from.
+        usage += memusage::MallocUsage(sizeof(CAssetOutputEntry)) + memusage::MallocUsage(sizeof(memusage::stl_shared_counter)) +
+                 memusage::MallocUsage(out.scriptPubKey.size());
+    }
+    return usage;
+}
+
 std::optional<Coin> CCoinsView::GetCoin(const COutPoint& outpoint) const { return std::nullopt; }
 uint256 CCoinsView::GetBestBlock() const { return uint256(); }
 std::vector<uint256> CCoinsView::GetHeadBlocks() const { return std::vector<uint256>(); }
@@ -20,8 +20,11 @@
 #include <cstdint>
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
 
+struct CAssetOutputEntry;
+
 /**
  * A UTXO entry.
  *
@@ -41,6 +44,12 @@ public:
     //! at which height this containing transaction was included in the active block chain
     uint32_t nHeight : 31;
 
+    //! asset payload of out.scriptPubKey, decoded on first use by GetAssetOutput()
+    //! and shared by copies of this coin. Not serialized. DynamicMemoryUsage()
+    //! counts it for every asset output, filled or not, so cache accounting
+    //! does not change when it is filled.
+    mutable std::shared_ptr<const CAssetOutputEntry> m_asset_output;
+
     //! construct a Coin from a CTxOut and height/coinbase information.
     Coin(CTxOut&& outIn, int nHeightIn, bool fCoinBaseIn) : out(std::move(outIn)), fCoinBase(fCoinBaseIn), nHeight(nHeightIn) {}
     Coin(const CTxOut& outIn, int nHeightIn, bool fCoinBaseIn) : out(outIn), fCoinBase(fCoinBaseIn),nHeight(nHeightIn) {}
@@ -49,6 +58,7 @@ public:
         out.SetNull();
         fCoinBase = false;
         nHeight = 0;
+        m_asset_output.reset();
     }
 
     //! empty constructor
@@ -73,6 +83,7 @@ public:
         nHeight = code >> 1;
         fCoinBase = code & 1;
         ::Unserialize(s, Using<TxOutCompression>(out));
+        m_asset_output.reset();
     }
 
     /** Either this coin never existed (see e.g. coinEmpty in coins.cpp), or it
@@ -82,9 +93,7 @@ public:
         return out.IsNull();
     }
 
-    size_t DynamicMemoryUsage() const {
-        return memusage::DynamicUsage(out.scriptPubKey);
-    }
+    size_t DynamicMemoryUsage() const;
 };
 
 struct CCoinsCacheEntry;
@@ -142,6 +142,8 @@ struct Params {
 
     /** Meowcoin: LWMA averaging window (typically 45). */
     int64_t nLwmaAveragingWindow{45};
+    /** Meowcoin: how far back LWMA looks for same-algo blocks. */
+    int64_t LwmaSearchDepth() const { return nLwmaAveragingWindow * 10; }
 
     std::chrono::seconds PowTargetSpacing() const
     {
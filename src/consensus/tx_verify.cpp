@@ -4,6 +4,7 @@
 
 #include <consensus/tx_verify.h>
 
+#include <assets/assetnames.h>
 #include <assets/assets.h>
 #include <assets/assettypes.h>
 #include <assets/messages.h>
@@ -22,6 +23,12 @@
 #include <util/moneystr.h>
 #include <util/time.h>
 
+#include <functional>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
 bool IsFinalTx(const CTransaction &tx, int nBlockHeight, int64_t nBlockTime)
 {
     if (tx.nLockTime == 0)
@@ -227,8 +234,13 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, TxValidationState& state,
                              strprintf("%s: inputs missing/spent", __func__));
     }
 
-    std::map<std::string, CAmount> totalInputs;
-    std::map<std::string, std::string> mapAddresses;
+    // Asset totals are keyed by interned id. Names that are not interned,
+    // which only mempool coins can have (see GetAssetOutput), are totalled
+    // by name instead.
+    std::unordered_map<AssetId, CAmount> totalInputs;
+    std::map<std::string, CAmount, std::less<>> unownedInputs;
+    // Input destinations by asset, kept decoded: only message outputs compare against them
+    std::unordered_map<AssetId, CTxDestination> mapAddresses;
 
     for (unsigned int i = 0; i < tx.vin.size(); ++i) {
         const COutPoint &prevout = tx.vin[i].prevout;
@@ -236,26 +248,22 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, TxValidationState& state,
         assert(!coin.IsSpent());
 
         if (coin.out.scriptPubKey.IsAssetScript()) {
-            CAssetOutputEntry data;
-            if (!GetAssetData(coin.out.scriptPubKey, data))
+            const CAssetOutputEntry* asset_output = GetAssetOutput(coin);
+            if (!asset_output)
                 return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-failed-to-get-asset-from-script");
+            const CAssetOutputEntry& data = *asset_output;
 
+            CAmount& total = data.assetId != NULL_ASSET_ID ? totalInputs[data.assetId] : unownedInputs[data.assetName];
             if (nSpendHeight >= ::Params().GetConsensus().nAssetTransferOverflowFixHeight) {
                 if (!MoneyRange(data.nAmount))
                     return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-asset-input-amount-out-of-range");
-                CAmount current = totalInputs[data.assetName];
-                if (data.nAmount > MAX_MONEY - current)
+                if (data.nAmount > MAX_MONEY - total)
                     return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-asset-inputs-amount-overflow");
-                totalInputs[data.assetName] = current + data.nAmount;
-            } else {
-                if (totalInputs.count(data.assetName))
-                    totalInputs.at(data.assetName) += data.nAmount;
-                else
-                    totalInputs.insert(make_pair(data.assetName, data.nAmount));
             }
+            total += data.nAmount;
 
-            if (AreMessagesDeployed()) {
-                mapAddresses.insert(make_pair(data.assetName, EncodeDestination(data.destination)));
+            if (AreMessagesDeployed() && data.assetId != NULL_ASSET_ID) {
+                mapAddresses.insert(std::make_pair(data.assetId, data.destination));
             }
 
             if (IsAssetNameAnRestricted(data.assetName)) {
@@ -266,7 +274,8 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, TxValidationState& state,
         }
     }
 
-    std::map<std::string, CAmount> totalOutputs;
+    std::unordered_map<AssetId, CAmount> totalOutputs;
+    std::map<std::string, CAmount, std::less<>> unownedOutputs;
     int index = 0;
     int64_t currentTime = TicksSinceEpoch<std::chrono::seconds>(NodeClock::now());
     std::string strError = "";
@@ -310,19 +319,16 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, TxValidationState& state,
             if (!ContextualCheckTransferAsset(assetCache, transfer, address, strError))
                 return state.Invalid(TxValidationResult::TX_CONSENSUS, strError);
 
+            // Names that are not interned are totalled by name, like inputs.
+            const std::optional<AssetId> transferId = AssetNames().Find(transfer.strName);
+            CAmount& total = transferId ? totalOutputs[*transferId] : unownedOutputs[transfer.strName];
             if (nSpendHeight >= ::Params().GetConsensus().nAssetTransferOverflowFixHeight) {
                 if (!MoneyRange(transfer.nAmount))
                     return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-asset-transfer-amount-out-of-range");
-                CAmount current = totalOutputs[transfer.strName];
-                if (transfer.nAmount > MAX_MONEY - current)
+                if (transfer.nAmount > MAX_MONEY - total)
                     return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-txns-asset-outputs-amount-overflow");
-                totalOutputs[transfer.strName] = current + transfer.nAmount;
-            } else {
-                if (totalOutputs.count(transfer.strName))
-                    totalOutputs.at(transfer.strName) += transfer.nAmount;
-                else
-                    totalOutputs.insert(make_pair(transfer.strName, transfer.nAmount));
             }
+            total += transfer.nAmount;
 
             if (!fRunningUnitTests) {
                 if (IsAssetNameAnOwner(transfer.strName)) {
@@ -345,8 +351,8 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, TxValidationState& state,
                 if (IsAssetNameAnOwner(transfer.strName) || IsAssetNameAnMsgChannel(transfer.strName)) {
                     if (!transfer.message.empty()) {
                         if (transfer.nExpireTime == 0 || transfer.nExpireTime > currentTime) {
-                            if (mapAddresses.count(transfer.strName)) {
-                                if (mapAddresses.at(transfer.strName) == address) {
+                            if (transferId && mapAddresses.count(*transferId)) {
+                                if (mapAddresses.at(*transferId) == DecodeDestination(address)) {
                                     COutPoint out(tx.GetHash(), index);
                                     CMessage message(out, transfer.strName, transfer.message,
                                                      transfer.nExpireTime, nBlocktime);
@@ -528,18 +534,33 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, TxValidationState& state,
         }
     }
 
-    for (const auto& outValue : totalOutputs) {
-        if (!totalInputs.count(outValue.first)) {
-            std::string errorMsg = strprintf("Bad Transaction - Trying to create outpoint for asset that you don't have: %s", outValue.first);
+    // Check the output totals in asset name order, so the reported mismatch
+    // does not depend on hash order or on the order names were interned in.
+    std::map<std::string_view, std::optional<AssetId>> outputAssets;
+    for (const auto& [name, amount] : unownedOutputs) {
+        outputAssets.emplace(name, std::nullopt);
+    }
+    for (const auto& [id, amount] : totalOutputs) {
+        outputAssets.emplace(AssetNames().Name(id), id);
+    }
+    for (const auto& [name, id] : outputAssets) {
+        const CAmount* input{nullptr};
+        if (id) {
+            if (const auto it{totalInputs.find(*id)}; it != totalInputs.end()) input = &it->second;
+        } else if (const auto it{unownedInputs.find(name)}; it != unownedInputs.end()) {
+            input = &it->second;
+        }
+        if (!input) {
+            std::string errorMsg = strprintf("Bad Transaction - Trying to create outpoint for asset that you don't have: %s", name);
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-tx-inputs-outputs-mismatch " + errorMsg);
         }
-        if (totalInputs.at(outValue.first) != outValue.second) {
-            std::string errorMsg = strprintf("Bad Transaction - Assets would be burnt %s", outValue.first);
+        if (*input != (id ? totalOutputs.at(*id) : unownedOutputs.find(name)->second)) {
+            std::string errorMsg = strprintf("Bad Transaction - Assets would be burnt %s", name);
             return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-tx-inputs-outputs-mismatch " + errorMsg);
         }
     }
 
-    if (totalOutputs.size() != totalInputs.size()) {
+    if (totalOutputs.size() + unownedOutputs.size() != totalInputs.size() + unownedInputs.size()) {
         return state.Invalid(TxValidationResult::TX_CONSENSUS, "bad-tx-asset-inputs-size-does-not-match-outputs-size");
     }
 
@@ -5,7 +5,9 @@
 
 #include <index/addressindex.h>
 
+#include <algorithm>
 #include <cstring>
+#include <set>
 
 #include <addressindex.h>
 #include <assets/assets.h>
@@ -13,12 +15,29 @@
 #include <hash.h>
 #include <interfaces/chain.h>
 #include <logging.h>
+#include <memusage.h>
 #include <node/blockstorage.h>
 #include <script/script.h>
 #include <undo.h>
+#include <util/thread.h>
 
 constexpr uint8_t DB_ADDRESSINDEX{'a'};
 constexpr uint8_t DB_ADDRESSUNSPENTINDEX{'u'};
+constexpr uint8_t DB_ADDRESSBALANCE{'b'};
+constexpr uint8_t DB_ADDRESSBALANCE_COMMIT{'c'};
+constexpr uint8_t DB_ADDRESSDELTA{'d'};
+constexpr uint8_t DB_ADDRESSUTXO{'o'};
+constexpr uint8_t DB_ADDRESSTX{'t'};
+constexpr uint8_t DB_ADDRESSASSETID{'n'};
+constexpr uint8_t DB_ADDRESSINDEX_VERSION{'V'};
+
+//! Version of the delta and unspent keys; 1 was CAddressIndexKey and CAddressUnspentKey
+static const int ADDRESSINDEX_VERSION = 2;
+
+//! Flush the balances built from existing deltas every this many bytes
+static const size_t ADDRESSBALANCE_BATCH_SIZE = 16 << 20;
+//! Convert this many bytes of version 1 keys at a time, blocking index updates meanwhile
+static const size_t ADDRESSINDEX_UPGRADE_BATCH_SIZE = 4 << 20;
 
 std::unique_ptr<AddressIndex> g_addressindex;
 
@@ -101,109 +120,550 @@ public:
         : BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "addressindex",
                         n_cache_size, f_memory, f_wipe) {}
 
+    bool LoadAssetIds() EXCLUSIVE_LOCKS_REQUIRED(!m_asset_mutex)
+    {
+        LOCK(m_asset_mutex);
+        m_asset_ids.clear();
+        m_asset_names.assign(1, MEWC);
+
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        pcursor->Seek(DB_ADDRESSASSETID);
+        while (pcursor->Valid()) {
+            std::pair<uint8_t, std::string> key;
+            if (!pcursor->GetKey(key) || key.first != DB_ADDRESSASSETID) break;
+            uint32_t id;
+            if (!pcursor->GetValue(id) || id == 0) {
+                LogPrintf("%s: failed to get address index asset id\n", __func__);
+                return false;
+            }
+            if (m_asset_names.size() <= id) m_asset_names.resize(id + 1);
+            m_asset_names[id] = key.second;
+            m_asset_ids.emplace(key.second, id);
+            pcursor->Next();
+        }
+        return true;
+    }
+
+    std::optional<uint32_t> FindAssetId(const std::string& assetName) EXCLUSIVE_LOCKS_REQUIRED(!m_asset_mutex)
+    {
+        if (assetName == MEWC) return 0;
+        LOCK(m_asset_mutex);
+        const auto it = m_asset_ids.find(assetName);
+        if (it == m_asset_ids.end()) return std::nullopt;
+        return it->second;
+    }
+
+    // Return the id of assetName, storing the next free one if it has none yet.
+    // The id is written on its own, ahead of the batch that uses it. An id
+    // left behind by a crash before that batch is harmless: it is loaded again
+    // on restart and reused for the same asset.
+    std::optional<uint32_t> InternAssetId(const std::string& assetName) EXCLUSIVE_LOCKS_REQUIRED(!m_asset_mutex)
+    {
+        if (const auto id = FindAssetId(assetName)) return id;
+        LOCK(m_asset_mutex);
+        // Another thread may have stored it between the two locks.
+        if (const auto it = m_asset_ids.find(assetName); it != m_asset_ids.end()) return it->second;
+        const uint32_t id = m_asset_names.size();
+        CDBBatch batch(*this);
+        batch.Write(std::make_pair(DB_ADDRESSASSETID, assetName), id);
+        if (!WriteBatch(batch)) return std::nullopt;
+        m_asset_names.push_back(assetName);
+        m_asset_ids.emplace(assetName, id);
+        return id;
+    }
+
+    bool GetAssetName(uint32_t id, std::string& assetName) EXCLUSIVE_LOCKS_REQUIRED(!m_asset_mutex)
+    {
+        LOCK(m_asset_mutex);
+        if (id >= m_asset_names.size() || (id > 0 && m_asset_names[id].empty())) return false;
+        assetName = m_asset_names[id];
+        return true;
+    }
+
+    // Add a delta, and the txid it refers to, to batch.
+    bool WriteAddressDelta(CDBBatch& batch, const CAddressIndexKey& key, CAmount nValue)
+    {
+        const auto id = InternAssetId(key.asset);
+        if (!id) return false;
+        batch.Write(std::make_pair(DB_ADDRESSDELTA, CAddressIndexCompactKey(key, *id)), nValue);
+        batch.Write(std::make_pair(DB_ADDRESSTX, CAddressIndexTxKey(key.blockHeight, key.txindex)), key.txhash);
+        return true;
+    }
+
+    bool WriteAddressUnspent(CDBBatch& batch, const CAddressUnspentKey& key, const CAddressUnspentValue& value)
+    {
+        const auto id = InternAssetId(key.asset);
+        if (!id) return false;
+        batch.Write(std::make_pair(DB_ADDRESSUTXO, CAddressUnspentCompactKey(key, *id)), value);
+        return true;
+    }
+
     bool WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount>>& vect)
     {
         CDBBatch batch(*this);
-        for (const auto& it : vect)
-            batch.Write(std::make_pair(DB_ADDRESSINDEX, it.first), it.second);
+        for (const auto& it : vect) {
+            if (!WriteAddressDelta(batch, it.first, it.second)) return false;
+        }
         return WriteBatch(batch);
     }
 
-    bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount>>& vect)
+    // Erase deltas; while upgrading they may still be in the version 1 format.
+    bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount>>& vect, bool legacy)
     {
         CDBBatch batch(*this);
-        for (const auto& it : vect)
-            batch.Erase(std::make_pair(DB_ADDRESSINDEX, it.first));
+        for (const auto& it : vect) {
+            if (const auto id = FindAssetId(it.first.asset))
+                batch.Erase(std::make_pair(DB_ADDRESSDELTA, CAddressIndexCompactKey(it.first, *id)));
+            batch.Erase(std::make_pair(DB_ADDRESSTX, CAddressIndexTxKey(it.first.blockHeight, it.first.txindex)));
+            if (legacy)
+                batch.Erase(std::make_pair(DB_ADDRESSINDEX, it.first));
+        }
         return WriteBatch(batch);
     }
 
-    bool UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& vect)
+    bool UpdateAddressUnspentIndex(const std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& vect, bool legacy)
     {
         CDBBatch batch(*this);
         for (const auto& it : vect) {
-            if (it.second.IsNull())
-                batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, it.first));
-            else
-                batch.Write(std::make_pair(DB_ADDRESSUNSPENTINDEX, it.first), it.second);
+            if (it.second.IsNull()) {
+                if (const auto id = FindAssetId(it.first.asset))
+                    batch.Erase(std::make_pair(DB_ADDRESSUTXO, CAddressUnspentCompactKey(it.first, *id)));
+                if (legacy)
+                    batch.Erase(std::make_pair(DB_ADDRESSUNSPENTINDEX, it.first));
+            } else if (!WriteAddressUnspent(batch, it.first, it.second)) {
+                return false;
+            }
         }
         return WriteBatch(batch);
     }
 
-    bool ReadAddressIndex(uint256 addressHash, int type, std::string assetName,
-                          std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
-                          int start, int end)
+    bool HasLegacyKeys()
+    {
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        for (const uint8_t prefix : {DB_ADDRESSINDEX, DB_ADDRESSUNSPENTINDEX}) {
+            pcursor->Seek(prefix);
+            uint8_t key;
+            if (pcursor->Valid() && pcursor->GetKey(key) && key == prefix) return true;
+        }
+        return false;
+    }
+
+    // Convert up to ADDRESSINDEX_UPGRADE_BATCH_SIZE bytes of version 1 keys
+    // with this prefix, starting after last. done is set once none are left.
+    template <typename Key, typename Value, typename Convert>
+    bool UpgradeLegacyKeys(uint8_t prefix, std::optional<Key>& last, bool& done, size_t& count, Convert&& convert)
     {
         std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        if (last)
+            pcursor->Seek(std::make_pair(prefix, *last));
+        else
+            pcursor->Seek(prefix);
+
+        CDBBatch batch(*this);
+        done = true;
+        while (pcursor->Valid()) {
+            std::pair<uint8_t, Key> key;
+            if (!pcursor->GetKey(key) || key.first != prefix) break;
+            if (batch.ApproximateSize() > ADDRESSINDEX_UPGRADE_BATCH_SIZE) {
+                done = false;
+                break;
+            }
+            Value value;
+            if (!pcursor->GetValue(value)) {
+                LogPrintf("%s: failed to get address index value\n", __func__);
+                return false;
+            }
+            if (!convert(batch, key.second, value)) return false;
+            batch.Erase(key);
+            last = key.second;
+            count++;
+            pcursor->Next();
+        }
+        return WriteBatch(batch);
+    }
+
+    bool ForEachAddressDelta(uint256 addressHash, int type, const std::string& assetName, int start, int end,
+                             const CAddressIndexKey* after, const AddressIndex::DeltaFn& fn)
+    {
+        std::optional<uint32_t> assetId;
+        if (!assetName.empty()) {
+            assetId = FindAssetId(assetName);
+            // Never seen at any address
+            if (!assetId) return true;
+        }
 
-        if (!assetName.empty() && start > 0)
-            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, assetName, start)));
-        else if (!assetName.empty())
-            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorAssetKey(type, addressHash, assetName)));
-        else if (start > 0)
-            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, start)));
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
+        // Taken after pcursor, so it has the txids of all of its deltas.
+        std::unique_ptr<CDBIterator> ptxcursor(NewIterator());
+
+        if (after) {
+            const auto afterId = FindAssetId(after->asset);
+            if (!afterId) return true;
+            const CAddressIndexCompactKey afterKey(*after, *afterId);
+            pcursor->Seek(std::make_pair(DB_ADDRESSDELTA, afterKey));
+            std::pair<uint8_t, CAddressIndexCompactKey> key;
+            if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSDELTA && key.second == afterKey)
+                pcursor->Next();
+        } else if (assetId && start > 0)
+            pcursor->Seek(std::make_pair(DB_ADDRESSDELTA, CAddressIndexCompactIteratorKey(type, addressHash, assetId, start)));
         else
-            pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorKey(type, addressHash)));
+            pcursor->Seek(std::make_pair(DB_ADDRESSDELTA, CAddressIndexCompactIteratorKey(type, addressHash, assetId)));
 
+        CAddressIndexTxKey lastTx(-1, 0);
+        uint256 txhash;
         while (pcursor->Valid()) {
+            std::pair<uint8_t, CAddressIndexCompactKey> key;
+            if (!pcursor->GetKey(key) || key.first != DB_ADDRESSDELTA || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash) break;
+            if (assetId && key.second.assetId != *assetId) break;
+            if ((start > 0 && key.second.blockHeight < start) || (end > 0 && key.second.blockHeight > end)) {
+                // The heights of each asset are a separate range.
+                if (assetId) break;
+                pcursor->Next();
+                continue;
+            }
+            CAmount nValue;
+            if (!pcursor->GetValue(nValue)) {
+                LogPrintf("%s: failed to get address index value\n", __func__);
+                return false;
+            }
+            const CAddressIndexTxKey txKey(key.second.blockHeight, key.second.txindex);
+            if (txKey.blockHeight != lastTx.blockHeight || txKey.txindex != lastTx.txindex) {
+                ptxcursor->Seek(std::make_pair(DB_ADDRESSTX, txKey));
+                std::pair<uint8_t, CAddressIndexTxKey> foundKey;
+                if (!ptxcursor->Valid() || !ptxcursor->GetKey(foundKey) || foundKey.first != DB_ADDRESSTX ||
+                    foundKey.second.blockHeight != txKey.blockHeight || foundKey.second.txindex != txKey.txindex ||
+                    !ptxcursor->GetValue(txhash)) {
+                    LogPrintf("%s: failed to get address index txid\n", __func__);
+                    return false;
+                }
+                lastTx = txKey;
+            }
+            std::string keyAsset;
+            if (!GetAssetName(key.second.assetId, keyAsset)) {
+                LogPrintf("%s: unknown address index asset id %u\n", __func__, key.second.assetId);
+                return false;
+            }
+            const CAddressIndexKey delta(type, addressHash, keyAsset, key.second.blockHeight, key.second.txindex,
+                                         txhash, key.second.index, key.second.spending);
+            if (!fn(delta, nValue)) break;
+            pcursor->Next();
+        }
+        return true;
+    }
+
+    // Compute the balances of an index created before they were kept, from
+    // the deltas of blocks up to height. Deltas of later blocks may already be
+    // on disk, but those blocks are appended again after startup. pcursor is
+    // a snapshot taken at startup, so blocks removed since are still counted,
+    // as their removal is among the changes to commit.
+    bool BuildAddressBalances(int height, CDBIterator* pcursor, const std::atomic<bool>& interrupt)
+    {
+        LogPrintf("Building address balances from the address index up to height %d in the background\n", height);
+        pcursor->Seek(DB_ADDRESSINDEX);
+
+        CDBBatch batch(*this);
+        CAddressIndexIteratorAssetKey current;
+        CAddressBalance balance;
+        uint256 lastTx;
+        size_t count = 0;
+        const auto write_current = [&] {
+            // A build that was interrupted may have left one behind.
+            if (balance.IsNull()) {
+                batch.Erase(std::make_pair(DB_ADDRESSBALANCE, current));
+                return;
+            }
+            batch.Write(std::make_pair(DB_ADDRESSBALANCE, current), balance);
+            count++;
+        };
+
+        while (pcursor->Valid()) {
+            if (interrupt) return false;
             std::pair<uint8_t, CAddressIndexKey> key;
-            if (pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.hashBytes == addressHash) {
-                if (!assetName.empty() && key.second.asset != assetName) break;
-                if (end > 0 && key.second.blockHeight > end) break;
+            if (!pcursor->GetKey(key) || key.first != DB_ADDRESSINDEX) break;
+            if (key.second.blockHeight <= height) {
+                if (key.second.type != current.type || key.second.hashBytes != current.hashBytes || key.second.asset != current.asset) {
+                    write_current();
+                    current = CAddressIndexIteratorAssetKey(key.second.type, key.second.hashBytes, key.second.asset);
+                    balance.SetNull();
+                    lastTx.SetNull();
+                    if (batch.ApproximateSize() > ADDRESSBALANCE_BATCH_SIZE) {
+                        if (!WriteBatch(batch)) return false;
+                        batch.Clear();
+                        LogPrintf("Building address balances: %u written\n", count);
+                    }
+                }
                 CAmount nValue;
-                if (pcursor->GetValue(nValue)) {
-                    addressIndex.push_back({key.second, nValue});
-                    pcursor->Next();
-                } else {
+                if (!pcursor->GetValue(nValue)) {
                     LogPrintf("%s: failed to get address index value\n", __func__);
                     return false;
                 }
-            } else {
-                break;
+                balance.balance += nValue;
+                if (nValue > 0) balance.received += nValue;
+                // The deltas of one transaction are next to each other.
+                if (key.second.txhash != lastTx) balance.txCount++;
+                lastTx = key.second.txhash;
             }
+            pcursor->Next();
         }
+        write_current();
+        batch.Write(DB_ADDRESSBALANCE_COMMIT, uint64_t{0});
+        if (!WriteBatch(batch)) return false;
+        LogPrintf("Built %u address balances from the address index\n", count);
         return true;
     }
 
-    bool ReadAddressUnspentIndex(uint256 addressHash, int type, std::string assetName,
-                                 std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& vect)
+    bool ForEachAddressUnspent(uint256 addressHash, int type, const std::string& assetName,
+                               const CAddressUnspentKey* after, const AddressIndex::UnspentFn& fn)
     {
+        std::optional<uint32_t> assetId;
+        if (!assetName.empty()) {
+            assetId = FindAssetId(assetName);
+            if (!assetId) return true;
+        }
+
         std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
-        if (assetName.empty())
-            pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorKey(type, addressHash)));
-        else
-            pcursor->Seek(std::make_pair(DB_ADDRESSUNSPENTINDEX, CAddressIndexIteratorAssetKey(type, addressHash, assetName)));
+        if (after) {
+            const auto afterId = FindAssetId(after->asset);
+            if (!afterId) return true;
+            const CAddressUnspentCompactKey afterKey(*after, *afterId);
+            pcursor->Seek(std::make_pair(DB_ADDRESSUTXO, afterKey));
+            std::pair<uint8_t, CAddressUnspentCompactKey> key;
+            if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSUTXO && key.second == afterKey)
+                pcursor->Next();
+        } else
+            pcursor->Seek(std::make_pair(DB_ADDRESSUTXO, CAddressIndexCompactIteratorKey(type, addressHash, assetId)));
 
         while (pcursor->Valid()) {
-            std::pair<uint8_t, CAddressUnspentKey> key;
-            if (pcursor->GetKey(key) && key.first == DB_ADDRESSUNSPENTINDEX && key.second.hashBytes == addressHash) {
-                if (!assetName.empty() && key.second.asset != assetName) break;
-                CAddressUnspentValue nValue;
-                if (pcursor->GetValue(nValue)) {
-                    vect.push_back({key.second, nValue});
-                    pcursor->Next();
-                } else {
-                    LogPrintf("%s: failed to get address unspent value\n", __func__);
-                    return false;
-                }
-            } else {
-                break;
+            std::pair<uint8_t, CAddressUnspentCompactKey> key;
+            if (!pcursor->GetKey(key) || key.first != DB_ADDRESSUTXO || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash) break;
+            if (assetId && key.second.assetId != *assetId) break;
+            CAddressUnspentValue nValue;
+            if (!pcursor->GetValue(nValue)) {
+                LogPrintf("%s: failed to get address unspent value\n", __func__);
+                return false;
+            }
+            std::string keyAsset;
+            if (!GetAssetName(key.second.assetId, keyAsset)) {
+                LogPrintf("%s: unknown address index asset id %u\n", __func__, key.second.assetId);
+                return false;
             }
+            if (!fn(CAddressUnspentKey(type, addressHash, keyAsset, key.second.txhash, key.second.index), nValue)) break;
+            pcursor->Next();
         }
         return true;
     }
+
+private:
+    Mutex m_asset_mutex;
+    //! Ids of the assets in the keys, by name. MEWC is 0 and not stored.
+    std::map<std::string, uint32_t> m_asset_ids GUARDED_BY(m_asset_mutex);
+    std::vector<std::string> m_asset_names GUARDED_BY(m_asset_mutex);
 };
 
 // ---------------------------------------------------------------------------
 // AddressIndex
 // ---------------------------------------------------------------------------
 AddressIndex::AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
-                           bool f_memory, bool f_wipe)
+                           bool f_memory, bool f_wipe, size_t n_batch_size)
     : BaseIndex(std::move(chain), "addressindex"),
-      m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe))
+      m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe)),
+      m_batch_size(n_batch_size)
 {}
 
-AddressIndex::~AddressIndex() = default;
+AddressIndex::~AddressIndex()
+{
+    m_upgrade_interrupt = true;
+    if (m_upgrade_thread.joinable()) m_upgrade_thread.join();
+}
+
+void AddressIndex::AddBalanceDeltas(const std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex, int sign, BalanceMap& balances)
+{
+    // The deltas of one transaction are next to each other; count it once per
+    // address and asset.
+    std::set<BalanceKey> seen;
+    uint256 lastTx;
+    for (const auto& [key, nValue] : addressIndex) {
+        if (key.txhash != lastTx) seen.clear();
+        lastTx = key.txhash;
+
+        BalanceKey balanceKey{key.type, key.hashBytes, key.asset};
+        CAddressBalance& balance = balances[balanceKey];
+        balance.balance += sign * nValue;
+        if (nValue > 0) balance.received += sign * nValue;
+        if (seen.insert(std::move(balanceKey)).second) balance.txCount += sign;
+    }
+}
+
+bool AddressIndex::InitBalances(const std::optional<interfaces::BlockRef>& block)
+{
+    LOCK(m_balance_mutex);
+    if (m_db->Read(DB_ADDRESSBALANCE_COMMIT, m_balance_commit)) return true;
+    if (m_db->Exists(DB_ADDRESSBALANCE_COMMIT)) {
+        LogError("Cannot read current %s balances; index may be corrupted", GetName());
+        return false;
+    }
+    // An empty index starts keeping balances with its first commit.
+    if (!block) return true;
+    m_building_balances = true;
+    m_balance_height = block->height;
+    m_balance_cursor.reset(m_db->NewIterator());
+    return true;
+}
+
+bool AddressIndex::CustomInit(const std::optional<interfaces::BlockRef>& block)
+{
+    if (!InitBalances(block)) return false;
+    if (!m_db->LoadAssetIds()) {
+        LogError("Cannot read %s asset ids; index may be corrupted", GetName());
+        return false;
+    }
+
+    int version{1};
+    if (!m_db->Read(DB_ADDRESSINDEX_VERSION, version) && !m_db->HasLegacyKeys()) {
+        version = ADDRESSINDEX_VERSION;
+        if (!m_db->Write(DB_ADDRESSINDEX_VERSION, version)) return false;
+    }
+    if (version > ADDRESSINDEX_VERSION) {
+        LogError("%s was written by a newer version (%d); rebuild it with -reindex", GetName(), version);
+        return false;
+    }
+    if (version < ADDRESSINDEX_VERSION) m_upgrading = true;
+    if (m_building_balances || m_upgrading) {
+        m_upgrade_thread = std::thread(&util::TraceThread, "addrupgrade", [this] {
+            // The balances are built from the version 1 keys, so the
+            // conversion only starts once they are on disk.
+            if (m_building_balances && !BuildBalances()) return;
+            if (m_upgrading) UpgradeKeys();
+        });
+    }
+    return true;
+}
+
+bool AddressIndex::BuildBalances()
+{
+    const bool built{m_db->BuildAddressBalances(m_balance_height, m_balance_cursor.get(), m_upgrade_interrupt)};
+    m_balance_cursor.reset();
+    if (!built) {
+        // Without the commit record the build starts over on the next startup.
+        if (!m_upgrade_interrupt) FatalErrorf("%s: failed to build %s balances", __func__, GetName());
+        return false;
+    }
+    m_building_balances = false;
+    return true;
+}
+
+void AddressIndex::UpgradeKeys()
+{
+    // Queries and commits keep checking the legacy keys while m_upgrading is
+    // set, so a chunk that fails to convert stops the node rather than leaving
+    // the index half upgraded until the next restart.
+    LogPrintf("Upgrading %s to version %d in the background\n", GetName(), ADDRESSINDEX_VERSION);
+    std::optional<CAddressIndexKey> lastDelta;
+    std::optional<CAddressUnspentKey> lastUnspent;
+    bool deltasDone{false};
+    size_t count{0};
+    int chunks{0};
+    while (!m_upgrade_interrupt) {
+        LOCK(m_upgrade_mutex);
+        bool done;
+        if (!deltasDone) {
+            if (!m_db->UpgradeLegacyKeys<CAddressIndexKey, CAmount>(DB_ADDRESSINDEX, lastDelta, done, count,
+                    [&](CDBBatch& batch, const CAddressIndexKey& key, CAmount value) { return m_db->WriteAddressDelta(batch, key, value); })) {
+                FatalErrorf("%s: failed to upgrade %s deltas", __func__, GetName());
+                return;
+            }
+            deltasDone = done;
+        } else {
+            if (!m_db->UpgradeLegacyKeys<CAddressUnspentKey, CAddressUnspentValue>(DB_ADDRESSUNSPENTINDEX, lastUnspent, done, count,
+                    [&](CDBBatch& batch, const CAddressUnspentKey& key, const CAddressUnspentValue& value) { return m_db->WriteAddressUnspent(batch, key, value); })) {
+                FatalErrorf("%s: failed to upgrade %s unspent outputs", __func__, GetName());
+                return;
+            }
+            if (done) {
+                if (!m_db->Write(DB_ADDRESSINDEX_VERSION, ADDRESSINDEX_VERSION)) {
+                    FatalErrorf("%s: failed to write %s version", __func__, GetName());
+                    return;
+                }
+                m_upgrading = false;
+                LogPrintf("Upgraded %s to version %d, converted %u keys\n", GetName(), ADDRESSINDEX_VERSION, count);
+                return;
+            }
+        }
+        if (++chunks % 100 == 0) LogPrintf("Upgrading %s: %u keys converted\n", GetName(), count);
+    }
+}
+
+bool AddressIndex::FlushBatch()
+{
+    if (m_batch_deltas.empty() && m_batch_unspent.empty()) return true;
+
+    // Sorted keys go into the database in order. Unspent entries of one output
+    // keep their order, so that a spend written after its creation wins.
+    std::sort(m_batch_deltas.begin(), m_batch_deltas.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::stable_sort(m_batch_unspent.begin(), m_batch_unspent.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    if (!m_db->WriteAddressIndex(m_batch_deltas)) {
+        LogError("%s: failed to write address index", __func__);
+        return false;
+    }
+    if (!m_db->UpdateAddressUnspentIndex(m_batch_unspent, m_upgrading)) {
+        LogError("%s: failed to update address unspent index", __func__);
+        return false;
+    }
+    // Release the memory too, as it counts against the next batch.
+    m_batch_deltas.clear();
+    m_batch_deltas.shrink_to_fit();
+    m_batch_unspent.clear();
+    m_batch_unspent.shrink_to_fit();
+    m_batch_usage = 0;
+    return true;
+}
+
+bool AddressIndex::CustomCommit(CDBBatch& batch)
+{
+    // The entries of the blocks up to the best block must be on disk before
+    // it is. BaseIndex carries on after a failed commit, which would leave
+    // them only in memory once the index is synced, so stop instead.
+    if (!WITH_LOCK(m_upgrade_mutex, return FlushBatch())) {
+        FatalErrorf("Failed to write the collected entries of %s", GetName());
+        return false;
+    }
+
+    // The balances on disk are those of the best block at startup until they
+    // are built, so it stays the best block on disk meanwhile, and the
+    // changes since are written by the first commit after the build.
+    if (m_building_balances) {
+        LogPrintf("%s: balances are still being built, not committing\n", GetName());
+        return false;
+    }
+
+    LOCK(m_balance_mutex);
+    uint64_t onDisk;
+    if (!m_committing_balances.empty() && (!m_db->Read(DB_ADDRESSBALANCE_COMMIT, onDisk) || onDisk < m_balance_commit)) {
+        // The last commit never reached the disk, so its changes are still pending.
+        for (const auto& [key, delta] : m_committing_balances) {
+            m_pending_balances[key] += delta;
+        }
+    }
+    m_committing_balances.clear();
+
+    for (const auto& [key, delta] : m_pending_balances) {
+        const auto dbKey = std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorAssetKey(std::get<0>(key), std::get<1>(key), std::get<2>(key)));
+        CAddressBalance balance;
+        m_db->Read(dbKey, balance);
+        balance += delta;
+        if (balance.IsNull())
+            batch.Erase(dbKey);
+        else
+            batch.Write(dbKey, balance);
+    }
+    batch.Write(DB_ADDRESSBALANCE_COMMIT, ++m_balance_commit);
+    m_committing_balances = std::move(m_pending_balances);
+    m_pending_balances.clear();
+    return true;
+}
 
 bool AddressIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
@@ -280,14 +740,34 @@ bool AddressIndex::CustomAppend(const interfaces::BlockInfo& block)
         }
     }
 
-    if (!m_db->WriteAddressIndex(addressIndex)) {
-        LogError("%s: failed to write address index", __func__);
-        return false;
-    }
-    if (!m_db->UpdateAddressUnspentIndex(addressUnspentIndex)) {
-        LogError("%s: failed to update address unspent index", __func__);
-        return false;
+    LOCK(m_upgrade_mutex);
+    if (m_batch_size > 0 && !IsSynced()) {
+        // Catching up: collect the entries and write many blocks at once.
+        for (const auto& entry : addressIndex) {
+            m_batch_usage += memusage::DynamicUsage(entry.first.asset);
+        }
+        for (const auto& entry : addressUnspentIndex) {
+            m_batch_usage += memusage::DynamicUsage(entry.first.asset) + memusage::DynamicUsage(entry.second.script);
+        }
+        m_batch_deltas.insert(m_batch_deltas.end(), addressIndex.begin(), addressIndex.end());
+        m_batch_unspent.insert(m_batch_unspent.end(), addressUnspentIndex.begin(), addressUnspentIndex.end());
+        // The vectors count by their capacity, which grows ahead of their size.
+        const size_t usage{m_batch_usage + memusage::DynamicUsage(m_batch_deltas) + memusage::DynamicUsage(m_batch_unspent)};
+        if (usage >= m_batch_size && !FlushBatch()) return false;
+    } else {
+        // A batch left behind by a failed commit at the end of the sync must
+        // reach the database before any entry that follows it.
+        if (!FlushBatch()) return false;
+        if (!m_db->WriteAddressIndex(addressIndex)) {
+            LogError("%s: failed to write address index", __func__);
+            return false;
+        }
+        if (!m_db->UpdateAddressUnspentIndex(addressUnspentIndex, m_upgrading)) {
+            LogError("%s: failed to update address unspent index", __func__);
+            return false;
+        }
     }
+    WITH_LOCK(m_balance_mutex, AddBalanceDeltas(addressIndex, 1, m_pending_balances));
     return true;
 }
 
@@ -366,14 +846,18 @@ bool AddressIndex::CustomRemove(const interfaces::BlockInfo& block)
         }
     }
 
-    if (!m_db->EraseAddressIndex(addressIndex)) {
+    LOCK(m_upgrade_mutex);
+    // Entries still collected may belong to the block being removed.
+    if (!FlushBatch()) return false;
+    if (!m_db->EraseAddressIndex(addressIndex, m_upgrading)) {
         LogError("%s: failed to erase address index", __func__);
         return false;
     }
-    if (!m_db->UpdateAddressUnspentIndex(addressUnspentIndex)) {
+    if (!m_db->UpdateAddressUnspentIndex(addressUnspentIndex, m_upgrading)) {
         LogError("%s: failed to update address unspent index", __func__);
         return false;
     }
+    WITH_LOCK(m_balance_mutex, AddBalanceDeltas(addressIndex, -1, m_pending_balances));
     return true;
 }
 
@@ -383,24 +867,107 @@ bool AddressIndex::ReadAddressIndex(uint256 addressHash, int type, std::string a
                                     std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
                                     int start, int end)
 {
-    return m_db->ReadAddressIndex(addressHash, type, assetName, addressIndex, start, end);
+    return m_db->ForEachAddressDelta(addressHash, type, assetName, start, end, nullptr, [&](const CAddressIndexKey& key, CAmount nValue) {
+        addressIndex.emplace_back(key, nValue);
+        return true;
+    });
 }
 
 bool AddressIndex::ReadAddressIndex(uint256 addressHash, int type,
                                     std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
                                     int start, int end)
 {
-    return m_db->ReadAddressIndex(addressHash, type, "", addressIndex, start, end);
+    return ReadAddressIndex(addressHash, type, "", addressIndex, start, end);
+}
+
+bool AddressIndex::ForEachAddressDelta(uint256 addressHash, int type, const std::string& assetName, int start, int end,
+                                       const CAddressIndexKey* after, const DeltaFn& fn)
+{
+    return m_db->ForEachAddressDelta(addressHash, type, assetName, start, end, after, fn);
 }
 
 bool AddressIndex::ReadAddressUnspentIndex(uint256 addressHash, int type, std::string assetName,
                                            std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs)
 {
-    return m_db->ReadAddressUnspentIndex(addressHash, type, assetName, unspentOutputs);
+    return m_db->ForEachAddressUnspent(addressHash, type, assetName, nullptr, [&](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+        unspentOutputs.emplace_back(key, value);
+        return true;
+    });
 }
 
 bool AddressIndex::ReadAddressUnspentIndex(uint256 addressHash, int type,
                                            std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs)
 {
-    return m_db->ReadAddressUnspentIndex(addressHash, type, "", unspentOutputs);
+    return ReadAddressUnspentIndex(addressHash, type, "", unspentOutputs);
+}
+
+bool AddressIndex::ForEachAddressUnspent(uint256 addressHash, int type, const std::string& assetName,
+                                         const CAddressUnspentKey* after, const UnspentFn& fn)
+{
+    return m_db->ForEachAddressUnspent(addressHash, type, assetName, after, fn);
+}
+
+bool AddressIndex::ReadAddressBalance(uint256 addressHash, int type, const std::string& assetName,
+                                      std::map<std::string, CAddressBalance>& balances)
+{
+    // Take the database snapshot and the changes that are not in it at the
+    // same time, so a concurrent commit is seen either entirely or not at all.
+    std::unique_ptr<CDBIterator> pcursor;
+    BalanceMap pending;
+    BalanceMap committing;
+    uint64_t committingSeq;
+    {
+        LOCK(m_balance_mutex);
+        pcursor.reset(m_db->NewIterator());
+        const auto copy_address = [&](const BalanceMap& from, BalanceMap& to) {
+            for (auto it = from.lower_bound(BalanceKey{(unsigned int)type, addressHash, assetName}); it != from.end(); ++it) {
+                const auto& [keyType, keyHash, keyAsset] = it->first;
+                if (keyType != (unsigned int)type || keyHash != addressHash) break;
+                if (!assetName.empty() && keyAsset != assetName) break;
+                to.emplace(*it);
+            }
+        };
+        copy_address(m_pending_balances, pending);
+        copy_address(m_committing_balances, committing);
+        committingSeq = m_balance_commit;
+    }
+
+    uint8_t commitKey;
+    uint64_t onDisk{0};
+    pcursor->Seek(DB_ADDRESSBALANCE_COMMIT);
+    if (pcursor->Valid() && pcursor->GetKey(commitKey) && commitKey == DB_ADDRESSBALANCE_COMMIT && !pcursor->GetValue(onDisk)) {
+        LogPrintf("%s: failed to get address balance commit\n", __func__);
+        return false;
+    }
+    if (onDisk >= committingSeq) committing.clear();
+
+    std::map<std::string, CAddressBalance> addressBalances;
+    if (assetName.empty())
+        pcursor->Seek(std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorKey(type, addressHash)));
+    else
+        pcursor->Seek(std::make_pair(DB_ADDRESSBALANCE, CAddressIndexIteratorAssetKey(type, addressHash, assetName)));
+
+    while (pcursor->Valid()) {
+        std::pair<uint8_t, CAddressIndexIteratorAssetKey> key;
+        if (!pcursor->GetKey(key) || key.first != DB_ADDRESSBALANCE || key.second.type != (unsigned int)type || key.second.hashBytes != addressHash) break;
+        if (!assetName.empty() && key.second.asset != assetName) break;
+        CAddressBalance balance;
+        if (!pcursor->GetValue(balance)) {
+            LogPrintf("%s: failed to get address balance value\n", __func__);
+            return false;
+        }
+        addressBalances[key.second.asset] += balance;
+        pcursor->Next();
+    }
+
+    for (const BalanceMap* overlay : {&committing, &pending}) {
+        for (const auto& [key, delta] : *overlay) {
+            addressBalances[std::get<2>(key)] += delta;
+        }
+    }
+    for (const auto& [asset, balance] : addressBalances) {
+        // Assets whose last deltas were disconnected
+        if (!balance.IsNull()) balances[asset] += balance;
+    }
+    return true;
 }
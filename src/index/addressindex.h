@@ -9,17 +9,51 @@
 #include <addressindex.h>
 #include <index/base.h>
 #include <primitives/transaction.h>
+#include <sync.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 static constexpr bool DEFAULT_ADDRESSINDEX{false};
+//! Default for -addressindexbatch, in MiB
+static constexpr int64_t DEFAULT_ADDRESSINDEX_BATCH{64};
 
 /**
  * AddressIndex maintains a full address index (balance, txids, UTXOs).
  *
- * The on-disk DB lives under indexes/addressindex/ and contains two key spaces:
- *   'a' (DB_ADDRESSINDEX)       — CAddressIndexKey   -> CAmount (all deltas)
- *   'u' (DB_ADDRESSUNSPENTINDEX)— CAddressUnspentKey -> CAddressUnspentValue
+ * The on-disk DB lives under indexes/addressindex/ and contains these key spaces:
+ *   'd' (DB_ADDRESSDELTA)       — CAddressIndexCompactKey   -> CAmount (all deltas)
+ *   't' (DB_ADDRESSTX)          — CAddressIndexTxKey        -> uint256, txid of the deltas' transaction
+ *   'o' (DB_ADDRESSUTXO)        — CAddressUnspentCompactKey -> CAddressUnspentValue
+ *   'n' (DB_ADDRESSASSETID)     — asset name -> uint32_t id used in the keys above (MEWC is 0)
+ *   'V' (DB_ADDRESSINDEX_VERSION) — int, version of the keys above
+ *   'b' (DB_ADDRESSBALANCE)     — CAddressIndexIteratorAssetKey -> CAddressBalance
+ *   'c' (DB_ADDRESSBALANCE_COMMIT) — uint64_t, sequence number of the last balance commit
+ *
+ * The balances are running totals of the deltas. Changes are collected in
+ * memory and written by CustomCommit() together with the best block, so
+ * replaying blocks after an unclean shutdown cannot count them twice.
+ *
+ * During the initial sync the entries of many blocks are collected in memory,
+ * up to -addressindexbatch MiB, and written in one sorted batch when that is
+ * full and before each commit, so the best block is never ahead of them.
+ *
+ * Indexes created before the balances were kept get them built from the
+ * deltas in the background on startup. Until that is done nothing is
+ * committed, so the best block on disk stays the one they are built for.
+ *
+ * Indexes written before version 2 keep their deltas as 'a' CAddressIndexKey
+ * and their unspent outputs as 'u' CAddressUnspentKey. Those are converted by
+ * a background thread while the index keeps following the chain; the deltas
+ * and unspent outputs cannot be read until it is done.
  */
-class AddressIndex final : public BaseIndex
+class AddressIndex : public BaseIndex
 {
 protected:
     class DB;
@@ -27,8 +61,48 @@ protected:
 private:
     const std::unique_ptr<DB> m_db;
 
+    //! (address type, address hash, asset name)
+    using BalanceKey = std::tuple<unsigned int, uint256, std::string>;
+    using BalanceMap = std::map<BalanceKey, CAddressBalance>;
+
+    Mutex m_balance_mutex;
+    //! Balance changes since the last commit
+    BalanceMap m_pending_balances GUARDED_BY(m_balance_mutex);
+    //! Changes of the last commit, until it is known to be on disk
+    BalanceMap m_committing_balances GUARDED_BY(m_balance_mutex);
+    uint64_t m_balance_commit GUARDED_BY(m_balance_mutex){0};
+
+    //! Held while version 1 keys are converted and while index entries are written or removed
+    Mutex m_upgrade_mutex;
+    std::atomic<bool> m_upgrading{false};
+    std::atomic<bool> m_upgrade_interrupt{false};
+    //! Builds the balances, then converts the version 1 keys
+    std::thread m_upgrade_thread;
+
+    //! Set while the balances of an index created before they were kept are built
+    std::atomic<bool> m_building_balances{false};
+    //! Height of the best block at startup, which the balances are built for
+    int m_balance_height{0};
+    //! Snapshot of the index at startup to build the balances from
+    std::unique_ptr<CDBIterator> m_balance_cursor;
+
+    //! Bytes of entries to collect during the initial sync before writing them; 0 to write every block
+    const size_t m_batch_size;
+    //! Entries of blocks appended during the initial sync that are not written yet
+    std::vector<std::pair<CAddressIndexKey, CAmount>> m_batch_deltas GUARDED_BY(m_upgrade_mutex);
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>> m_batch_unspent GUARDED_BY(m_upgrade_mutex);
+    //! Heap memory of the collected entries, not counting the vectors that hold them
+    size_t m_batch_usage GUARDED_BY(m_upgrade_mutex){0};
+
     bool AllowPrune() const override { return false; }
 
+    bool InitBalances(const std::optional<interfaces::BlockRef>& block) EXCLUSIVE_LOCKS_REQUIRED(!m_balance_mutex);
+    bool BuildBalances();
+    void UpgradeKeys() EXCLUSIVE_LOCKS_REQUIRED(!m_upgrade_mutex);
+    bool FlushBatch() EXCLUSIVE_LOCKS_REQUIRED(m_upgrade_mutex);
+
+    static void AddBalanceDeltas(const std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex, int sign, BalanceMap& balances);
+
 protected:
     interfaces::Chain::NotifyOptions CustomOptions() override
     {
@@ -37,16 +111,27 @@ protected:
                 .disconnect_undo_data = true};
     }
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
-    bool CustomRemove(const interfaces::BlockInfo& block) override;
+    bool CustomInit(const std::optional<interfaces::BlockRef>& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_balance_mutex);
+    bool CustomAppend(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_balance_mutex, !m_upgrade_mutex);
+    bool CustomCommit(CDBBatch& batch) override EXCLUSIVE_LOCKS_REQUIRED(!m_balance_mutex, !m_upgrade_mutex);
+    bool CustomRemove(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_balance_mutex, !m_upgrade_mutex);
 
     BaseIndex::DB& GetDB() const override;
 
 public:
+    /// Visitors of the index entries; returning false stops the iteration.
+    using DeltaFn = std::function<bool(const CAddressIndexKey&, CAmount)>;
+    using UnspentFn = std::function<bool(const CAddressUnspentKey&, const CAddressUnspentValue&)>;
+
     explicit AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
-                          bool f_memory = false, bool f_wipe = false);
+                          bool f_memory = false, bool f_wipe = false, size_t n_batch_size = 0);
     virtual ~AddressIndex() override;
 
+    /// Whether keys of an older version are still being converted, so deltas and unspent outputs cannot be read yet.
+    bool IsUpgrading() const { return m_upgrading; }
+    /// Whether the balances are still being built from the deltas, so they cannot be read yet.
+    bool IsBuildingBalances() const { return m_building_balances; }
+
     /// Read all deltas for an address (optionally filtered by asset and/or block range).
     bool ReadAddressIndex(uint256 addressHash, int type, std::string assetName,
                           std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
@@ -55,11 +140,24 @@ public:
                           std::vector<std::pair<CAddressIndexKey, CAmount>>& addressIndex,
                           int start = 0, int end = 0);
 
+    /// Visit the deltas of an address in key order, resuming after the key after if it is given.
+    bool ForEachAddressDelta(uint256 addressHash, int type, const std::string& assetName, int start, int end,
+                             const CAddressIndexKey* after, const DeltaFn& fn);
+
     /// Read unspent outputs for an address (optionally filtered by asset).
     bool ReadAddressUnspentIndex(uint256 addressHash, int type, std::string assetName,
                                  std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs);
     bool ReadAddressUnspentIndex(uint256 addressHash, int type,
                                  std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& unspentOutputs);
+
+    /// Visit the unspent outputs of an address in key order, resuming after the key after if it is given.
+    bool ForEachAddressUnspent(uint256 addressHash, int type, const std::string& assetName,
+                               const CAddressUnspentKey* after, const UnspentFn& fn);
+
+    /// Add the balances of an address to balances, by asset name (only assetName's if not empty).
+    bool ReadAddressBalance(uint256 addressHash, int type, const std::string& assetName,
+                            std::map<std::string, CAddressBalance>& balances)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_balance_mutex);
 };
 
 /// Global address index instance. Null when -addressindex is not enabled.
@@ -5,6 +5,7 @@
 #include <chainparams.h>
 #include <common/args.h>
 #include <index/base.h>
+#include <index/synccoordinator.h>
 #include <interfaces/chain.h>
 #include <kernel/chain.h>
 #include <logging.h>
@@ -33,10 +34,8 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
 
-template <typename... Args>
-void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
+void BaseIndex::FatalError(const std::string& message)
 {
-    auto message = tfm::format(fmt, args...);
     node::AbortNode(m_chain->context()->shutdown_request, m_chain->context()->exit_status, Untranslated(message), m_chain->context()->warnings.get());
 }
 
@@ -153,8 +152,16 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
 {
     interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, block_data);
 
+    // Block (and undo data) read once for all indexes syncing together
+    std::shared_ptr<const IndexSyncBlock> shared;
+    if (IndexSyncCoordinator* coordinator{m_sync_coordinator}; !block_data && coordinator) {
+        shared = coordinator->GetBlock(*this, *pindex);
+    }
+
     CBlock block;
-    if (!block_data) { // disk lookup if block data wasn't provided
+    if (shared) {
+        block_info.data = &shared->block;
+    } else if (!block_data) { // disk lookup if block data wasn't provided
         if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
             FatalErrorf("Failed to read block %s from disk",
                         pindex->GetBlockHash().ToString());
@@ -165,12 +172,16 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
 
     CBlockUndo block_undo;
     if (CustomOptions().connect_undo_data) {
-        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
-            FatalErrorf("Failed to read undo block data %s from disk",
-                        pindex->GetBlockHash().ToString());
-            return false;
+        if (shared && shared->undo) {
+            block_info.undo_data = &*shared->undo;
+        } else {
+            if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
+                FatalErrorf("Failed to read undo block data %s from disk",
+                            pindex->GetBlockHash().ToString());
+                return false;
+            }
+            block_info.undo_data = &block_undo;
         }
-        block_info.undo_data = &block_undo;
     }
 
     if (!CustomAppend(block_info)) {
@@ -435,13 +446,32 @@ bool BaseIndex::BlockUntilSyncedToCurrentChain() const
 void BaseIndex::Interrupt()
 {
     m_interrupt();
+    // Wake the sync thread if it is waiting for a block from the coordinator.
+    if (IndexSyncCoordinator* coordinator{m_sync_coordinator}) coordinator->Unregister(*this);
+}
+
+void BaseIndex::UseSyncCoordinator(IndexSyncCoordinator& coordinator)
+{
+    if (!m_init) throw std::logic_error("Error: Cannot start a non-initialized index");
+    if (m_synced) return;
+
+    const CBlockIndex* pindex_next = WITH_LOCK(cs_main, return NextSyncBlock(m_best_block_index.load(), m_chainstate->m_chain));
+    if (!pindex_next) return;
+    coordinator.Register(*this, pindex_next->nHeight, CustomOptions().connect_undo_data);
+    m_sync_coordinator = &coordinator;
 }
 
 bool BaseIndex::StartBackgroundSync()
 {
     if (!m_init) throw std::logic_error("Error: Cannot start a non-initialized index");
 
-    m_thread_sync = std::thread(&util::TraceThread, GetName(), [this] { Sync(); });
+    m_thread_sync = std::thread(&util::TraceThread, GetName(), [this] {
+        Sync();
+        // Let the other indexes go on without this one.
+        if (IndexSyncCoordinator* coordinator{m_sync_coordinator.exchange(nullptr)}) {
+            coordinator->Unregister(*this);
+        }
+    });
     return true;
 }
 
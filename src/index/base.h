@@ -8,6 +8,7 @@
 #include <dbwrapper.h>
 #include <interfaces/chain.h>
 #include <interfaces/types.h>
+#include <tinyformat.h>
 #include <util/string.h>
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
@@ -18,6 +19,7 @@ class CBlock;
 class CBlockIndex;
 class Chainstate;
 class ChainstateManager;
+class IndexSyncCoordinator;
 namespace interfaces {
 class Chain;
 } // namespace interfaces
@@ -80,6 +82,10 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Reads the blocks of the initial sync for this and other indexes, if set. Only
+    /// used by the sync thread, and by Interrupt() to wake it.
+    std::atomic<IndexSyncCoordinator*> m_sync_coordinator{nullptr};
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -97,14 +103,20 @@ private:
 
     virtual bool AllowPrune() const = 0;
 
-    template <typename... Args>
-    void FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args);
+    void FatalError(const std::string& message);
 
 protected:
     std::unique_ptr<interfaces::Chain> m_chain;
     Chainstate* m_chainstate{nullptr};
     const std::string m_name;
 
+    /// Stop the node after an error the index cannot recover from.
+    template <typename... Args>
+    void FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
+    {
+        FatalError(tfm::format(fmt, args...));
+    }
+
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override;
 
     void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override;
@@ -130,6 +142,9 @@ protected:
     /// Update the internal best block index as well as the prune lock.
     void SetBestBlockIndex(const CBlockIndex* block);
 
+    /// Whether the initial sync is done and blocks come from BlockConnected.
+    bool IsSynced() const { return m_synced; }
+
 public:
     BaseIndex(std::unique_ptr<interfaces::Chain> chain, std::string name);
     /// Destructor interrupts sync thread if running and blocks until it exits.
@@ -151,6 +166,10 @@ public:
     /// validation interface so that it stays in sync with blockchain updates.
     [[nodiscard]] bool Init();
 
+    /// Read the blocks of the initial sync through coordinator, which shares
+    /// them with other indexes. Call after Init() and before StartBackgroundSync().
+    void UseSyncCoordinator(IndexSyncCoordinator& coordinator);
+
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
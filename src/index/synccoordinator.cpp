@@ -0,0 +1,166 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/synccoordinator.h>
+
+#include <chain.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <util/thread.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+//! How long an index waits for a block before reading it itself
+static constexpr auto INDEX_SYNC_WAIT{10s};
+//! How often the reader looks for new blocks once it has read up to the tip
+static constexpr auto INDEX_SYNC_TIP_POLL{1s};
+
+IndexSyncCoordinator::IndexSyncCoordinator(ChainstateManager& chainman) : m_chainman{chainman} {}
+
+IndexSyncCoordinator::~IndexSyncCoordinator()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_cv.notify_all();
+    if (m_reader.joinable()) m_reader.join();
+}
+
+void IndexSyncCoordinator::Register(const BaseIndex& index, int next_height, bool undo)
+{
+    bool start_reader{false};
+    {
+        LOCK(m_mutex);
+        if (!m_next_heights.emplace(&index, next_height).second) return;
+        if (undo) m_undo_indexes.insert(&index);
+        if (!m_reader_running) {
+            m_reader_running = true;
+            m_read_height = next_height;
+            m_blocks.clear();
+            start_reader = true;
+        }
+    }
+    m_cv.notify_all();
+    if (start_reader) {
+        // A previous reader has already stopped, once all of its indexes left.
+        if (m_reader.joinable()) m_reader.join();
+        m_reader = std::thread(&util::TraceThread, "indexread", [this] { ReadBlocks(); });
+    }
+}
+
+void IndexSyncCoordinator::Unregister(const BaseIndex& index)
+{
+    {
+        LOCK(m_mutex);
+        m_next_heights.erase(&index);
+        m_undo_indexes.erase(&index);
+    }
+    m_cv.notify_all();
+}
+
+std::shared_ptr<const IndexSyncBlock> IndexSyncCoordinator::GetBlock(const BaseIndex& index, const CBlockIndex& block)
+{
+    WAIT_LOCK(m_mutex, lock);
+    const auto it{m_next_heights.find(&index)};
+    if (it == m_next_heights.end()) return nullptr;
+    it->second = block.nHeight;
+
+    // The index went back, or the chain was reorganized and the blocks read
+    // from this height on are stale: read again from it.
+    const auto read{m_blocks.find(block.nHeight)};
+    if (read != m_blocks.end() ? read->second->index != &block : block.nHeight < m_read_height) {
+        m_blocks.erase(m_blocks.lower_bound(block.nHeight), m_blocks.end());
+        m_read_height = block.nHeight;
+    }
+    m_cv.notify_all();
+
+    // Wait for the slowest index to come within a window, and for the reader.
+    // Unregistering the index, as interrupting it does, ends the wait.
+    m_cv.wait_for(lock, INDEX_SYNC_WAIT, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        return !m_reader_running || m_read_height > block.nHeight || !m_next_heights.contains(&index);
+    });
+    if (!m_next_heights.contains(&index)) return nullptr;
+    const auto shared{m_blocks.find(block.nHeight)};
+    if (shared == m_blocks.end() || shared->second->index != &block) return nullptr;
+    return shared->second;
+}
+
+void IndexSyncCoordinator::ReadBlocks()
+{
+    while (true) {
+        int height;
+        bool undo;
+        {
+            WAIT_LOCK(m_mutex, lock);
+            if (m_stop || m_next_heights.empty()) {
+                m_reader_running = false;
+                m_cv.notify_all();
+                return;
+            }
+            const int slowest{std::min_element(m_next_heights.begin(), m_next_heights.end(),
+                                               [](const auto& a, const auto& b) { return a.second < b.second; })->second};
+            m_blocks.erase(m_blocks.begin(), m_blocks.lower_bound(slowest));
+            // An index went back, or registered behind the reader: start again from it.
+            if (slowest < m_read_height && !m_blocks.contains(slowest)) {
+                m_blocks.clear();
+                m_read_height = slowest;
+            }
+            if (m_read_height >= slowest + INDEX_SYNC_WINDOW) {
+                m_cv.wait(lock);
+                continue;
+            }
+            height = m_read_height;
+            undo = !m_undo_indexes.empty();
+        }
+
+        const CBlockIndex* pindex;
+        node::BlockManager* blockman;
+        {
+            LOCK(::cs_main);
+            Chainstate& chainstate{m_chainman.GetChainstateForIndexing()};
+            pindex = chainstate.m_chain[height];
+            blockman = &chainstate.m_blockman;
+        }
+        if (!pindex) {
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait_for(lock, INDEX_SYNC_TIP_POLL);
+            continue;
+        }
+
+        auto read{std::make_shared<IndexSyncBlock>()};
+        read->index = pindex;
+        bool ok{blockman->ReadBlock(read->block, *pindex)};
+        if (ok && undo && height > 0) {
+            read->undo.emplace();
+            ok = blockman->ReadBlockUndo(*read->undo, *pindex);
+        }
+        if (!ok) {
+            // The indexes read the block themselves, and fail on it if it is really missing.
+            LogWarning("Failed to read block %s for index sync; indexes read blocks themselves from now on",
+                       pindex->GetBlockHash().ToString());
+            LOCK(m_mutex);
+            m_reader_running = false;
+            m_cv.notify_all();
+            return;
+        }
+
+        {
+            LOCK(m_mutex);
+            // Restarted from another height while reading
+            if (m_read_height != height) continue;
+            const auto prev{m_blocks.find(height - 1)};
+            if (prev != m_blocks.end() && prev->second->index != pindex->pprev) {
+                // The chain was reorganized; the blocks read before are stale.
+                m_blocks.clear();
+            }
+            m_blocks.emplace(height, std::move(read));
+            m_read_height = height + 1;
+        }
+        m_cv.notify_all();
+    }
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SYNCCOORDINATOR_H
+#define BITCOIN_INDEX_SYNCCOORDINATOR_H
+
+#include <primitives/block.h>
+#include <sync.h>
+#include <undo.h>
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <thread>
+
+class BaseIndex;
+class CBlockIndex;
+class ChainstateManager;
+
+/** Number of blocks the coordinator reads ahead of the slowest index. */
+static constexpr int INDEX_SYNC_WINDOW{16};
+
+/** A block, and its undo data if an index asked for it, read for several indexes. */
+struct IndexSyncBlock {
+    const CBlockIndex* index;
+    CBlock block;
+    std::optional<CBlockUndo> undo;
+};
+
+/**
+ * Reads the blocks of the active chain once for all indexes catching up
+ * together, instead of each index reading every block and its undo data
+ * itself.
+ *
+ * A reader thread reads up to INDEX_SYNC_WINDOW blocks ahead of the slowest
+ * registered index. The sync threads of the indexes take the blocks from
+ * it, so they still index in parallel, and each commits and writes its best
+ * block locator on its own schedule. An index that gets a window ahead of
+ * the slowest one waits for it, so every block is read only once.
+ *
+ * An index that goes back, or asks for a block that replaced one read before
+ * a reorg, makes the reader start again from that block. Whenever the
+ * coordinator does not have a block, for instance once the reader has failed
+ * or the index was unregistered, GetBlock() returns null and the index reads
+ * the block from disk itself.
+ */
+class IndexSyncCoordinator
+{
+public:
+    explicit IndexSyncCoordinator(ChainstateManager& chainman);
+    ~IndexSyncCoordinator();
+
+    IndexSyncCoordinator(const IndexSyncCoordinator&) = delete;
+    IndexSyncCoordinator& operator=(const IndexSyncCoordinator&) = delete;
+
+    /// Add an index whose next block is at next_height, reading undo data for it if needed.
+    void Register(const BaseIndex& index, int next_height, bool undo) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /// Remove an index once it no longer reads blocks through the coordinator.
+    void Unregister(const BaseIndex& index) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /// Return block, which index needs next, once it has been read; null if the index should read it itself.
+    std::shared_ptr<const IndexSyncBlock> GetBlock(const BaseIndex& index, const CBlockIndex& block) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    ChainstateManager& m_chainman;
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Next height needed by each registered index
+    std::map<const BaseIndex*, int> m_next_heights GUARDED_BY(m_mutex);
+    //! Registered indexes that need undo data
+    std::set<const BaseIndex*> m_undo_indexes GUARDED_BY(m_mutex);
+    //! Blocks read from the height of the slowest index on, by height
+    std::map<int, std::shared_ptr<const IndexSyncBlock>> m_blocks GUARDED_BY(m_mutex);
+    //! Height of the next block to read
+    int m_read_height GUARDED_BY(m_mutex){0};
+    bool m_reader_running GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    std::thread m_reader;
+
+    void ReadBlocks() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+#endif // BITCOIN_INDEX_SYNCCOORDINATOR_H
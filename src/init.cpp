@@ -36,6 +36,7 @@
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <index/spentindex.h>
+#include <index/synccoordinator.h>
 #include <index/timestampindex.h>
 #include <index/txindex.h>
 #include <init/common.h>
@@ -73,6 +74,7 @@
 #include <policy/fees_args.h>
 #include <policy/policy.h>
 #include <policy/settings.h>
+#include <pow_hash.h>
 #include <protocol.h>
 #include <rpc/blockchain.h>
 #include <rpc/register.h>
@@ -91,6 +93,7 @@
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/moneystr.h>
+#include <util/overflow.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
@@ -105,12 +108,15 @@
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <condition_variable>
 #include <cstdint>
 #include <cstdio>
 #include <fstream>
 #include <functional>
+#include <limits>
+#include <map>
 #include <set>
 #include <string>
 #include <thread>
@@ -297,6 +303,7 @@ void Interrupt(NodeContext& node)
     InterruptMapPort();
     if (node.connman)
         node.connman->Interrupt();
+    node.asset_warmup_interrupt = true;
     for (auto* index : node.indexes) {
         index->Interrupt();
     }
@@ -339,6 +346,7 @@ void Shutdown(NodeContext& node)
     StopTorControl();
 
     if (node.background_init_thread.joinable()) node.background_init_thread.join();
+    if (node.asset_warmup_thread.joinable()) node.asset_warmup_thread.join();
     // After everything has been shut down, but before things get flushed, stop the
     // the scheduler. After this point, SyncWithValidationInterfaceQueue() should not be called anymore
     // as this would prevent the shutdown from completing.
@@ -388,6 +396,7 @@ void Shutdown(NodeContext& node)
     if (g_timestampindex) g_timestampindex.reset();
     DestroyAllBlockFilterIndexes();
     node.indexes.clear(); // all instances are nullptr now
+    node.index_sync.reset();
 
     // Any future callbacks will be dropped. This should absolutely be safe - if
     // missing a callback results in an unrecoverable situation, unclean shutdown
@@ -411,7 +420,11 @@ void Shutdown(NodeContext& node)
         ipc->disconnectIncoming();
     }
 
-    // Clean up asset databases and caches
+    // Clean up asset databases and caches, remembering which assets were in
+    // use so the next start can warm the cache with them
+    if (passetsdb && passetsCache && !passetsdb->WriteHotAssets(passetsCache->GetKeys())) {
+        LogPrintf("%s: Failed to write the recently used assets\n", __func__);
+    }
     delete passets; passets = nullptr;
     delete passetsdb; passetsdb = nullptr;
     delete passetsCache; passetsCache = nullptr;
@@ -534,6 +547,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
 #if HAVE_SYSTEM
     argsman.AddArg("-blocknotify=<cmd>", "Execute command when the best block changes (%s in cmd is replaced by block hash)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
 #endif
+    argsman.AddArg("-assetcache=<n>", strprintf("Maximum memory for the asset metadata caches in MiB, taken from -dbcache (default: one eighth of -dbcache, up to %d)", MAX_DEFAULT_ASSET_CACHE >> 20), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blockreconstructionextratxn=<n>", strprintf("Extra transactions to keep in memory for compact block reconstructions (default: %u)", DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-blocksonly", strprintf("Whether to reject transactions from network peers. Disables automatic broadcast and rebroadcast of transactions, unless the source peer has the 'forcerelay' permission. RPC transactions are not affected. (default: %u)", DEFAULT_BLOCKSONLY), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-coinstatsindex", strprintf("Maintain coinstats index used by the gettxoutsetinfo RPC (default: %u)", DEFAULT_COINSTATSINDEX), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -551,6 +565,10 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet3: %s, testnet4: %s, signet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnet4ChainParams->GetConsensus().nMinimumChainWork.GetHex(), signetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (0 = auto, up to %d, <0 = leave that many cores free, default: %d)",
         MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-headermixdeferdepth=<n>", strprintf("During initial sync, accept KAWPOW/MEOWPOW headers more than <n> blocks below the highest known header, or the top of the batch of headers they arrive in, after checking only their claimed mix hash against the target. The full check runs when the block is received, before it is stored or connected (0 = always verify fully, default: %d)", DEFAULT_HEADER_MIX_DEFER_DEPTH), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-parheaders=<n>", strprintf("Set the number of threads checking the proof of work of received headers (0 = auto, up to %d, <0 = leave that many cores free, default: %d)",
+        MAX_HEADERCHECK_THREADS, DEFAULT_HEADERCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-powepochcache=<n>", strprintf("Number of KAWPOW/MEOWPOW epoch contexts to keep in memory (minimum 1, default: %d)", DEFAULT_POW_EPOCH_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempoolv1",
                    strprintf("Whether a mempool.dat file created by -persistmempool or the savemempool RPC will be written in the legacy format "
@@ -566,6 +584,7 @@ void SetupServerArgs(ArgsManager& argsman, bool can_listen_ipc)
     argsman.AddArg("-reindexassets", "If enabled, wipe and rebuild the asset database by scanning existing blocks. Much faster than a full -reindex.", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-assetindex", "Maintain a full asset index, used to query asset balances by address (default: 0)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-addressindex", "Maintain a full address index, used to query for the balance, txids and unspent outputs for addresses (default: 0)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-addressindexbatch=<n>", strprintf("Memory in MiB for address index entries collected while the index catches up with the chain, written in one batch when full and whenever the index commits (default: %u, 0 = write every block)", DEFAULT_ADDRESSINDEX_BATCH), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-spentindex", "Maintain a full spent index, used to query the spending txid and input index for an outpoint (default: 0)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-timestampindex", "Maintain a timestamp index for block hashes, used to query blocks within a time range (default: 0)", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-settings=<file>", strprintf("Specify path to dynamic settings data file. Can be disabled with -nosettings. File is written at runtime and not meant to be edited by users (use %s instead for custom settings). Relative paths will be prefixed by datadir location. (default: %s)", BITCOIN_CONF_FILENAME, BITCOIN_SETTINGS_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
@@ -1784,7 +1803,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
 
     // cache size calculations
     node::LogOversizedDbCache(args);
-    const auto [index_cache_sizes, kernel_cache_sizes] = CalculateCacheSizes(args, g_enabled_filter_types.size());
+    const auto [index_cache_sizes, kernel_cache_sizes, asset_cache_size] = CalculateCacheSizes(args, g_enabled_filter_types.size());
 
     LogInfo("Cache configuration:");
     LogInfo("* Using %.1f MiB for block index database", kernel_cache_sizes.block_tree_db * (1.0 / 1024 / 1024));
@@ -1796,6 +1815,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
                   index_cache_sizes.filter_index * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
     }
     LogInfo("* Using %.1f MiB for chain state database", kernel_cache_sizes.coins_db * (1.0 / 1024 / 1024));
+    LogInfo("* Using %.1f MiB for asset caches", asset_cache_size * (1.0 / 1024 / 1024));
 
     assert(!node.mempool);
     assert(!node.chainman);
@@ -1804,6 +1824,7 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     const bool do_reindex_chainstate{args.GetBoolArg("-reindex-chainstate", false)};
     bool do_reindex_assets{args.GetBoolArg("-reindexassets", false)};
     fAssetIndex = args.GetBoolArg("-assetindex", true);
+    SetPowEpochCacheSize(args.GetIntArg("-powepochcache", DEFAULT_POW_EPOCH_CACHE_SIZE));
 
     // Chainstate initialization and loading may be retried once with reindexing by GUI users
     auto [status, error] = InitAndLoadChainstate(
@@ -1872,7 +1893,10 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
     }
 
     if (args.GetBoolArg("-addressindex", false)) {
-        g_addressindex = std::make_unique<AddressIndex>(interfaces::MakeChain(node), /*cache_size=*/0, false, do_reindex);
+        const int64_t batch_mb{std::max<int64_t>(0, args.GetIntArg("-addressindexbatch", DEFAULT_ADDRESSINDEX_BATCH))};
+        const size_t batch_bytes{std::min<uint64_t>(SaturatingLeftShift<uint64_t>(batch_mb, 20), std::numeric_limits<size_t>::max())};
+        g_addressindex = std::make_unique<AddressIndex>(interfaces::MakeChain(node), /*cache_size=*/0, false, do_reindex,
+                                                        /*n_batch_size=*/batch_bytes);
         node.indexes.emplace_back(g_addressindex.get());
     }
 
@@ -1914,12 +1938,14 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         // erases only the address-balance keys ('B'/'C') while preserving asset metadata ('A' keys).
         passetsdb = new CAssetsDB(args.GetDataDirNet(), nAssetDBCache, false, do_reindex /* wipe only on full -reindex */);
         passets = new CAssetsCache();
-        passetsCache = new CLRUCache<std::string, CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE);
+        // Asset metadata gets half of the asset cache budget, the verifier
+        // and restriction caches an eighth each.
+        passetsCache = new AssetLookupTable<std::string, CDatabasedAssetData>(asset_cache_size / 2);
         prestricteddb = new CRestrictedDB(args.GetDataDirNet(), nAssetDBCache, false, do_reindex /* wipe only on full -reindex */);
-        passetsVerifierCache = new CLRUCache<std::string, CNullAssetTxVerifierString>(MAX_CACHE_ASSETS_SIZE);
-        passetsQualifierCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
-        passetsRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
-        passetsGlobalRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
+        passetsVerifierCache = new AssetLookupTable<std::string, CNullAssetTxVerifierString>(asset_cache_size / 8);
+        passetsQualifierCache = new AssetLookupTable<std::string, int8_t>(asset_cache_size / 8);
+        passetsRestrictionCache = new AssetLookupTable<std::string, int8_t>(asset_cache_size / 8);
+        passetsGlobalRestrictionCache = new AssetLookupTable<std::string, int8_t>(asset_cache_size / 8);
 
         // Messaging databases and caches
         pMessagesCache = new CLRUCache<std::string, CMessage>(1000);
@@ -1933,8 +1959,24 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         pAssetSnapshotDb = new CAssetSnapshotDB(args.GetDataDirNet(), nAssetDBCache, false, false);
         pDistributeSnapshotDb = new CDistributeSnapshotRequestDB(args.GetDataDirNet(), nAssetDBCache, false, false);
 
-        if (!passetsdb->LoadAssets(*passetsCache, &passets->mapAssetsAddressAmount, fAssetIndex)) {
-            return InitError(_("Failed to load Assets Database"));
+        // An asset flush that was interrupted after committing the asset
+        // database still has to write its restricted database changes.
+        {
+            CRestrictedDBBatch pendingRestricted;
+            if (passetsdb->ReadPendingRestrictedBatch(pendingRestricted)) {
+                LogPrintf("Replaying interrupted restricted asset database flush\n");
+                if (!prestricteddb->WriteFlushBatch(pendingRestricted) || !passetsdb->ErasePendingRestrictedBatch()) {
+                    return InitError(_("Failed to replay restricted asset database changes"));
+                }
+            }
+        }
+
+        if (!passetsdb->UpgradeAddressQuantityKeys()) {
+            return InitError(_("Failed to upgrade the asset balance database"));
+        }
+
+        if (!pSnapshotRequestDb->UpgradeSnapshotRequestKeys()) {
+            return InitError(_("Failed to upgrade the snapshot request database"));
         }
 
         // Check asset DB consistency with chain tip
@@ -2101,6 +2143,10 @@ bool AppInitMain(NodeContext& node, interfaces::BlockAndHeaderTipInfo* tip_info)
         vImportFiles.push_back(fs::PathFromString(strFile));
     }
 
+    if (passetsdb && passetsCache) {
+        node.asset_warmup_thread = std::thread(&util::TraceThread, "assetwarm", [&node] { WarmAssetCache(node.asset_warmup_interrupt); });
+    }
+
     node.background_init_thread = std::thread(&util::TraceThread, "initload", [=, &chainman, &args, &node] {
         ScheduleBatchPriority();
         // Import blocks and ActivateBestChain()
@@ -2374,6 +2420,8 @@ bool StartIndexBackgroundSync(NodeContext& node)
     ChainstateManager& chainman = *Assert(node.chainman);
     const Chainstate& chainstate = WITH_LOCK(::cs_main, return chainman.GetChainstateForIndexing());
     const CChain& index_chain = chainstate.m_chain;
+    // Height each index that is not synced starts from
+    std::map<BaseIndex*, int> start_heights;
 
     for (auto index : node.indexes) {
         const IndexSummary& summary = index->GetSummary();
@@ -2385,11 +2433,11 @@ bool StartIndexBackgroundSync(NodeContext& node)
         if (!index_chain.Contains(pindex)) {
             pindex = index_chain.FindFork(pindex);
         }
+        start_heights[index] = pindex ? pindex->nHeight : -1;
 
-        if (!indexes_start_block || !pindex || pindex->nHeight < indexes_start_block.value()->nHeight) {
+        if (!indexes_start_block || !pindex || (indexes_start_block.value() && pindex->nHeight < indexes_start_block.value()->nHeight)) {
             indexes_start_block = pindex;
             older_index_name = summary.name;
-            if (!pindex) break; // Starting from genesis so no need to look for earlier block.
         }
     };
 
@@ -2403,6 +2451,17 @@ bool StartIndexBackgroundSync(NodeContext& node)
         }
     }
 
+    // The indexes that start near the oldest one read each block once, through
+    // a shared coordinator. Those further ahead would have to wait for it to
+    // catch up, so they read their own blocks.
+    if (indexes_start_block) {
+        const int oldest_height = *indexes_start_block ? (*indexes_start_block)->nHeight : -1;
+        node.index_sync = std::make_unique<IndexSyncCoordinator>(chainman);
+        for (const auto& [index, height] : start_heights) {
+            if (height < oldest_height + INDEX_SYNC_WINDOW) index->UseSyncCoordinator(*node.index_sync);
+        }
+    }
+
     // Start threads
     for (auto index : node.indexes) if (!index->StartBackgroundSync()) return false;
     return true;
@@ -22,6 +22,8 @@ class CChainParams;
 class ValidationSignals;
 
 static constexpr auto DEFAULT_MAX_TIP_AGE{24h};
+/** Default for -headermixdeferdepth, in blocks below the highest known header */
+static constexpr int DEFAULT_HEADER_MIX_DEFER_DEPTH{500};
 
 namespace kernel {
 
@@ -46,6 +48,12 @@ struct ChainstateManagerOpts {
     ValidationSignals* signals{nullptr};
     //! Number of script check worker threads. Zero means no parallel verification.
     int worker_threads_num{0};
+    //! Number of header proof-of-work check worker threads. Zero means no parallel verification.
+    int header_worker_threads_num{0};
+    //! Headers further than this many blocks below the highest known header
+    //! only get their claimed KAWPOW/MEOWPOW mix_hash screened during IBD.
+    //! Zero or less means always verify the mix_hash when accepting headers.
+    int header_mix_defer_depth{DEFAULT_HEADER_MIX_DEFER_DEPTH};
     size_t script_execution_cache_bytes{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES};
     size_t signature_cache_bytes{DEFAULT_SIGNATURE_CACHE_BYTES};
 };
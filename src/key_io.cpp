@@ -96,10 +96,13 @@ CTxDestination DecodeDestination(const std::string& str, const CChainParams& par
     uint160 hash;
     error_str = "";
 
+    // A base58 address can start with the Bech32 prefix in any case ("MEwc..."
+    // on mainnet), so one that decodes as base58 is taken as base58.
+    const bool is_base58{DecodeBase58Check(str, data, 21)};
     // Note this will be false if it is a valid Bech32 address for a different network
-    bool is_bech32 = (ToLower(str.substr(0, params.Bech32HRP().size())) == params.Bech32HRP());
+    bool is_bech32 = !is_base58 && (ToLower(str.substr(0, params.Bech32HRP().size())) == params.Bech32HRP());
 
-    if (!is_bech32 && DecodeBase58Check(str, data, 21)) {
+    if (is_base58) {
         // base58-encoded Meowcoin addresses.
         // Public-key-hash-addresses have version 0 (or 111 testnet).
         // The data vector contains RIPEMD160(SHA256(pubkey)), where pubkey is the serialized public key.
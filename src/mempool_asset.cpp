@@ -205,8 +205,9 @@ static void RegisterVins(CTxMemPool& pool, const CTransaction& tx, const CCoinsV
         const Coin& coin = coins_view.AccessCoin(txin.prevout);
         if (coin.IsSpent() || !coin.out.scriptPubKey.IsAssetScript()) continue;
 
-        CAssetOutputEntry data;
-        if (!GetAssetData(coin.out.scriptPubKey, data)) continue;
+        const CAssetOutputEntry* asset_output = GetAssetOutput(coin);
+        if (!asset_output) continue;
+        const CAssetOutputEntry& data = *asset_output;
         if (!IsAssetNameAnRestricted(data.assetName)) continue;
 
         pool.mapAssetMarkedGlobalFrozen[data.assetName].insert(txid);
@@ -49,7 +49,15 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
         index_sizes.filter_index = max_cache / n_indexes;
         total_cache -= index_sizes.filter_index * n_indexes;
     }
-    return {index_sizes, kernel::CacheSizes{total_cache}};
+    // The asset caches get an eighth of -dbcache unless -assetcache sets
+    // their size; either way they may not take more than half of it.
+    uint64_t asset_cache_bytes{std::min(total_cache / 8, MAX_DEFAULT_ASSET_CACHE)};
+    if (auto asset_cache_mib{args.GetIntArg("-assetcache")}) {
+        asset_cache_bytes = SaturatingLeftShift<uint64_t>(std::max<int64_t>(*asset_cache_mib, 0), 20);
+    }
+    const size_t asset_cache{static_cast<size_t>(std::min<uint64_t>(asset_cache_bytes, total_cache / 2))};
+    total_cache -= asset_cache;
+    return {index_sizes, kernel::CacheSizes{total_cache}, asset_cache};
 }
 
 void LogOversizedDbCache(const ArgsManager& args) noexcept
@@ -16,6 +16,8 @@ class ArgsManager;
 static constexpr size_t MIN_DB_CACHE{4_MiB};
 //! -dbcache default (bytes)
 static constexpr size_t DEFAULT_DB_CACHE{DEFAULT_KERNEL_CACHE};
+//! max. default -assetcache (bytes), used when it is not set explicitly
+static constexpr size_t MAX_DEFAULT_ASSET_CACHE{256_MiB};
 
 namespace node {
 struct IndexCacheSizes {
@@ -25,6 +27,8 @@ struct IndexCacheSizes {
 struct CacheSizes {
     IndexCacheSizes index;
     kernel::CacheSizes kernel;
+    //! Combined budget of the in-memory asset metadata caches
+    size_t assets{0};
 };
 CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes = 0);
 constexpr bool ShouldWarnOversizedDbCache(size_t dbcache, size_t total_ram) noexcept
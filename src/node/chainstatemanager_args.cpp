@@ -59,6 +59,15 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
     // Subtract 1 because the main thread counts towards the par threads.
     opts.worker_threads_num = script_threads - 1;
 
+    int header_threads = args.GetIntArg("-parheaders", DEFAULT_HEADERCHECK_THREADS);
+    if (header_threads <= 0) {
+        // Same semantics as -par: 0 is autodetect, -n leaves n cores free.
+        header_threads += GetNumCores();
+    }
+    opts.header_worker_threads_num = header_threads - 1;
+
+    if (auto value{args.GetIntArg("-headermixdeferdepth")}) opts.header_mix_defer_depth = *value;
+
     if (auto max_size = args.GetIntArg("-maxsigcachesize")) {
         // 1. When supplied with a max_size of 0, both the signature cache and
         //    script execution cache create the minimum possible cache (2
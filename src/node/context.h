@@ -23,6 +23,7 @@ class CScheduler;
 class CTxMemPool;
 class ChainstateManager;
 class ECC_Context;
+class IndexSyncCoordinator;
 class NetGroupManager;
 class PeerManager;
 namespace interfaces {
@@ -73,6 +74,8 @@ struct NodeContext {
     std::unique_ptr<BanMan> banman;
     ArgsManager* args{nullptr}; // Currently a raw pointer because the memory is not managed by this struct
     std::vector<BaseIndex*> indexes; // raw pointers because memory is not managed by this struct
+    //! Reads blocks once for the indexes catching up together, see StartIndexBackgroundSync()
+    std::unique_ptr<IndexSyncCoordinator> index_sync;
     std::unique_ptr<interfaces::Chain> chain;
     //! List of all chain clients (wallet processes or other client) connected to node.
     std::vector<std::unique_ptr<interfaces::ChainClient>> chain_clients;
@@ -90,6 +93,9 @@ struct NodeContext {
     //! Manages all the node warnings
     std::unique_ptr<node::Warnings> warnings;
     std::thread background_init_thread;
+    //! Fills the asset cache in the background after startup, see WarmAssetCache()
+    std::thread asset_warmup_thread;
+    std::atomic<bool> asset_warmup_interrupt{false};
 
     //! Declare default constructor and destructor that are not inline, so code
     //! instantiating the NodeContext struct doesn't need to #include class
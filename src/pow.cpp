@@ -131,19 +131,22 @@ static unsigned int GetNextWorkRequired_LWMA_MultiAlgo(
         return powLimit.GetCompact();
     }
 
-    // Gather last N+1 blocks of the SAME algo
+    // Gather last N+1 blocks of the SAME algo. Walk back to the nearest one,
+    // then follow pprevSameAlgo, which is null once the gap to the previous
+    // same-algo block exceeds the search depth.
     std::vector<const CBlockIndex*> sameAlgo;
     sameAlgo.reserve(N + 1);
 
-    int64_t searchLimit = std::min<int64_t>(height, N * 10);
-    for (int64_t h = height; h >= 0
-         && static_cast<int64_t>(sameAlgo.size()) < (N + 1)
-         && (height - h) <= searchLimit; --h)
-    {
-        const CBlockIndex* bi = pindexLast->GetAncestor(h);
-        if (!bi) break;
-        PowAlgo bialgo = bi->nVersion.IsAuxpow() ? PowAlgo::SCRYPT : PowAlgo::MEOWPOW;
-        if (bialgo == algo) sameAlgo.push_back(bi);
+    const int64_t searchLimit = std::min<int64_t>(height, params.LwmaSearchDepth());
+    const CBlockIndex* bi = pindexLast;
+    while (bi && (height - bi->nHeight) <= searchLimit
+           && (bi->nVersion.IsAuxpow() ? PowAlgo::SCRYPT : PowAlgo::MEOWPOW) != algo) {
+        bi = bi->pprev;
+    }
+    while (bi && (height - bi->nHeight) <= searchLimit
+           && static_cast<int64_t>(sameAlgo.size()) < (N + 1)) {
+        sameAlgo.push_back(bi);
+        bi = bi->pprevSameAlgo;
     }
 
     if (static_cast<int64_t>(sameAlgo.size()) < (N + 1)) {
@@ -15,8 +15,16 @@
 #include <hash.h>
 #include <primitives/block.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
 
 // SPH hash library (from algo/ directory)
 #include <algo/sph_blake.h>
@@ -41,7 +49,6 @@
 #include <crypto/ethash/include/ethash/ethash.hpp>
 #include <crypto/ethash/include/ethash/progpow.hpp>
 #include <crypto/ethash/include/ethash/meowpow.hpp>
-#include <crypto/ethash/helpers.hpp>
 
 // ---------------------------------------------------------------------------
 // Helper: select hash algorithm index from a nibble of hashPrevBlock
@@ -326,37 +333,222 @@ uint256 HashX16RV2(const unsigned char* pbegin, const unsigned char* pend,
 }
 
 // ---------------------------------------------------------------------------
-// KAWPOW — ProgPow (ethash-based)
+// Hash invocation counters
 // ---------------------------------------------------------------------------
 
-uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash)
+static std::atomic<uint64_t> g_pow_hashes_computed{0};
+static std::atomic<uint64_t> g_pow_hash_memo_hits{0};
+
+PowHashCounters GetPowHashCounters()
+{
+    return PowHashCounters{
+        .computed = g_pow_hashes_computed.load(std::memory_order_relaxed),
+        .memo_hits = g_pow_hash_memo_hits.load(std::memory_order_relaxed),
+    };
+}
+
+void NotePowHashComputed()
+{
+    g_pow_hashes_computed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NotePowHashMemoHit()
 {
-    static ethash::epoch_context_ptr context{nullptr, nullptr};
+    g_pow_hash_memo_hits.fetch_add(1, std::memory_order_relaxed);
+}
 
-    const auto epoch_number = ethash::get_epoch_number(blockHeader.nHeight);
+// ---------------------------------------------------------------------------
+// Shared epoch context cache
+//
+// KAWPOW and MEOWPOW build identical light caches for a given epoch, so one
+// LRU of contexts keyed by epoch number serves both. Entries are shared
+// futures: a thread that misses builds the context outside the lock while any
+// other thread asking for the same epoch waits on that build instead of
+// starting its own.
+// ---------------------------------------------------------------------------
 
-    if (!context || context->epoch_number != epoch_number)
-        context = ethash::create_epoch_context(epoch_number);
+namespace {
 
-    uint256 nHeaderHash = blockHeader.GetKAWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+using EpochContextRef = std::shared_ptr<const ethash::epoch_context>;
+using EpochContextFuture = std::shared_future<EpochContextRef>;
+
+class EpochContextCache
+{
+    using Entry = std::pair<int, EpochContextFuture>;
+
+    mutable std::mutex m_mutex;
+    PowEpochCacheStats m_stats;
+    size_t m_capacity{DEFAULT_POW_EPOCH_CACHE_SIZE};
+    //! Most recently used first.
+    std::list<Entry> m_entries;
+    //! Evicted prebuilds still running. Dropping the last reference to an
+    //! async build blocks until it has finished, so they are kept until then.
+    std::list<EpochContextFuture> m_retired;
+
+    std::list<Entry>::iterator Find(int epoch_number)
+    {
+        return std::find_if(m_entries.begin(), m_entries.end(),
+                            [epoch_number](const Entry& e) { return e.first == epoch_number; });
+    }
+
+    static bool IsReady(const EpochContextFuture& future)
+    {
+        return future.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+    }
+
+    //! Trim to capacity, retiring evicted builds that are still running
+    //! instead of waiting for them, and drop retired builds that are done.
+    void TrimLocked()
+    {
+        std::erase_if(m_retired, IsReady);
+        while (m_entries.size() > m_capacity) {
+            EpochContextFuture& future{m_entries.back().second};
+            if (!IsReady(future)) m_retired.push_back(std::move(future));
+            m_entries.pop_back();
+            ++m_stats.evictions;
+        }
+    }
+
+    EpochContextRef Build(int epoch_number)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        EpochContextRef context{ethash::create_epoch_context(epoch_number)};
+        const auto elapsed{std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)};
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ++m_stats.builds;
+        m_stats.total_build_time += elapsed;
+        m_stats.last_build_time = elapsed;
+        return context;
+    }
+
+public:
+    EpochContextRef Get(int epoch_number)
+    {
+        EpochContextFuture future;
+        std::promise<EpochContextRef> promise;
+        bool build{false};
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            auto it{Find(epoch_number)};
+            if (it != m_entries.end()) {
+                ++m_stats.hits;
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                future = it->second;
+            } else {
+                ++m_stats.misses;
+                future = promise.get_future().share();
+                m_entries.emplace_front(epoch_number, future);
+                TrimLocked();
+                build = true;
+            }
+        }
+        if (build) promise.set_value(Build(epoch_number));
+
+        EpochContextRef context{future.get()};
+        if (!context) {
+            // Out of memory while building; do not keep the failed entry around.
+            std::lock_guard<std::mutex> lock{m_mutex};
+            auto it{Find(epoch_number)};
+            if (it != m_entries.end() && IsReady(it->second) && !it->second.get()) {
+                m_entries.erase(it);
+            }
+            throw std::bad_alloc();
+        }
+        return context;
+    }
+
+    void Prebuild(int epoch_number)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        // With room for one epoch only, the prebuilt one would evict the
+        // epoch the tip is still in, or be evicted itself right away.
+        if (m_capacity < 2) return;
+        if (Find(epoch_number) != m_entries.end()) return;
+        ++m_stats.prebuilds;
+        // Insert behind the most recently used entry so that the epoch the
+        // tip is still in is not the next to be evicted.
+        auto pos{m_entries.empty() ? m_entries.end() : std::next(m_entries.begin())};
+        m_entries.emplace(pos, epoch_number,
+                          std::async(std::launch::async, [this, epoch_number] { return Build(epoch_number); }).share());
+        TrimLocked();
+    }
+
+    void SetCapacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_capacity = std::max<size_t>(capacity, 1);
+        TrimLocked();
+    }
+
+    PowEpochCacheStats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        PowEpochCacheStats stats{m_stats};
+        stats.capacity = m_capacity;
+        for (const auto& [epoch_number, _] : m_entries) {
+            stats.epochs.push_back(epoch_number);
+        }
+        return stats;
+    }
+};
+
+EpochContextCache& GetEpochContextCache()
+{
+    static EpochContextCache cache;
+    return cache;
+}
+
+} // namespace
+
+void SetPowEpochCacheSize(int size)
+{
+    GetEpochContextCache().SetCapacity(std::max(size, 1));
+}
+
+PowEpochCacheStats GetPowEpochCacheStats()
+{
+    return GetEpochContextCache().GetStats();
+}
+
+void PrebuildPowEpochContext(uint32_t nHeight)
+{
+    GetEpochContextCache().Prebuild(ethash::get_epoch_number(nHeight));
+}
+
+void MaybePrebuildNextPowEpochContext(uint32_t nTipHeight)
+{
+    const uint32_t ahead{nTipHeight + POW_EPOCH_PREBUILD_DISTANCE};
+    if (ethash::get_epoch_number(ahead) != ethash::get_epoch_number(nTipHeight)) {
+        PrebuildPowEpochContext(ahead);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// KAWPOW — ProgPow (ethash-based)
+// ---------------------------------------------------------------------------
+
+uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash)
+{
+    const auto context = GetEpochContextCache().Get(ethash::get_epoch_number(blockHeader.nHeight));
+
+    const auto header_hash = ToEthashHash256(blockHeader.GetKAWPOWHeaderHash());
 
     const auto result = progpow::hash(*context, blockHeader.nHeight, header_hash, blockHeader.nNonce64);
 
-    mix_hash = uint256::FromHex(to_hex(result.mix_hash)).value_or(uint256{});
-    return uint256::FromHex(to_hex(result.final_hash)).value_or(uint256{});
+    mix_hash = FromEthashHash256(result.mix_hash);
+    return FromEthashHash256(result.final_hash);
 }
 
 uint256 KAWPOWHash_OnlyMix(const CBlockHeader& blockHeader)
 {
-    uint256 nHeaderHash = blockHeader.GetKAWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+    const auto header_hash = ToEthashHash256(blockHeader.GetKAWPOWHeaderHash());
 
     const auto result = progpow::hash_no_verify(blockHeader.nHeight, header_hash,
-                                                  to_hash256(blockHeader.mix_hash.GetHex()),
+                                                  ToEthashHash256(blockHeader.mix_hash),
                                                   blockHeader.nNonce64);
 
-    return uint256::FromHex(to_hex(result)).value_or(uint256{});
+    return FromEthashHash256(result);
 }
 
 // ---------------------------------------------------------------------------
@@ -365,30 +557,24 @@ uint256 KAWPOWHash_OnlyMix(const CBlockHeader& blockHeader)
 
 uint256 MEOWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash)
 {
-    static ethash::epoch_context_ptr context{nullptr, nullptr};
-
-    const auto epoch_number = ethash::get_epoch_number(blockHeader.nHeight);
+    const auto context = GetEpochContextCache().Get(ethash::get_epoch_number(blockHeader.nHeight));
 
-    if (!context || context->epoch_number != epoch_number)
-        context = ethash::create_epoch_context(epoch_number);
-
-    uint256 nHeaderHash = blockHeader.GetMEOWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+    const auto header_hash = ToEthashHash256(blockHeader.GetMEOWPOWHeaderHash());
 
     const auto result = meowpow::hash(*context, blockHeader.nHeight, header_hash, blockHeader.nNonce64);
 
-    mix_hash = uint256::FromHex(to_hex(result.mix_hash)).value_or(uint256{});
-    return uint256::FromHex(to_hex(result.final_hash)).value_or(uint256{});
+    mix_hash = FromEthashHash256(result.mix_hash);
+    return FromEthashHash256(result.final_hash);
 }
 
 uint256 MEOWPOWHash_OnlyMix(const CBlockHeader& blockHeader)
 {
-    uint256 nHeaderHash = blockHeader.GetMEOWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+    const auto header_hash = ToEthashHash256(blockHeader.GetMEOWPOWHeaderHash());
 
     const auto result = meowpow::hash_no_verify(blockHeader.nHeight, header_hash,
-                                                  to_hash256(blockHeader.mix_hash.GetHex()),
+                                                  ToEthashHash256(blockHeader.mix_hash),
                                                   blockHeader.nNonce64);
 
-    return uint256::FromHex(to_hex(result)).value_or(uint256{});}
+    return FromEthashHash256(result);
+}
 
@@ -12,11 +12,15 @@
  * implementations once the ethash / sphlib libraries are vendored.
  */
 
+#include <crypto/ethash/include/ethash/hash_types.hpp>
 #include <primitives/pureheader.h>
 #include <uint256.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <span>
+#include <vector>
 
 class CBlockHeader;
 
@@ -37,6 +41,26 @@ uint256 HashX16R(const unsigned char* pbegin, const unsigned char* pend,
 uint256 HashX16RV2(const unsigned char* pbegin, const unsigned char* pend,
                    const uint256& hashPrevBlock);
 
+/**
+ * Convert between uint256 and ethash::hash256 without going through hex.
+ * ethash treats a hash as a big-endian byte string (the order GetHex()
+ * prints), while uint256 stores its least significant byte first, so the
+ * byte order is reversed in both directions.
+ */
+inline ethash::hash256 ToEthashHash256(const uint256& hash)
+{
+    ethash::hash256 out;
+    std::reverse_copy(hash.begin(), hash.end(), out.bytes);
+    return out;
+}
+
+inline uint256 FromEthashHash256(const ethash::hash256& hash)
+{
+    uint256 out;
+    std::reverse_copy(std::begin(hash.bytes), std::end(hash.bytes), out.begin());
+    return out;
+}
+
 /**
  * Full KAWPOW ProgPow hash (creates epoch context, returns final hash).
  * @param blockHeader The block header.
@@ -72,4 +96,58 @@ uint256 MEOWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash);
  */
 uint256 MEOWPOWHash_OnlyMix(const CBlockHeader& blockHeader);
 
+/**
+ * Proof-of-work hash invocations through CBlockHeader. GetHash() memoizes its
+ * result on the header object; these count how often a hash was actually
+ * computed and how often the memo answered instead.
+ */
+struct PowHashCounters {
+    uint64_t computed{0};
+    uint64_t memo_hits{0};
+};
+
+PowHashCounters GetPowHashCounters();
+void NotePowHashComputed();
+void NotePowHashMemoHit();
+
+/** Default number of ProgPoW epoch contexts kept in the shared cache. */
+static constexpr int DEFAULT_POW_EPOCH_CACHE_SIZE{3};
+/** Start building the next epoch context once the tip is this close to the boundary. */
+static constexpr int POW_EPOCH_PREBUILD_DISTANCE{256};
+
+/** Counters describing the shared KAWPOW/MEOWPOW epoch context cache. */
+struct PowEpochCacheStats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t builds{0};
+    uint64_t prebuilds{0};
+    uint64_t evictions{0};
+    std::chrono::microseconds total_build_time{0};
+    std::chrono::microseconds last_build_time{0};
+    size_t capacity{0};
+    /** Epochs currently held (or being built), most recently used first. */
+    std::vector<int> epochs;
+};
+
+/**
+ * Set the number of epoch contexts the shared cache may hold. Contexts
+ * beyond the new limit are evicted in least-recently-used order.
+ */
+void SetPowEpochCacheSize(int size);
+
+PowEpochCacheStats GetPowEpochCacheStats();
+
+/**
+ * Build the epoch context that a block at nHeight will need in the
+ * background, unless it is already cached or being built. Callers hashing
+ * the epoch later wait on the in-flight build instead of starting another.
+ */
+void PrebuildPowEpochContext(uint32_t nHeight);
+
+/**
+ * Prebuild the next epoch context if nTipHeight is within
+ * POW_EPOCH_PREBUILD_DISTANCE blocks of an epoch boundary.
+ */
+void MaybePrebuildNextPowEpochContext(uint32_t nTipHeight);
+
 #endif // BITCOIN_POW_HASH_H
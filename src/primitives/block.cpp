@@ -13,7 +13,37 @@
 uint32_t nKAWPOWActivationTime = 0;
 uint32_t nMEOWPOWActivationTime = 0;
 
+CBlockHeader::PowHashKey CBlockHeader::GetPowHashKey() const
+{
+    return PowHashKey{
+        .version = nVersion.GetFullVersion(),
+        .hash_prev_block = hashPrevBlock,
+        .hash_merkle_root = hashMerkleRoot,
+        .time = nTime,
+        .bits = nBits,
+        .nonce = nNonce,
+        .height = nHeight,
+        .nonce64 = nNonce64,
+        .mix_hash = mix_hash,
+        .kawpow_activation_time = nKAWPOWActivationTime,
+        .meowpow_activation_time = nMEOWPOWActivationTime,
+    };
+}
+
 uint256 CBlockHeader::GetHash() const
+{
+    const PowHashKey key{GetPowHashKey()};
+    if (const auto hash{m_pow_hash_memo.Get(key)}) {
+        NotePowHashMemoHit();
+        return *hash;
+    }
+    const uint256 hash{ComputePowHash()};
+    NotePowHashComputed();
+    m_pow_hash_memo.Set(key, hash);
+    return hash;
+}
+
+uint256 CBlockHeader::ComputePowHash() const
 {
     // AuxPoW blocks use the Scrypt hash of the pure 6-field header.
     if (this->nVersion.IsAuxpow()) {
@@ -40,17 +70,25 @@ uint256 CBlockHeader::GetHash() const
 
 uint256 CBlockHeader::GetHashFull(uint256& mix_hash_out) const
 {
+    const PowHashKey key{GetPowHashKey()};
+    uint256 hash;
     if (nTime < nKAWPOWActivationTime) {
-        return HashX16RV2(reinterpret_cast<const unsigned char*>(&nVersion),
+        hash = HashX16RV2(reinterpret_cast<const unsigned char*>(&nVersion),
                           reinterpret_cast<const unsigned char*>(&nNonce) + sizeof(nNonce),
                           hashPrevBlock);
+    } else if (nTime < nMEOWPOWActivationTime) {
+        hash = KAWPOWHash(*this, mix_hash_out);
+    } else {
+        hash = MEOWPOWHash(*this, mix_hash_out);
     }
+    NotePowHashComputed();
 
-    if (nTime < nMEOWPOWActivationTime) {
-        return KAWPOWHash(*this, mix_hash_out);
+    // With the claimed mix confirmed, the full hash is also what GetHash()
+    // would return, so later callers can skip even the cheap path.
+    if (!nVersion.IsAuxpow() && (nTime < nKAWPOWActivationTime || mix_hash_out == mix_hash)) {
+        m_pow_hash_memo.Set(key, hash);
     }
-
-    return MEOWPOWHash(*this, mix_hash_out);
+    return hash;
 }
 
 uint256 CBlockHeader::GetX16RHash() const
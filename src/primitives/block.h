@@ -15,6 +15,8 @@
 #include <util/time.h>
 
 #include <memory>
+#include <mutex>
+#include <optional>
 
 /** Global activation timestamps set from chainparams at init time. */
 extern uint32_t nKAWPOWActivationTime;
@@ -105,6 +107,79 @@ public:
      * @param apow Pointer to the auxpow to use or nullptr.
      */
     void SetAuxpow(std::shared_ptr<CAuxPow> apow);
+
+private:
+    /** Everything GetHash() depends on, including the global activation times. */
+    struct PowHashKey {
+        int32_t version;
+        uint256 hash_prev_block;
+        uint256 hash_merkle_root;
+        uint32_t time;
+        uint32_t bits;
+        uint32_t nonce;
+        uint32_t height;
+        uint64_t nonce64;
+        uint256 mix_hash;
+        uint32_t kawpow_activation_time;
+        uint32_t meowpow_activation_time;
+
+        bool operator==(const PowHashKey&) const = default;
+    };
+
+    /**
+     * Memoized GetHash() result. The fields of this class are public and may
+     * be changed at any time, so the memo keeps the key it was computed from
+     * and is only used while that key still matches. Copies of a header share
+     * the memo; concurrent readers of one header are safe.
+     */
+    class PowHashMemo
+    {
+        struct Entry {
+            PowHashKey key;
+            uint256 hash;
+        };
+
+        mutable std::mutex m_mutex;
+        std::shared_ptr<const Entry> m_entry;
+
+        std::shared_ptr<const Entry> Load() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_entry;
+        }
+
+    public:
+        PowHashMemo() = default;
+        PowHashMemo(const PowHashMemo& other) : m_entry{other.Load()} {}
+        PowHashMemo& operator=(const PowHashMemo& other)
+        {
+            if (this != &other) {
+                auto entry{other.Load()};
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_entry = std::move(entry);
+            }
+            return *this;
+        }
+
+        std::optional<uint256> Get(const PowHashKey& key) const
+        {
+            const auto entry{Load()};
+            if (entry && entry->key == key) return entry->hash;
+            return std::nullopt;
+        }
+
+        void Set(const PowHashKey& key, const uint256& hash)
+        {
+            auto entry{std::make_shared<const Entry>(Entry{key, hash})};
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entry = std::move(entry);
+        }
+    };
+
+    mutable PowHashMemo m_pow_hash_memo;
+
+    PowHashKey GetPowHashKey() const;
+    uint256 ComputePowHash() const;
 };
 
 
@@ -146,18 +221,8 @@ public:
 
     CBlockHeader GetBlockHeader() const
     {
-        CBlockHeader block;
-        block.nVersion       = nVersion;
-        block.hashPrevBlock  = hashPrevBlock;
-        block.hashMerkleRoot = hashMerkleRoot;
-        block.nTime          = nTime;
-        block.nBits          = nBits;
-        block.nNonce         = nNonce;
-        block.auxpow         = auxpow;
-        block.nHeight        = nHeight;
-        block.nNonce64       = nNonce64;
-        block.mix_hash       = mix_hash;
-        return block;
+        // Slicing copy: keeps the memoized proof-of-work hash.
+        return *this;
     }
 
     std::string ToString() const;
@@ -20,7 +20,13 @@
 #include <key_io.h>
 
 #include <univalue.h>
+#include <algorithm>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 extern CAssetSnapshotDB* pAssetSnapshotDb;
 extern CSnapshotRequestDB* pSnapshotRequestDb;
@@ -226,6 +232,18 @@ static RPCHelpMan getcacheinfo()
             {
                 {RPCResult::Type::NUM, "asset_total_cache_size", "total size of asset caches"},
                 {RPCResult::Type::NUM, "asset_address_map_size", "size of address-to-asset amount map"},
+                {RPCResult::Type::OBJ_DYN, "caches", "asset database lookup caches, keyed by name (assets, verifiers, qualifiers, restrictions, global_restrictions)",
+                {
+                    {RPCResult::Type::OBJ, "name", "",
+                    {
+                        {RPCResult::Type::NUM, "entries", "number of cached entries"},
+                        {RPCResult::Type::NUM, "usage", "memory used by the table and its entries in bytes"},
+                        {RPCResult::Type::NUM, "budget", "maximum memory usage in bytes"},
+                        {RPCResult::Type::NUM, "hits", "lookups answered from the cache"},
+                        {RPCResult::Type::NUM, "misses", "lookups that fell through to the database"},
+                        {RPCResult::Type::NUM, "evictions", "entries evicted to stay within the budget"},
+                    }},
+                }},
             }
         },
         RPCExamples{
@@ -245,6 +263,26 @@ static RPCHelpMan getcacheinfo()
                 result.pushKV("asset_address_map_size", 0);
             }
 
+            UniValue caches(UniValue::VOBJ);
+            const auto push_stats = [&caches](const std::string& name, const auto* cache) {
+                if (!cache) return;
+                const AssetLookupStats stats{cache->GetStats()};
+                UniValue entry(UniValue::VOBJ);
+                entry.pushKV("entries", (uint64_t)stats.entries);
+                entry.pushKV("usage", (uint64_t)stats.usage);
+                entry.pushKV("budget", (uint64_t)stats.budget);
+                entry.pushKV("hits", stats.hits);
+                entry.pushKV("misses", stats.misses);
+                entry.pushKV("evictions", stats.evictions);
+                caches.pushKV(name, std::move(entry));
+            };
+            push_stats("assets", passetsCache);
+            push_stats("verifiers", passetsVerifierCache);
+            push_stats("qualifiers", passetsQualifierCache);
+            push_stats("restrictions", passetsRestrictionCache);
+            push_stats("global_restrictions", passetsGlobalRestrictionCache);
+            result.pushKV("caches", std::move(caches));
+
             return result;
         },
     };
@@ -294,29 +332,36 @@ static RPCHelpMan listassetbalancesbyaddress()
                 start = request.params[3].getInt<int>();
             }
 
-            LOCK(cs_main);
-
-            if (!passets)
-                throw JSONRPCError(RPC_INTERNAL_ERROR, "asset cache unavailable.");
+            // Build combined map from unsaved in-memory dirty entries + DB.
+            std::map<std::string, CAmount> combined;
+            std::unique_ptr<CDBIterator> dbCursor;
+            {
+                LOCK(cs_main);
 
-            UniValue result(UniValue::VOBJ);
+                if (!passets)
+                    throw JSONRPCError(RPC_INTERNAL_ERROR, "asset cache unavailable.");
+
+                passets->mapAssetsAddressAmount.ForEachAsset(address, [&](const std::string& assetName, CAmount amount) {
+                    combined[assetName] = amount;
+                });
+                // Asset balances are written to the database under cs_main, so
+                // an iterator created here sees exactly the state the dirty
+                // entries above sit on, and can be read after the lock is gone.
+                if (passetsdb)
+                    dbCursor.reset(passetsdb->NewIterator());
+            }
 
-            // Build combined map from DB + unsaved in-memory dirty entries.
-            std::map<std::string, CAmount> combined;
-            if (passetsdb) {
-                std::vector<std::pair<std::string, CAmount>> vecDB;
-                int dbTotal = 0;
-                if (!passetsdb->AddressDir(vecDB, dbTotal, false, address, std::numeric_limits<size_t>::max(), 0))
+            if (dbCursor) {
+                // Dirty entries are newer, so they win over the database
+                if (!passetsdb->ForEachAddressAsset(*dbCursor, address, [&](const std::string& assetName, CAmount amount) {
+                        combined.emplace(assetName, amount);
+                        return true;
+                    }))
                     throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to query address asset database");
-                for (const auto& [assetName, amt] : vecDB)
-                    combined[assetName] = amt;
-            }
-            // Overlay unsaved in-memory dirty entries
-            for (const auto& [pair, amount] : passets->mapAssetsAddressAmount) {
-                if (pair.second == address)
-                    combined[pair.first] = amount;
             }
 
+            UniValue result(UniValue::VOBJ);
+
             if (onlytotal) {
                 int nTotal = 0;
                 for (const auto& [assetName, amt] : combined) {
@@ -345,6 +390,9 @@ static RPCHelpMan listassetbalancesbyaddress()
     };
 }
 
+//! Most holders listaddressesbyasset returns from the database
+static constexpr size_t MAX_LISTED_HOLDERS{50000};
+
 static RPCHelpMan listaddressesbyasset()
 {
     return RPCHelpMan{
@@ -409,25 +457,36 @@ static RPCHelpMan listaddressesbyasset()
                     throw JSONRPCError(RPC_INVALID_PARAMETER, "Asset not found: " + assetName);
             }
 
-            // Build combined address->amount map from DB + in-memory dirty entries.
-            std::map<std::string, CAmount> combined;
-            if (passetsdb) {
-                std::vector<std::pair<std::string, CAmount>> vecDB;
-                int dbTotal = 0;
-                if (!passetsdb->AssetAddressDir(vecDB, dbTotal, false, assetName, std::numeric_limits<size_t>::max(), 0))
-                    throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to query asset address database");
-                for (const auto& [addr, amt] : vecDB)
-                    combined[addr] = amt;
-            }
-            // Overlay unsaved in-memory dirty entries
-            for (const auto& [pair, amount] : passets->mapAssetsAddressAmount) {
-                if (pair.first == assetName)
-                    combined[pair.second] = amount;
-            }
+            // Unsaved in-memory dirty entries are newer than the database.
+            std::map<std::string, CAmount> dirty;
+            passets->mapAssetsAddressAmount.ForEachAddress(assetName, [&](const std::string& addr, CAmount amount) {
+                dirty[addr] = amount;
+            });
+
+            // The database lists holders in the order of their binary keys, so
+            // only the lowest addresses are kept: enough for the requested
+            // page even if every dirty entry is empty, and no more than a
+            // database query used to return.
+            const size_t page{std::min<size_t>(count + std::max<long>(start, 0), MAX_LISTED_HOLDERS)};
+            const size_t keep{page + dirty.size()};
+            std::map<std::string, CAmount> combined{dirty};
+            int dbTotal = 0;
+            if (passetsdb && !passetsdb->ForEachAssetHolder(assetName, [&](const CAssetAddressKey& key, CAmount amount) {
+                    const std::string addr{key.ToString()};
+                    if (amount <= 0 || dirty.count(addr)) return true;
+                    if (onlytotal) {
+                        dbTotal++;
+                        return true;
+                    }
+                    combined.emplace(addr, amount);
+                    if (combined.size() > keep) combined.erase(std::prev(combined.end()));
+                    return true;
+                }))
+                throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to query asset address database");
 
             if (onlytotal) {
-                int nTotal = 0;
-                for (const auto& [addr, amt] : combined) {
+                int nTotal = dbTotal;
+                for (const auto& [addr, amt] : dirty) {
                     if (amt > 0) nTotal++;
                 }
                 result.pushKV("total", nTotal);
@@ -875,21 +934,28 @@ static RPCHelpMan getsnapshot()
             std::string asset_name = request.params[0].get_str();
             int block_height = request.params[1].getInt<int>();
 
-            CAssetSnapshotDBEntry snapshotEntry;
-            if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(asset_name, block_height, snapshotEntry))
+            //  Owners are visited a chunk at a time in the order of the
+            //  binary address keys they were read in, so sort them by
+            //  address for the reply.
+            std::vector<std::pair<std::string, CAmount>> ownersAndAmounts;
+            if (!pAssetSnapshotDb->ForEachSnapshotOwner(asset_name, block_height, [&](const std::string& address, CAmount amount) {
+                    ownersAndAmounts.emplace_back(address, amount);
+                    return true;
+                }))
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "No snapshot found for asset '" + asset_name + "' at height " + std::to_string(block_height));
-
-            UniValue result(UniValue::VOBJ);
-            result.pushKV("name", snapshotEntry.assetName);
-            result.pushKV("height", snapshotEntry.height);
+            std::sort(ownersAndAmounts.begin(), ownersAndAmounts.end());
 
             UniValue owners(UniValue::VARR);
-            for (const auto& [address, amount] : snapshotEntry.ownersAndAmounts) {
+            for (const auto& [address, amount] : ownersAndAmounts) {
                 UniValue entry(UniValue::VOBJ);
                 entry.pushKV("address", address);
                 entry.pushKV("amount_owned", AssetUnitValueFromAmount(amount, asset_name));
                 owners.push_back(entry);
             }
+
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("name", asset_name);
+            result.pushKV("height", block_height);
             result.pushKV("owners", owners);
 
             return result;
@@ -13,17 +13,127 @@
 #include <primitives/block.h>
 #include <script/script.h>
 #include <streams.h>
+#include <txmempool.h>
 #include <uint256.h>
 #include <util/strencodings.h>
 #include <validation.h>
 
 #include <cassert>
+#include <iterator>
 
 namespace auxpow_miner {
 
+void TemplateCache::eraseLocked(std::unordered_map<uint256, Entry, SaltedUint256Hasher>::iterator it)
+{
+    auto current = m_current.find(it->second.script);
+    if (current != m_current.end() && current->second == it->first) {
+        m_current.erase(current);
+    }
+    m_order.erase(it->second.order);
+    m_templates.erase(it);
+}
+
+void TemplateCache::purgeStaleLocked(const uint256& tip)
+{
+    if (tip == m_tip) return;
+    m_stats.stale_purged += m_templates.size();
+    m_templates.clear();
+    m_current.clear();
+    m_order.clear();
+    m_assembled.reset();
+    m_tip = tip;
+}
+
+bool TemplateCache::IsFresh(NodeClock::time_point created, unsigned int created_txs_updated, unsigned int txs_updated)
+{
+    return created_txs_updated == txs_updated || NodeClock::now() - created < AUXPOW_TEMPLATE_REFRESH;
+}
+
+std::shared_ptr<CBlock> TemplateCache::WithPayout(const Assembled& base, const CScript& scriptPubKey)
+{
+    auto pblock = std::make_shared<CBlock>(*base.block);
+    CMutableTransaction coinbase{*pblock->vtx[0]};
+    coinbase.vout[0].scriptPubKey = scriptPubKey;
+    pblock->vtx[0] = MakeTransactionRef(std::move(coinbase));
+    // The coinbase is leftmost in the tree, so only its own path to the
+    // root changes.
+    pblock->hashMerkleRoot = CAuxPow::CheckMerkleBranch(pblock->vtx[0]->GetHash().ToUint256(), base.coinbase_branch, 0);
+    return pblock;
+}
+
 uint256 TemplateCache::createBlock(const CScript& scriptPubKey,
                                    interfaces::Mining& miner,
-                                   ChainstateManager& chainman)
+                                   ChainstateManager& chainman,
+                                   const CTxMemPool* mempool)
+{
+    // The active tip is read before taking m_cs, as cs_main must never be
+    // taken while holding it. A request that read an older tip may move the
+    // cache back to it, but cannot cache a block on it: the block is built
+    // on the newer tip and rejected below.
+    AssertLockNotHeld(::cs_main);
+    const auto active_tip = [&] { return WITH_LOCK(chainman.GetMutex(), return chainman.ActiveChain().Tip()->GetBlockHash()); };
+    while (true) {
+        const unsigned int txs_updated{mempool ? mempool->GetTransactionsUpdated() : 0};
+        std::shared_ptr<const Assembled> base;
+        {
+            const uint256 tip{active_tip()};
+            std::lock_guard<std::mutex> lock(m_cs);
+            purgeStaleLocked(tip);
+            auto current = m_current.find(scriptPubKey);
+            if (current != m_current.end()) {
+                const Entry& entry = m_templates.at(current->second);
+                if (IsFresh(entry.created, entry.txs_updated, txs_updated)) {
+                    ++m_stats.hits;
+                    return current->second;
+                }
+            }
+            ++m_stats.misses;
+            if (m_assembled && IsFresh(m_assembled->created, m_assembled->txs_updated, txs_updated)) {
+                base = m_assembled;
+            }
+        }
+
+        std::shared_ptr<CBlock> pblock;
+        std::shared_ptr<const Assembled> assembled;
+        if (base) {
+            pblock = WithPayout(*base, scriptPubKey);
+        } else {
+            pblock = AssembleBlock(scriptPubKey, miner, chainman);
+            assembled = std::make_shared<const Assembled>(Assembled{
+                std::make_shared<const CBlock>(*pblock), TransactionMerklePath(*pblock, 0), NodeClock::now(), txs_updated});
+        }
+
+        // The hash the parent chain must solve for (SHA256d of the pure header).
+        uint256 hash = pblock->GetHash();
+
+        // The tip may have moved while the block was being assembled, and a
+        // concurrent request may already have cached templates for the new
+        // one. Compare with the active tip rather than the block's parent, so
+        // a slow request for an older tip cannot take the cache back to it;
+        // its block would be stale, so start over on the new tip.
+        const uint256 tip{active_tip()};
+        std::lock_guard<std::mutex> lock(m_cs);
+        purgeStaleLocked(tip);
+        if (pblock->hashPrevBlock != m_tip) continue;
+        if (base) ++m_stats.payout_swaps;
+        if (assembled) m_assembled = std::move(assembled);
+        if (auto existing = m_templates.find(hash); existing != m_templates.end()) {
+            eraseLocked(existing);
+        }
+        m_order.push_back(hash);
+        m_templates.emplace(hash, Entry{pblock, scriptPubKey, NodeClock::now(), txs_updated, std::prev(m_order.end())});
+        m_current[scriptPubKey] = hash;
+        while (m_templates.size() > MAX_AUXPOW_TEMPLATES) {
+            eraseLocked(m_templates.find(m_order.front()));
+            ++m_stats.evictions;
+        }
+        return hash;
+    }
+}
+
+std::shared_ptr<CBlock> TemplateCache::AssembleBlock(const CScript& scriptPubKey,
+                                                     interfaces::Mining& miner,
+                                                     ChainstateManager& chainman)
 {
     // Create a new block template via the Mining interface.
     node::BlockCreateOptions opts;
@@ -63,22 +173,14 @@ uint256 TemplateCache::createBlock(const CScript& scriptPubKey,
     // Recompute the merkle root after any modifications.
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 
-    // The hash the parent chain must solve for (SHA256d of the pure header).
-    uint256 hash = pblock->GetHash();
-
-    // Cache the template.
-    {
-        std::lock_guard<std::mutex> lock(m_cs);
-        m_templates[hash] = pblock;
-    }
-
-    return hash;
+    return pblock;
 }
 
 bool TemplateCache::submitBlock(const uint256& hashBlock,
                                 const std::string& auxpowHex,
                                 ChainstateManager& chainman)
 {
+    AssertLockNotHeld(::cs_main);
     std::shared_ptr<CBlock> pblock;
     {
         std::lock_guard<std::mutex> lock(m_cs);
@@ -88,8 +190,8 @@ bool TemplateCache::submitBlock(const uint256& hashBlock,
                      hashBlock.GetHex());
             return false;
         }
-        pblock = it->second;
-        m_templates.erase(it);
+        pblock = it->second.block;
+        eraseLocked(it);
     }
 
     // Deserialize the AuxPoW from hex.
@@ -117,10 +219,20 @@ bool TemplateCache::submitBlock(const uint256& hashBlock,
 
 std::shared_ptr<CBlock> TemplateCache::getBlock(const uint256& hash)
 {
+    AssertLockNotHeld(::cs_main);
     std::lock_guard<std::mutex> lock(m_cs);
     auto it = m_templates.find(hash);
-    if (it != m_templates.end()) return it->second;
+    if (it != m_templates.end()) return it->second.block;
     return nullptr;
 }
 
+TemplateCacheStats TemplateCache::getStats()
+{
+    AssertLockNotHeld(::cs_main);
+    std::lock_guard<std::mutex> lock(m_cs);
+    TemplateCacheStats stats{m_stats};
+    stats.size = m_templates.size();
+    return stats;
+}
+
 } // namespace auxpow_miner
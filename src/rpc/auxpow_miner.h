@@ -13,15 +13,22 @@
  */
 
 #include <primitives/block.h>
+#include <script/script.h>
 #include <uint256.h>
 #include <util/hasher.h>
+#include <util/time.h>
 
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
-class CScript;
+class CTxMemPool;
 class ChainstateManager;
 
 namespace node { struct NodeContext; }
@@ -29,16 +36,49 @@ namespace interfaces { class Mining; }
 
 namespace auxpow_miner {
 
+/** Most templates kept at once; the oldest is dropped beyond this. */
+static constexpr size_t MAX_AUXPOW_TEMPLATES{100};
+/** A payout script's template is rebuilt for new mempool transactions at most this often. */
+static constexpr std::chrono::seconds AUXPOW_TEMPLATE_REFRESH{60};
+
+struct TemplateCacheStats {
+    size_t size{0};
+    size_t capacity{MAX_AUXPOW_TEMPLATES};
+    /** createBlock() calls answered with an existing template. */
+    uint64_t hits{0};
+    /** createBlock() calls that needed a new template. */
+    uint64_t misses{0};
+    /** Misses served by swapping the payout into an already assembled block. */
+    uint64_t payout_swaps{0};
+    /** Templates dropped to stay within capacity. */
+    uint64_t evictions{0};
+    /** Templates dropped because the chain tip moved. */
+    uint64_t stale_purged{0};
+};
+
 /** Hold recent block templates keyed by block hash so a solved AuxPoW
- *  can be matched back to its template.  Thread-safe. */
+ *  can be matched back to its template.  Thread-safe.
+ *
+ *  All cached templates build on the same parent. When the tip moves, every
+ *  template is dropped, since a solution for an old tip would only make a
+ *  stale block. Each payout script keeps reusing its current template until
+ *  the tip changes, or until the mempool has changed and the template is at
+ *  least AUXPOW_TEMPLATE_REFRESH old (the getblocktemplate longpoll rule
+ *  with a longer interval).
+ *
+ *  Transaction selection runs once per tip and mempool epoch by the same
+ *  rule. Templates for other payout scripts are derived from that block by
+ *  replacing the coinbase payout and rehashing the coinbase's merkle branch. */
 class TemplateCache
 {
 public:
-    /** Create a new block template for merge-mining.
+    /** Create a new block template for merge-mining, or return the current
+     *  one for this payout script if it is still fresh.
      *  Returns the pure-header hash (the hash the parent chain must solve for). */
     uint256 createBlock(const CScript& scriptPubKey,
                         interfaces::Mining& miner,
-                        ChainstateManager& chainman);
+                        ChainstateManager& chainman,
+                        const CTxMemPool* mempool);
 
     /** Submit a solved AuxPoW for a previously-created template.
      *  @param hashBlock   The block hash returned by createBlock.
@@ -50,9 +90,52 @@ public:
     /** Get the currently cached block (for RPC result building). */
     std::shared_ptr<CBlock> getBlock(const uint256& hash);
 
+    TemplateCacheStats getStats();
+
 private:
+    struct Entry {
+        std::shared_ptr<CBlock> block;
+        CScript script;
+        NodeClock::time_point created;
+        /** Mempool GetTransactionsUpdated() when the template was built. */
+        unsigned int txs_updated;
+        std::list<uint256>::iterator order;
+    };
+
+    /** A fully assembled block that other templates are derived from. */
+    struct Assembled {
+        std::shared_ptr<const CBlock> block;
+        /** Merkle branch of the coinbase, which does not depend on its payout. */
+        std::vector<uint256> coinbase_branch;
+        NodeClock::time_point created;
+        unsigned int txs_updated;
+    };
+
+    /** Whether a template built at created with txs_updated may still be served. */
+    static bool IsFresh(NodeClock::time_point created, unsigned int created_txs_updated, unsigned int txs_updated);
+    /** Select transactions and build a complete AuxPoW block paying scriptPubKey. */
+    static std::shared_ptr<CBlock> AssembleBlock(const CScript& scriptPubKey,
+                                                 interfaces::Mining& miner,
+                                                 ChainstateManager& chainman);
+    /** Copy base, paying its coinbase to scriptPubKey instead. */
+    static std::shared_ptr<CBlock> WithPayout(const Assembled& base, const CScript& scriptPubKey);
+
+    /** Drop all templates unless they build on tip. */
+    void purgeStaleLocked(const uint256& tip);
+    void eraseLocked(std::unordered_map<uint256, Entry, SaltedUint256Hasher>::iterator it);
+
+    /** Never held together with cs_main, in either order. */
     std::mutex m_cs;
-    std::unordered_map<uint256, std::shared_ptr<CBlock>, SaltedUint256Hasher> m_templates;
+    std::unordered_map<uint256, Entry, SaltedUint256Hasher> m_templates;
+    /** Newest template per payout script. */
+    std::map<CScript, uint256> m_current;
+    /** Template hashes, oldest first. */
+    std::list<uint256> m_order;
+    /** Parent block of every cached template. */
+    uint256 m_tip;
+    /** Latest assembled block for m_tip, if any. */
+    std::shared_ptr<const Assembled> m_assembled;
+    TemplateCacheStats m_stats;
 };
 
 } // namespace auxpow_miner
@@ -18,16 +18,28 @@
 #include <key_io.h>
 #include <node/context.h>
 #include <spentindex.h>
+#include <streams.h>
 #include <timestampindex.h>
+#include <tinyformat.h>
 #include <txmempool.h>
+#include <util/strencodings.h>
 #include <validation.h>
 
 #include <univalue.h>
 
 #include <cstring>
+#include <optional>
 #include <pubkey.h>
+#include <set>
 #include <string>
 
+using util::ToString;
+
+//! Page size of the cursor based address queries when no limit is given
+static constexpr size_t DEFAULT_ADDRESS_PAGE_SIZE{1000};
+//! Largest limit accepted by the cursor based address queries
+static constexpr size_t MAX_ADDRESS_PAGE_SIZE{10000};
+
 static bool getAddressFromIndex(const int& type, const uint256& hash, std::string& address)
 {
     // For types 1-3, the key is a zero-padded uint160; extract the first 20 bytes.
@@ -107,6 +119,95 @@ static bool getAddressesFromParams(const UniValue& params, std::vector<std::pair
     return true;
 }
 
+/**
+ * Where a paged address query stopped: the position of the address in the
+ * request and the last index key visited for it. Clients get it as an
+ * opaque hex string.
+ */
+template <typename Key>
+struct AddressCursor {
+    uint32_t address{0};
+    std::optional<Key> last;
+};
+
+template <typename Key>
+static std::string EncodeAddressCursor(uint32_t address, const Key& last)
+{
+    DataStream ss{};
+    ss << address << last;
+    return HexStr(ss);
+}
+
+//! Return the cursor of the request, if it asks for a page (\"\" for the first one).
+template <typename Key>
+static std::optional<AddressCursor<Key>> GetAddressCursor(const UniValue& params, const std::vector<std::pair<uint256, int>>& addresses)
+{
+    if (!params[0].isObject() || params[0]["cursor"].isNull()) return std::nullopt;
+
+    const std::string& str = params[0]["cursor"].get_str();
+    AddressCursor<Key> cursor;
+    if (str.empty()) return cursor;
+
+    const auto bytes = TryParseHex<uint8_t>(str);
+    Key last;
+    try {
+        if (!bytes) throw std::ios_base::failure("cursor is not hex");
+        DataStream ss{*bytes};
+        ss >> cursor.address >> last;
+        if (!ss.empty()) throw std::ios_base::failure("cursor has trailing data");
+    } catch (const std::ios_base::failure&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    if (cursor.address >= addresses.size() || last.hashBytes != addresses[cursor.address].first ||
+        last.type != (unsigned int)addresses[cursor.address].second)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor does not belong to these addresses");
+    cursor.last = std::move(last);
+    return cursor;
+}
+
+//! Return the page size of a cursor based query with this limit (0 for the default).
+static size_t GetAddressPageSize(int limit)
+{
+    if (limit <= 0) return DEFAULT_ADDRESS_PAGE_SIZE;
+    if ((size_t)limit > MAX_ADDRESS_PAGE_SIZE)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Limit must be at most %u with a cursor", MAX_ADDRESS_PAGE_SIZE));
+    return limit;
+}
+
+static UniValue AddressDeltaToJSON(const CAddressIndexKey& key, CAmount amount)
+{
+    std::string address;
+    if (!getAddressFromIndex(key.type, key.hashBytes, address))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+
+    UniValue delta(UniValue::VOBJ);
+    delta.pushKV("assetName", key.asset);
+    delta.pushKV("satoshis", amount);
+    delta.pushKV("txid", key.txhash.GetHex());
+    delta.pushKV("index", (int)key.index);
+    delta.pushKV("blockindex", (int)key.txindex);
+    delta.pushKV("height", key.blockHeight);
+    delta.pushKV("address", address);
+    return delta;
+}
+
+static UniValue AddressUtxoToJSON(const CAddressUnspentKey& key, const CAddressUnspentValue& value)
+{
+    std::string address;
+    if (!getAddressFromIndex(key.type, key.hashBytes, address))
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+
+    UniValue output(UniValue::VOBJ);
+    output.pushKV("address", address);
+    output.pushKV("assetName", key.asset);
+    output.pushKV("txid", key.txhash.GetHex());
+    output.pushKV("outputIndex", (int)key.index);
+    output.pushKV("script", HexStr(value.script));
+    output.pushKV("satoshis", value.satoshis);
+    output.pushKV("height", value.blockHeight);
+    return output;
+}
+
 static bool heightSort(const std::pair<CAddressUnspentKey, CAddressUnspentValue>& a,
                        const std::pair<CAddressUnspentKey, CAddressUnspentValue>& b)
 {
@@ -218,23 +319,33 @@ static RPCHelpMan getaddressutxos()
                     {"assetName", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Get UTXOs for a particular asset ('*' for all)"},
                     {"limit", RPCArg::Type::NUM, RPCArg::Default{0}, "Maximum number of UTXOs to return (0 = no limit)"},
                     {"offset", RPCArg::Type::NUM, RPCArg::Default{0}, "Number of UTXOs to skip"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Return one page of at most limit (default: " + ToString(DEFAULT_ADDRESS_PAGE_SIZE) + ", at most " + ToString(MAX_ADDRESS_PAGE_SIZE) + ") UTXOs in index order, "
+                        "continuing from the cursor of the previous page (\"\" for the first page)"},
                 },
             },
         },
-        RPCResult{RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::OBJ, "", "",
-                    {
-                        {RPCResult::Type::STR, "address", "The address"},
-                        {RPCResult::Type::STR, "assetName", "The asset name"},
-                        {RPCResult::Type::STR_HEX, "txid", "The output txid"},
-                        {RPCResult::Type::NUM, "outputIndex", "The output index"},
-                        {RPCResult::Type::STR_HEX, "script", "The script hex encoded"},
-                        {RPCResult::Type::NUM, "satoshis", "The number of satoshis"},
-                        {RPCResult::Type::NUM, "height", "The block height"},
+        {
+            RPCResult{"Default",
+                RPCResult::Type::ARR, "", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR, "address", "The address"},
+                            {RPCResult::Type::STR, "assetName", "The asset name"},
+                            {RPCResult::Type::STR_HEX, "txid", "The output txid"},
+                            {RPCResult::Type::NUM, "outputIndex", "The output index"},
+                            {RPCResult::Type::STR_HEX, "script", "The script hex encoded"},
+                            {RPCResult::Type::NUM, "satoshis", "The number of satoshis"},
+                            {RPCResult::Type::NUM, "height", "The block height"},
+                        },
                     },
-                },
-            },
+                }},
+            RPCResult{"With cursor",
+                RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::ARR, "utxos", "As in the default result", {{RPCResult::Type::ELISION, "", ""}}},
+                    {RPCResult::Type::STR, "cursor", /*optional=*/true, "Pass this to get the next page, omitted on the last page"},
+                }},
         },
         RPCExamples{
             HelpExampleCli("getaddressutxos", "'{\"addresses\": [\"MXissueAssetXXXXXXXXXXXXXXXXZGHWo\"]}'")
@@ -243,6 +354,8 @@ static RPCHelpMan getaddressutxos()
         {
             if (!g_addressindex)
                 throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled");
+            if (g_addressindex->IsUpgrading())
+                throw JSONRPCError(RPC_IN_WARMUP, "Address index is being upgraded");
 
             bool includeChainInfo = false;
             std::string assetName = "*";  // default: return all UTXOs (native coin + assets)
@@ -272,6 +385,37 @@ static RPCHelpMan getaddressutxos()
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
             }
 
+            if (const auto cursor = GetAddressCursor<CAddressUnspentKey>(request.params, addresses)) {
+                if (offset > 0)
+                    throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor and offset cannot be combined");
+                const size_t pageSize = GetAddressPageSize(limit);
+
+                UniValue utxos(UniValue::VARR);
+                std::optional<std::pair<uint32_t, CAddressUnspentKey>> last;
+                std::optional<std::string> next;
+                for (uint32_t pos = cursor->address; pos < addresses.size() && !next; pos++) {
+                    const auto& [addrHash, addrType] = addresses[pos];
+                    const CAddressUnspentKey* after = pos == cursor->address && cursor->last ? &*cursor->last : nullptr;
+                    const bool read = g_addressindex->ForEachAddressUnspent(addrHash, addrType, assetName == "*" ? "" : assetName, after,
+                        [&](const CAddressUnspentKey& key, const CAddressUnspentValue& value) {
+                            if (utxos.size() == pageSize) {
+                                next = EncodeAddressCursor(last->first, last->second);
+                                return false;
+                            }
+                            utxos.push_back(AddressUtxoToJSON(key, value));
+                            last.emplace(pos, key);
+                            return true;
+                        });
+                    if (!read)
+                        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+
+                UniValue result(UniValue::VOBJ);
+                result.pushKV("utxos", std::move(utxos));
+                if (next) result.pushKV("cursor", *next);
+                return result;
+            }
+
             std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>> unspentOutputs;
             for (const auto& [addrHash, addrType] : addresses) {
                 if (assetName == "*") {
@@ -291,19 +435,7 @@ static RPCHelpMan getaddressutxos()
             UniValue utxos(UniValue::VARR);
             for (size_t idx = startIdx; idx < endIdx; idx++) {
                 const auto& [uKey, uVal] = unspentOutputs[idx];
-                std::string address;
-                if (!getAddressFromIndex(uKey.type, uKey.hashBytes, address))
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-
-                UniValue output(UniValue::VOBJ);
-                output.pushKV("address", address);
-                output.pushKV("assetName", uKey.asset);
-                output.pushKV("txid", uKey.txhash.GetHex());
-                output.pushKV("outputIndex", (int)uKey.index);
-                output.pushKV("script", HexStr(uVal.script));
-                output.pushKV("satoshis", uVal.satoshis);
-                output.pushKV("height", uVal.blockHeight);
-                utxos.push_back(std::move(output));
+                utxos.push_back(AddressUtxoToJSON(uKey, uVal));
             }
 
             if (includeChainInfo) {
@@ -344,23 +476,33 @@ static RPCHelpMan getaddressdeltas()
                     {"assetName", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Get deltas for a particular asset ('*' for all)"},
                     {"limit", RPCArg::Type::NUM, RPCArg::Default{0}, "Maximum number of deltas (0 = no limit)"},
                     {"offset", RPCArg::Type::NUM, RPCArg::Default{0}, "Number of deltas to skip"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Return one page of at most limit (default: " + ToString(DEFAULT_ADDRESS_PAGE_SIZE) + ", at most " + ToString(MAX_ADDRESS_PAGE_SIZE) + ") deltas, "
+                        "continuing from the cursor of the previous page (\"\" for the first page)"},
                 },
             },
         },
-        RPCResult{RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::OBJ, "", "",
-                    {
-                        {RPCResult::Type::STR, "assetName", "The asset name"},
-                        {RPCResult::Type::NUM, "satoshis", "The difference of satoshis"},
-                        {RPCResult::Type::STR_HEX, "txid", "The related txid"},
-                        {RPCResult::Type::NUM, "index", "The related input or output index"},
-                        {RPCResult::Type::NUM, "blockindex", "The related block index"},
-                        {RPCResult::Type::NUM, "height", "The block height"},
-                        {RPCResult::Type::STR, "address", "The address"},
+        {
+            RPCResult{"Default",
+                RPCResult::Type::ARR, "", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR, "assetName", "The asset name"},
+                            {RPCResult::Type::NUM, "satoshis", "The difference of satoshis"},
+                            {RPCResult::Type::STR_HEX, "txid", "The related txid"},
+                            {RPCResult::Type::NUM, "index", "The related input or output index"},
+                            {RPCResult::Type::NUM, "blockindex", "The related block index"},
+                            {RPCResult::Type::NUM, "height", "The block height"},
+                            {RPCResult::Type::STR, "address", "The address"},
+                        },
                     },
-                },
-            },
+                }},
+            RPCResult{"With cursor",
+                RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::ARR, "deltas", "As in the default result", {{RPCResult::Type::ELISION, "", ""}}},
+                    {RPCResult::Type::STR, "cursor", /*optional=*/true, "Pass this to get the next page, omitted on the last page"},
+                }},
         },
         RPCExamples{
             HelpExampleCli("getaddressdeltas", "'{\"addresses\": [\"MXissueAssetXXXXXXXXXXXXXXXXZGHWo\"]}'")
@@ -369,6 +511,8 @@ static RPCHelpMan getaddressdeltas()
         {
             if (!g_addressindex)
                 throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled");
+            if (g_addressindex->IsUpgrading())
+                throw JSONRPCError(RPC_IN_WARMUP, "Address index is being upgraded");
 
             if (!request.params[0].isObject())
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "Expected object parameter");
@@ -408,6 +552,37 @@ static RPCHelpMan getaddressdeltas()
             if (!getAddressesFromParams(request.params, addresses))
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
 
+            if (const auto cursor = GetAddressCursor<CAddressIndexKey>(request.params, addresses)) {
+                if (offset > 0)
+                    throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor and offset cannot be combined");
+                const size_t pageSize = GetAddressPageSize(limit);
+
+                UniValue deltas(UniValue::VARR);
+                std::optional<std::pair<uint32_t, CAddressIndexKey>> last;
+                std::optional<std::string> next;
+                for (uint32_t pos = cursor->address; pos < addresses.size() && !next; pos++) {
+                    const auto& [addrHash, addrType] = addresses[pos];
+                    const CAddressIndexKey* after = pos == cursor->address && cursor->last ? &*cursor->last : nullptr;
+                    const bool read = g_addressindex->ForEachAddressDelta(addrHash, addrType, assetName == "*" ? "" : assetName, start, end, after,
+                        [&](const CAddressIndexKey& key, CAmount amount) {
+                            if (deltas.size() == pageSize) {
+                                next = EncodeAddressCursor(last->first, last->second);
+                                return false;
+                            }
+                            deltas.push_back(AddressDeltaToJSON(key, amount));
+                            last.emplace(pos, key);
+                            return true;
+                        });
+                    if (!read)
+                        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+
+                UniValue result(UniValue::VOBJ);
+                result.pushKV("deltas", std::move(deltas));
+                if (next) result.pushKV("cursor", *next);
+                return result;
+            }
+
             std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
             for (const auto& [addrHash, addrType] : addresses) {
                 if (assetName == "*") {
@@ -435,19 +610,7 @@ static RPCHelpMan getaddressdeltas()
             UniValue deltas(UniValue::VARR);
             for (size_t idx = startIdx; idx < endIdx; idx++) {
                 const auto& [aKey, aAmount] = addressIndex[idx];
-                std::string address;
-                if (!getAddressFromIndex(aKey.type, aKey.hashBytes, address))
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-
-                UniValue delta(UniValue::VOBJ);
-                delta.pushKV("assetName", aKey.asset);
-                delta.pushKV("satoshis", aAmount);
-                delta.pushKV("txid", aKey.txhash.GetHex());
-                delta.pushKV("index", (int)aKey.index);
-                delta.pushKV("blockindex", (int)aKey.txindex);
-                delta.pushKV("height", aKey.blockHeight);
-                delta.pushKV("address", address);
-                deltas.push_back(std::move(delta));
+                deltas.push_back(AddressDeltaToJSON(aKey, aAmount));
             }
 
             if (includeChainInfo && start > 0 && end > 0) {
@@ -510,6 +673,8 @@ static RPCHelpMan getaddressbalance()
         {
             if (!g_addressindex)
                 throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled");
+            if (g_addressindex->IsBuildingBalances())
+                throw JSONRPCError(RPC_IN_WARMUP, "Address balances are being built");
 
             std::vector<std::pair<uint256, int>> addresses;
             if (!getAddressesFromParams(request.params, addresses))
@@ -522,46 +687,27 @@ static RPCHelpMan getaddressbalance()
             if (includeAssets && !AreAssetsDeployed())
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "Assets aren't active.");
 
-            if (includeAssets) {
-                std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
-                for (const auto& [addrHash, addrType] : addresses) {
-                    if (!g_addressindex->ReadAddressIndex(addrHash, addrType, addressIndex))
-                        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-
-                std::map<std::string, std::pair<CAmount, CAmount>> balances;
-                for (const auto& [aKey, aAmount] : addressIndex) {
-                    auto& [received, balance] = balances[aKey.asset];
-                    if (aAmount > 0) received += aAmount;
-                    balance += aAmount;
-                }
+            std::map<std::string, CAddressBalance> balances;
+            for (const auto& [addrHash, addrType] : addresses) {
+                if (!g_addressindex->ReadAddressBalance(addrHash, addrType, includeAssets ? "" : MEWC, balances))
+                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
 
+            if (includeAssets) {
                 UniValue result(UniValue::VARR);
                 for (const auto& [name, amounts] : balances) {
                     UniValue balance(UniValue::VOBJ);
                     balance.pushKV("assetName", name);
-                    balance.pushKV("balance", amounts.second);
-                    balance.pushKV("received", amounts.first);
+                    balance.pushKV("balance", amounts.balance);
+                    balance.pushKV("received", amounts.received);
                     result.push_back(std::move(balance));
                 }
                 return result;
             } else {
-                std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
-                for (const auto& [addrHash, addrType] : addresses) {
-                    if (!g_addressindex->ReadAddressIndex(addrHash, addrType, MEWC, addressIndex))
-                        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-
-                CAmount balance = 0;
-                CAmount received = 0;
-                for (const auto& [aKey, aAmount] : addressIndex) {
-                    if (aAmount > 0) received += aAmount;
-                    balance += aAmount;
-                }
-
+                const CAddressBalance& amounts = balances[MEWC];
                 UniValue result(UniValue::VOBJ);
-                result.pushKV("balance", balance);
-                result.pushKV("received", received);
+                result.pushKV("balance", amounts.balance);
+                result.pushKV("received", amounts.received);
                 return result;
             }
         },
@@ -584,14 +730,25 @@ static RPCHelpMan getaddresstxids()
                     {"end", RPCArg::Type::NUM, RPCArg::Optional::OMITTED, "The end block height"},
                     {"limit", RPCArg::Type::NUM, RPCArg::Default{0}, "Maximum number of txids (0 = no limit)"},
                     {"offset", RPCArg::Type::NUM, RPCArg::Default{0}, "Number of txids to skip"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Return one page of at most limit (default: " + ToString(DEFAULT_ADDRESS_PAGE_SIZE) + ", at most " + ToString(MAX_ADDRESS_PAGE_SIZE) + ") txids, "
+                        "continuing from the cursor of the previous page (\"\" for the first page). A txid that touches several "
+                        "of the addresses or assets may be repeated on later pages"},
                 },
             },
             {"includeAssets", RPCArg::Type::BOOL, RPCArg::Default{false}, "If true, include asset transactions"},
         },
-        RPCResult{RPCResult::Type::ARR, "", "",
-            {
-                {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
-            },
+        {
+            RPCResult{"Default",
+                RPCResult::Type::ARR, "", "",
+                {
+                    {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                }},
+            RPCResult{"With cursor",
+                RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::ARR, "txids", "As in the default result", {{RPCResult::Type::ELISION, "", ""}}},
+                    {RPCResult::Type::STR, "cursor", /*optional=*/true, "Pass this to get the next page, omitted on the last page"},
+                }},
         },
         RPCExamples{
             HelpExampleCli("getaddresstxids", "'{\"addresses\": [\"MXissueAssetXXXXXXXXXXXXXXXXZGHWo\"]}'")
@@ -600,6 +757,8 @@ static RPCHelpMan getaddresstxids()
         {
             if (!g_addressindex)
                 throw JSONRPCError(RPC_MISC_ERROR, "Address index not enabled");
+            if (g_addressindex->IsUpgrading())
+                throw JSONRPCError(RPC_IN_WARMUP, "Address index is being upgraded");
 
             std::vector<std::pair<uint256, int>> addresses;
             if (!getAddressesFromParams(request.params, addresses))
@@ -626,6 +785,42 @@ static RPCHelpMan getaddresstxids()
             if (includeAssets && !AreAssetsDeployed())
                 throw JSONRPCError(RPC_INVALID_PARAMETER, "Assets aren't active.");
 
+            if (const auto cursor = GetAddressCursor<CAddressIndexKey>(request.params, addresses)) {
+                if (offset > 0)
+                    throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor and offset cannot be combined");
+                const size_t pageSize = GetAddressPageSize(limit);
+                if (start <= 0 || end <= 0) start = end = 0;
+
+                UniValue txids(UniValue::VARR);
+                std::set<uint256> seen;
+                std::optional<std::pair<uint32_t, CAddressIndexKey>> last;
+                std::optional<std::string> next;
+                for (uint32_t pos = cursor->address; pos < addresses.size() && !next; pos++) {
+                    const auto& [addrHash, addrType] = addresses[pos];
+                    const CAddressIndexKey* after = pos == cursor->address && cursor->last ? &*cursor->last : nullptr;
+                    const bool read = g_addressindex->ForEachAddressDelta(addrHash, addrType, includeAssets ? "" : MEWC, start, end, after,
+                        [&](const CAddressIndexKey& key, CAmount) {
+                            if (!seen.contains(key.txhash)) {
+                                if (txids.size() == pageSize) {
+                                    next = EncodeAddressCursor(last->first, last->second);
+                                    return false;
+                                }
+                                seen.insert(key.txhash);
+                                txids.push_back(key.txhash.GetHex());
+                            }
+                            last.emplace(pos, key);
+                            return true;
+                        });
+                    if (!read)
+                        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                }
+
+                UniValue result(UniValue::VOBJ);
+                result.pushKV("txids", std::move(txids));
+                if (next) result.pushKV("cursor", *next);
+                return result;
+            }
+
             std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
             for (const auto& [addrHash, addrType] : addresses) {
                 if (includeAssets) {
@@ -28,6 +28,7 @@
 #include <node/warnings.h>
 #include <policy/ephemeral_policy.h>
 #include <pow.h>
+#include <pow_hash.h>
 #include <rpc/auxpow_miner.h>
 #include <rpc/blockchain.h>
 #include <rpc/mining.h>
@@ -508,6 +509,16 @@ static RPCHelpMan getmininginfo()
                             {RPCResult::Type::NUM, "difficulty", "The next difficulty"},
                             {RPCResult::Type::STR_HEX, "target", "The next target"}
                         }},
+                        {RPCResult::Type::OBJ, "auxpowtemplates", "Cached createauxblock/getauxblock templates",
+                        {
+                            {RPCResult::Type::NUM, "size", "templates currently cached"},
+                            {RPCResult::Type::NUM, "capacity", "most templates kept at once"},
+                            {RPCResult::Type::NUM, "hits", "requests answered with an existing template"},
+                            {RPCResult::Type::NUM, "misses", "requests that needed a new template"},
+                            {RPCResult::Type::NUM, "payout_swaps", "new templates derived from an assembled block by replacing the coinbase payout"},
+                            {RPCResult::Type::NUM, "evictions", "templates dropped to stay within capacity"},
+                            {RPCResult::Type::NUM, "stale_purged", "templates dropped because the chain tip moved"},
+                        }},
                         (IsDeprecatedRPCEnabled("warnings") ?
                             RPCResult{RPCResult::Type::STR, "warnings", "any network and blockchain warnings (DEPRECATED)"} :
                             RPCResult{RPCResult::Type::ARR, "warnings", "any network and blockchain warnings (run with `-deprecatedrpc=warnings` to return the latest warning as a single string)",
@@ -526,6 +537,8 @@ static RPCHelpMan getmininginfo()
     NodeContext& node = EnsureAnyNodeContext(request.context);
     const CTxMemPool& mempool = EnsureMemPool(node);
     ChainstateManager& chainman = EnsureChainman(node);
+    // The auxpow template cache must not be locked while holding cs_main.
+    const auxpow_miner::TemplateCacheStats auxpow_stats{g_auxpow_templates.getStats()};
     LOCK(cs_main);
     const CChain& active_chain = chainman.ActiveChain();
     CBlockIndex& tip{*CHECK_NONFATAL(active_chain.Tip())};
@@ -554,6 +567,16 @@ static RPCHelpMan getmininginfo()
     next.pushKV("target", GetTarget(next_index, chainman.GetConsensus().powLimit).GetHex());
     obj.pushKV("next", next);
 
+    UniValue auxpow_templates(UniValue::VOBJ);
+    auxpow_templates.pushKV("size", (uint64_t)auxpow_stats.size);
+    auxpow_templates.pushKV("capacity", (uint64_t)auxpow_stats.capacity);
+    auxpow_templates.pushKV("hits", auxpow_stats.hits);
+    auxpow_templates.pushKV("misses", auxpow_stats.misses);
+    auxpow_templates.pushKV("payout_swaps", auxpow_stats.payout_swaps);
+    auxpow_templates.pushKV("evictions", auxpow_stats.evictions);
+    auxpow_templates.pushKV("stale_purged", auxpow_stats.stale_purged);
+    obj.pushKV("auxpowtemplates", std::move(auxpow_templates));
+
     if (chainman.GetParams().GetChainType() == ChainType::SIGNET) {
         const std::vector<uint8_t>& signet_challenge =
             chainman.GetConsensus().signet_challenge;
@@ -651,6 +674,62 @@ static RPCHelpMan getprioritisedtransactions()
 }
 
 
+static RPCHelpMan getpowcacheinfo()
+{
+    return RPCHelpMan{"getpowcacheinfo",
+        "Returns statistics about the shared KAWPOW/MEOWPOW epoch context cache\n"
+        "and about block header proof-of-work hashing.",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "capacity", "maximum number of epoch contexts kept (see -powepochcache)"},
+                {RPCResult::Type::ARR, "epochs", "epochs currently cached or being built, most recently used first",
+                {
+                    {RPCResult::Type::NUM, "", "epoch number"},
+                }},
+                {RPCResult::Type::NUM, "hits", "lookups served by an existing or in-flight context"},
+                {RPCResult::Type::NUM, "misses", "lookups that had to build a context"},
+                {RPCResult::Type::NUM, "builds", "epoch contexts built"},
+                {RPCResult::Type::NUM, "prebuilds", "epoch contexts built ahead of the chain tip"},
+                {RPCResult::Type::NUM, "evictions", "epoch contexts dropped to stay within capacity"},
+                {RPCResult::Type::NUM, "total_build_time_ms", "total time spent building epoch contexts"},
+                {RPCResult::Type::NUM, "last_build_time_ms", "time spent building the most recent epoch context"},
+                {RPCResult::Type::NUM, "pow_hashes_computed", "block header proof-of-work hashes computed"},
+                {RPCResult::Type::NUM, "pow_hash_memo_hits", "block header proof-of-work hashes answered from the per-header memo"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getpowcacheinfo", "")
+            + HelpExampleRpc("getpowcacheinfo", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+        {
+            const PowEpochCacheStats stats{GetPowEpochCacheStats()};
+
+            UniValue epochs{UniValue::VARR};
+            for (const int epoch_number : stats.epochs) {
+                epochs.push_back(epoch_number);
+            }
+
+            UniValue result{UniValue::VOBJ};
+            result.pushKV("capacity", (uint64_t)stats.capacity);
+            result.pushKV("epochs", std::move(epochs));
+            result.pushKV("hits", stats.hits);
+            result.pushKV("misses", stats.misses);
+            result.pushKV("builds", stats.builds);
+            result.pushKV("prebuilds", stats.prebuilds);
+            result.pushKV("evictions", stats.evictions);
+            result.pushKV("total_build_time_ms", Ticks<std::chrono::milliseconds>(stats.total_build_time));
+            result.pushKV("last_build_time_ms", Ticks<std::chrono::milliseconds>(stats.last_build_time));
+            const PowHashCounters counters{GetPowHashCounters()};
+            result.pushKV("pow_hashes_computed", counters.computed);
+            result.pushKV("pow_hash_memo_hits", counters.memo_hits);
+            return result;
+        },
+    };
+}
+
+
 // NOTE: Assumes a conclusive result; if result is inconclusive, it must be handled by caller
 static UniValue BIP22ValidationResult(const BlockValidationState& state)
 {
@@ -1308,7 +1387,7 @@ static RPCHelpMan getauxblock()
 
     // Create a block template.
     Mining& miner = EnsureMining(node);
-    uint256 hash = g_auxpow_templates.createBlock(scriptPubKey, miner, chainman);
+    uint256 hash = g_auxpow_templates.createBlock(scriptPubKey, miner, chainman, node.mempool.get());
     auto pblock = g_auxpow_templates.getBlock(hash);
     if (!pblock) {
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to create block template");
@@ -1401,7 +1480,7 @@ static RPCHelpMan createauxblock()
 
     // Create a block template.
     Mining& miner = EnsureMining(node);
-    uint256 hash = g_auxpow_templates.createBlock(scriptPubKey, miner, chainman);
+    uint256 hash = g_auxpow_templates.createBlock(scriptPubKey, miner, chainman, node.mempool.get());
     auto pblock = g_auxpow_templates.getBlock(hash);
     if (!pblock) {
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Failed to create block template");
@@ -1473,6 +1552,7 @@ void RegisterMiningRPCCommands(CRPCTable& t)
         {"mining", &getmininginfo},
         {"mining", &prioritisetransaction},
         {"mining", &getprioritisedtransactions},
+        {"mining", &getpowcacheinfo},
         {"mining", &getblocktemplate},
         {"mining", &submitblock},
         {"mining", &submitheader},
@@ -0,0 +1,525 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <addressindex.h>
+#include <addresstype.h>
+#include <assets/assets.h>
+#include <index/addressindex.h>
+#include <interfaces/chain.h>
+#include <key_io.h>
+#include <primitives/block.h>
+#include <rpc/register.h>
+#include <rpc/server.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <util/time.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+//! Exposes the hooks that BaseIndex calls, so blocks can be fed to the index directly
+class TestAddressIndex : public AddressIndex
+{
+public:
+    using AddressIndex::AddressIndex;
+    using AddressIndex::CustomInit;
+    using AddressIndex::CustomAppend;
+    using AddressIndex::CustomRemove;
+    using AddressIndex::CustomCommit;
+    using AddressIndex::GetDB;
+
+    //! Commit as BaseIndex::Commit does, without the locator
+    bool Commit()
+    {
+        CDBBatch batch(GetDB());
+        return CustomCommit(batch) && GetDB().WriteBatch(batch);
+    }
+};
+
+struct TestBlock {
+    uint256 hash;
+    int height;
+    CBlock block;
+    CBlockUndo undo;
+
+    interfaces::BlockInfo Info() const
+    {
+        interfaces::BlockInfo info{hash};
+        info.height = height;
+        info.data = &block;
+        info.undo_data = &undo;
+        return info;
+    }
+};
+
+uint256 AddressHash(uint8_t id)
+{
+    uint256 hash;
+    std::fill(hash.begin(), hash.begin() + 20, id);
+    return hash;
+}
+
+CScript PayTo(uint8_t id)
+{
+    return GetScriptForDestination(PKHash{uint160{std::vector<unsigned char>(20, id)}});
+}
+
+CScript AssetTo(uint8_t id, const std::string& name, CAmount amount)
+{
+    CScript script = PayTo(id);
+    CAssetTransfer(name, amount).ConstructTransaction(script);
+    return script;
+}
+
+constexpr uint8_t ALICE{0xaa};
+constexpr uint8_t BOB{0xbb};
+
+struct AddressIndexSetup : public BasicTestingSetup {
+    TestBlock block1;
+    TestBlock block2;
+
+    AddressIndexSetup()
+    {
+        // Block 1 pays Alice twice in its coinbase, and spends an output of Bob
+        // to pay her two outputs of CAT and one of DOG.
+        CMutableTransaction coinbase;
+        coinbase.vin.emplace_back(COutPoint{});
+        coinbase.vout.emplace_back(50 * COIN, PayTo(ALICE));
+        coinbase.vout.emplace_back(10 * COIN, PayTo(ALICE));
+        CMutableTransaction assets;
+        assets.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), 0});
+        assets.vout.emplace_back(0, AssetTo(ALICE, "CAT", 3));
+        assets.vout.emplace_back(0, AssetTo(ALICE, "CAT", 4));
+        assets.vout.emplace_back(0, AssetTo(ALICE, "DOG", 1));
+        assets.vout.emplace_back(4 * COIN, PayTo(BOB));
+        block1.hash = uint256{1};
+        block1.height = 1;
+        block1.block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(assets)};
+        block1.undo.vtxundo.emplace_back().vprevout.emplace_back(CTxOut{5 * COIN, PayTo(BOB)}, 0, false);
+
+        // Block 2 spends the first coinbase output, paying Bob and Alice.
+        CMutableTransaction coinbase2;
+        coinbase2.vin.emplace_back(COutPoint{});
+        coinbase2.vin[0].scriptSig = CScript() << 2;
+        CMutableTransaction spend;
+        spend.vin.emplace_back(COutPoint{coinbase.GetHash(), 0});
+        spend.vout.emplace_back(30 * COIN, PayTo(BOB));
+        spend.vout.emplace_back(20 * COIN, PayTo(ALICE));
+        block2.hash = uint256{2};
+        block2.height = 2;
+        block2.block.vtx = {MakeTransactionRef(coinbase2), MakeTransactionRef(spend)};
+        block2.undo.vtxundo.emplace_back().vprevout.emplace_back(coinbase.vout[0], 1, true);
+    }
+
+    std::unique_ptr<TestAddressIndex> MakeIndex(bool wipe, size_t batch_size = 0)
+    {
+        return std::make_unique<TestAddressIndex>(interfaces::MakeChain(m_node), 1 << 20, /*f_memory=*/false, wipe, batch_size);
+    }
+};
+
+//! The balances of an address by asset, as kept by the index
+std::map<std::string, CAddressBalance> Balances(AddressIndex& index, uint8_t id)
+{
+    std::map<std::string, CAddressBalance> balances;
+    BOOST_CHECK(index.ReadAddressBalance(AddressHash(id), 1, "", balances));
+    return balances;
+}
+
+//! The balances of an address by asset, summed from its deltas
+std::map<std::string, CAddressBalance> SummedDeltas(AddressIndex& index, uint8_t id)
+{
+    std::vector<std::pair<CAddressIndexKey, CAmount>> deltas;
+    BOOST_CHECK(index.ReadAddressIndex(AddressHash(id), 1, deltas));
+    std::map<std::string, CAddressBalance> balances;
+    std::set<std::pair<std::string, uint256>> txs;
+    for (const auto& [key, value] : deltas) {
+        CAddressBalance& balance = balances[key.asset];
+        balance.balance += value;
+        if (value > 0) balance.received += value;
+        if (txs.emplace(key.asset, key.txhash).second) balance.txCount++;
+    }
+    return balances;
+}
+
+void CheckBalance(const std::map<std::string, CAddressBalance>& balances, const std::string& asset,
+                  CAmount balance, CAmount received, int64_t tx_count)
+{
+    const auto it = balances.find(asset);
+    BOOST_REQUIRE(it != balances.end());
+    BOOST_CHECK_EQUAL(it->second.balance, balance);
+    BOOST_CHECK_EQUAL(it->second.received, received);
+    BOOST_CHECK_EQUAL(it->second.txCount, tx_count);
+}
+
+//! The outputs of an address in the index, by transaction and output index
+std::set<std::pair<uint256, size_t>> Unspent(AddressIndex& index, uint8_t id)
+{
+    std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>> unspent;
+    BOOST_CHECK(index.ReadAddressUnspentIndex(AddressHash(id), 1, unspent));
+    std::set<std::pair<uint256, size_t>> outputs;
+    for (const auto& [key, value] : unspent) outputs.emplace(key.txhash, key.index);
+    return outputs;
+}
+
+//! The balances kept by the index are those summed from the deltas
+void CheckMatchesDeltas(AddressIndex& index, uint8_t id)
+{
+    const auto balances = Balances(index, id);
+    const auto summed = SummedDeltas(index, id);
+    BOOST_CHECK_EQUAL(balances.size(), summed.size());
+    for (const auto& [asset, sum] : summed) {
+        CheckBalance(balances, asset, sum.balance, sum.received, sum.txCount);
+    }
+}
+//! Both blocks in g_addressindex, queried through the RPC table
+struct AddressRPCSetup : public AddressIndexSetup {
+    AddressRPCSetup()
+    {
+        RegisterAllCoreRPCCommands(tableRPC);
+        if (RPCIsInWarmup(nullptr)) SetRPCWarmupFinished();
+        auto index = MakeIndex(/*wipe=*/true);
+        BOOST_REQUIRE(index->CustomInit(std::nullopt));
+        BOOST_REQUIRE(index->CustomAppend(block1.Info()));
+        BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+        BOOST_REQUIRE(index->Commit());
+        g_addressindex = std::move(index);
+    }
+
+    ~AddressRPCSetup() { g_addressindex.reset(); }
+
+    static UniValue Query(const std::vector<uint8_t>& ids, int limit, const std::optional<std::string>& cursor)
+    {
+        UniValue addresses{UniValue::VARR};
+        for (const uint8_t id : ids) {
+            const CTxDestination dest{PKHash{uint160{std::vector<unsigned char>(20, id)}}};
+            BOOST_REQUIRE(IsValidDestination(DecodeDestination(EncodeDestination(dest))));
+            addresses.push_back(EncodeDestination(dest));
+        }
+        UniValue query{UniValue::VOBJ};
+        query.pushKV("addresses", std::move(addresses));
+        if (limit != 0) query.pushKV("limit", limit);
+        if (cursor) query.pushKV("cursor", *cursor);
+        return query;
+    }
+
+    UniValue CallRPC(const std::string& method, const UniValue& query, bool include_assets = false)
+    {
+        JSONRPCRequest request;
+        request.context = &m_node;
+        request.strMethod = method;
+        request.params = UniValue{UniValue::VARR};
+        request.params.push_back(query);
+        if (method == "getaddresstxids") request.params.push_back(include_assets);
+        try {
+            return tableRPC.execute(request);
+        } catch (const UniValue& error) {
+            throw std::runtime_error(error.find_value("message").get_str());
+        }
+    }
+
+    //! Follow the cursors of a query from the first page to the last
+    std::vector<UniValue> Pages(const std::string& method, const std::string& field, const std::vector<uint8_t>& ids,
+                                int limit, bool include_assets = false)
+    {
+        std::vector<UniValue> pages;
+        std::optional<std::string> cursor{""};
+        while (cursor) {
+            BOOST_REQUIRE(pages.size() < 100);
+            const UniValue result = CallRPC(method, Query(ids, limit, cursor), include_assets);
+            BOOST_CHECK(result[field].size() <= (size_t)limit);
+            pages.push_back(result[field]);
+            cursor.reset();
+            if (result.exists("cursor")) cursor = result["cursor"].get_str();
+        }
+        return pages;
+    }
+};
+
+//! The JSON of every entry of the pages
+std::multiset<std::string> Entries(const std::vector<UniValue>& pages)
+{
+    std::multiset<std::string> entries;
+    for (const auto& page : pages) {
+        for (const auto& entry : page.getValues()) entries.insert(entry.write());
+    }
+    return entries;
+}
+} // namespace
+
+
+BOOST_FIXTURE_TEST_SUITE(addressindex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(ordered_varint)
+{
+    const std::vector<uint32_t> values{0, 1, 127, 128, 255, 16383, 16384, 2097151, 2097152, 268435455, 268435456, UINT32_MAX};
+    const std::vector<size_t> sizes{1, 1, 1, 2, 2, 2, 3, 3, 4, 4, 5, 5};
+    std::vector<uint8_t> last;
+    for (size_t i = 0; i < values.size(); ++i) {
+        DataStream s;
+        WriteOrderedVarInt(s, values[i]);
+        BOOST_CHECK_EQUAL(s.size(), sizes[i]);
+        const std::vector<uint8_t> bytes{UCharCast(s.data()), UCharCast(s.data() + s.size())};
+        BOOST_CHECK(last < bytes);
+        last = bytes;
+        BOOST_CHECK_EQUAL(ReadOrderedVarInt(s), values[i]);
+        BOOST_CHECK(s.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compact_keys)
+{
+    uint256 hash{uint256::ONE};
+    const CAddressIndexKey key(1, hash, "CAT", 150000, 12, uint256::ONE, 3, /*isSpending=*/true);
+    DataStream s;
+    s << CAddressIndexCompactKey(key, 7);
+    // type, 20 hash bytes, asset id, 3 byte height, txindex, index, spending
+    BOOST_CHECK_EQUAL(s.size(), 1U + 20 + 1 + 3 + 1 + 1 + 1);
+    CAddressIndexCompactKey read;
+    s >> read;
+    BOOST_CHECK(read == CAddressIndexCompactKey(key, 7));
+
+    // Keys of one address and asset sort by height, then position in the block.
+    const auto serialized = [&](int height, unsigned int txindex) {
+        DataStream k;
+        k << CAddressIndexCompactKey(CAddressIndexKey(1, hash, "CAT", height, txindex, uint256::ONE, 0, false), 7);
+        return std::vector<uint8_t>{UCharCast(k.data()), UCharCast(k.data() + k.size())};
+    };
+    BOOST_CHECK(serialized(127, 500) < serialized(128, 0));
+    BOOST_CHECK(serialized(16383, 1) < serialized(16384, 0));
+    BOOST_CHECK(serialized(16384, 127) < serialized(16384, 128));
+
+    // A 32 byte hash is kept whole.
+    const CAddressUnspentKey unspent(4, uint256::ONE, uint256::ONE, 1);
+    DataStream u;
+    u << CAddressUnspentCompactKey(unspent, 0);
+    BOOST_CHECK_EQUAL(u.size(), 1U + 32 + 1 + 32 + 1);
+    CAddressUnspentCompactKey readUnspent;
+    u >> readUnspent;
+    BOOST_CHECK(readUnspent == CAddressUnspentCompactKey(unspent, 0));
+}
+
+BOOST_FIXTURE_TEST_CASE(balances_follow_deltas, AddressIndexSetup)
+{
+    auto index = MakeIndex(/*wipe=*/true);
+    BOOST_REQUIRE(index->CustomInit(std::nullopt));
+    const auto check = [&] {
+        // A transaction counts once per address and asset, however many of
+        // its inputs and outputs belong to them.
+        const auto alice = Balances(*index, ALICE);
+        CheckBalance(alice, MEWC, 30 * COIN, 80 * COIN, 2);
+        CheckBalance(alice, "CAT", 7, 7, 1);
+        CheckBalance(alice, "DOG", 1, 1, 1);
+        CheckBalance(Balances(*index, BOB), MEWC, 29 * COIN, 34 * COIN, 2);
+        for (const uint8_t id : {ALICE, BOB}) CheckMatchesDeltas(*index, id);
+    };
+
+    BOOST_REQUIRE(index->CustomAppend(block1.Info()));
+    BOOST_REQUIRE(index->Commit());
+    BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+    check();
+
+    BOOST_REQUIRE(index->CustomRemove(block2.Info()));
+    CheckBalance(Balances(*index, ALICE), MEWC, 60 * COIN, 60 * COIN, 1);
+    CheckBalance(Balances(*index, BOB), MEWC, -1 * COIN, 4 * COIN, 1);
+    for (const uint8_t id : {ALICE, BOB}) CheckMatchesDeltas(*index, id);
+    BOOST_REQUIRE(index->Commit());
+
+    BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+    BOOST_REQUIRE(index->Commit());
+    check();
+}
+
+BOOST_FIXTURE_TEST_CASE(balances_replayed_after_unclean_commit, AddressIndexSetup)
+{
+    {
+        auto index = MakeIndex(/*wipe=*/true);
+        BOOST_REQUIRE(index->CustomInit(std::nullopt));
+        BOOST_REQUIRE(index->CustomAppend(block1.Info()));
+        BOOST_REQUIRE(index->Commit());
+        BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+
+        // The commit of block 2 never reaches the disk, so the next one
+        // writes its changes.
+        CDBBatch lost(index->GetDB());
+        BOOST_REQUIRE(index->CustomCommit(lost));
+        BOOST_REQUIRE(index->Commit());
+        CheckBalance(Balances(*index, ALICE), MEWC, 30 * COIN, 80 * COIN, 2);
+
+        // Lost again, this time before a restart.
+        BOOST_REQUIRE(index->CustomRemove(block2.Info()));
+        BOOST_REQUIRE(index->Commit());
+        BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+        CDBBatch lost_again(index->GetDB());
+        BOOST_REQUIRE(index->CustomCommit(lost_again));
+    }
+
+    // After the restart block 2 is appended again, and counted once.
+    auto index = MakeIndex(/*wipe=*/false);
+    BOOST_REQUIRE(index->CustomInit(interfaces::BlockRef{block1.hash, block1.height}));
+    CheckBalance(Balances(*index, ALICE), MEWC, 60 * COIN, 60 * COIN, 1);
+    BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+    BOOST_REQUIRE(index->Commit());
+    CheckBalance(Balances(*index, ALICE), MEWC, 30 * COIN, 80 * COIN, 2);
+    CheckBalance(Balances(*index, BOB), MEWC, 29 * COIN, 34 * COIN, 2);
+    for (const uint8_t id : {ALICE, BOB}) CheckMatchesDeltas(*index, id);
+}
+
+// An index that was never started is catching up, so with a batch size it
+// collects the entries of the blocks it appends.
+BOOST_FIXTURE_TEST_CASE(batch_spent_output_erased, AddressIndexSetup)
+{
+    auto index = MakeIndex(/*wipe=*/true, /*batch_size=*/1 << 20);
+    BOOST_REQUIRE(index->CustomInit(std::nullopt));
+    BOOST_REQUIRE(index->CustomAppend(block1.Info()));
+    BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+    BOOST_CHECK(SummedDeltas(*index, ALICE).empty());
+    BOOST_CHECK(Unspent(*index, ALICE).empty());
+
+    // The first coinbase output is created and spent within the batch, and
+    // its spend is written last.
+    BOOST_REQUIRE(index->Commit());
+    const uint256 coinbase{block1.block.vtx[0]->GetHash().ToUint256()};
+    const auto alice = Unspent(*index, ALICE);
+    BOOST_CHECK(!alice.contains({coinbase, 0}));
+    BOOST_CHECK(alice.contains({coinbase, 1}));
+    BOOST_CHECK(alice.contains({block2.block.vtx[1]->GetHash().ToUint256(), 1}));
+    CheckBalance(SummedDeltas(*index, ALICE), MEWC, 30 * COIN, 80 * COIN, 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(batch_written_before_remove, AddressIndexSetup)
+{
+    auto index = MakeIndex(/*wipe=*/true, /*batch_size=*/1 << 20);
+    BOOST_REQUIRE(index->CustomInit(std::nullopt));
+    BOOST_REQUIRE(index->CustomAppend(block1.Info()));
+    BOOST_REQUIRE(index->CustomAppend(block2.Info()));
+
+    // Removing block 2 writes the batch first, so its entries are there to
+    // be erased and block 1's remain.
+    BOOST_REQUIRE(index->CustomRemove(block2.Info()));
+    const uint256 coinbase{block1.block.vtx[0]->GetHash().ToUint256()};
+    const auto alice = Unspent(*index, ALICE);
+    BOOST_CHECK(alice.contains({coinbase, 0}));
+    BOOST_CHECK_EQUAL(alice.size(), 5U);
+    CheckBalance(SummedDeltas(*index, ALICE), MEWC, 60 * COIN, 60 * COIN, 1);
+    CheckBalance(SummedDeltas(*index, BOB), MEWC, -1 * COIN, 4 * COIN, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(batch_written_before_locator, AddressIndexSetup)
+{
+    auto index = MakeIndex(/*wipe=*/true, /*batch_size=*/1 << 20);
+    BOOST_REQUIRE(index->CustomInit(std::nullopt));
+    BOOST_REQUIRE(index->CustomAppend(block1.Info()));
+    BOOST_CHECK(SummedDeltas(*index, ALICE).empty());
+
+    // The entries are on disk before the batch that would carry the best
+    // block locator is written.
+    CDBBatch batch(index->GetDB());
+    BOOST_REQUIRE(index->CustomCommit(batch));
+    CheckBalance(SummedDeltas(*index, ALICE), MEWC, 60 * COIN, 60 * COIN, 1);
+    BOOST_CHECK_EQUAL(Unspent(*index, ALICE).size(), 5U);
+}
+
+BOOST_FIXTURE_TEST_CASE(balances_built_in_background, AddressIndexSetup)
+{
+    // An index of version 1 without balances, with the deltas of Alice in
+    // blocks 1 and 2.
+    {
+        auto index = MakeIndex(/*wipe=*/true);
+        const auto write = [&](int height, const uint256& txhash, size_t index_out, bool spending, CAmount value) {
+            const CAddressIndexKey key(1, AddressHash(ALICE), height, 1, txhash, index_out, spending);
+            BOOST_REQUIRE(index->GetDB().Write(std::make_pair(uint8_t{'a'}, key), value));
+        };
+        write(1, uint256{0x10}, 0, false, 50 * COIN);
+        write(1, uint256{0x10}, 1, false, 10 * COIN);
+        write(2, uint256{0x20}, 0, true, -50 * COIN);
+    }
+
+    // The balances are built for block 1 while the index keeps following the
+    // chain, and nothing is committed until they are.
+    auto index = MakeIndex(/*wipe=*/false);
+    BOOST_REQUIRE(index->CustomInit(interfaces::BlockRef{block1.hash, block1.height}));
+    for (int i = 0; i < 1000 && (index->IsBuildingBalances() || index->IsUpgrading()); ++i) {
+        UninterruptibleSleep(std::chrono::milliseconds{10});
+    }
+    BOOST_REQUIRE(!index->IsBuildingBalances());
+    BOOST_REQUIRE(!index->IsUpgrading());
+    CheckBalance(Balances(*index, ALICE), MEWC, 60 * COIN, 60 * COIN, 1);
+    BOOST_CHECK(index->Commit());
+    BOOST_CHECK(index->GetDB().Exists(uint8_t{'c'}));
+}
+
+BOOST_FIXTURE_TEST_CASE(address_cursor_pages, AddressRPCSetup)
+{
+    // Resuming from each cursor returns every entry once.
+    const UniValue deltas = CallRPC("getaddressdeltas", Query({ALICE, BOB}, 0, std::nullopt));
+    BOOST_CHECK_EQUAL(deltas.size(), 10U);
+    const auto delta_pages = Pages("getaddressdeltas", "deltas", {ALICE, BOB}, 3);
+    BOOST_CHECK_EQUAL(delta_pages.size(), 4U);
+    BOOST_CHECK(Entries(delta_pages) == Entries({deltas}));
+
+    const UniValue utxos = CallRPC("getaddressutxos", Query({ALICE, BOB}, 0, std::nullopt));
+    BOOST_CHECK_EQUAL(utxos.size(), 7U);
+    const auto utxo_pages = Pages("getaddressutxos", "utxos", {ALICE, BOB}, 2);
+    BOOST_CHECK_EQUAL(utxo_pages.size(), 4U);
+    BOOST_CHECK(Entries(utxo_pages) == Entries({utxos}));
+
+    // The same page has the same cursor.
+    const UniValue first = CallRPC("getaddressdeltas", Query({ALICE, BOB}, 3, ""));
+    BOOST_CHECK(IsHex(first["cursor"].get_str()));
+    BOOST_CHECK_EQUAL(CallRPC("getaddressdeltas", Query({ALICE, BOB}, 3, ""))["cursor"].get_str(), first["cursor"].get_str());
+}
+
+BOOST_FIXTURE_TEST_CASE(address_cursor_txids_repeat, AddressRPCSetup)
+{
+    // Block 2 spends to Bob in a transaction Alice is in too. It is on the
+    // first page for Alice and again on the second for Bob.
+    const UniValue txids = CallRPC("getaddresstxids", Query({ALICE, BOB}, 0, std::nullopt));
+    BOOST_CHECK_EQUAL(txids.size(), 3U);
+    const auto pages = Pages("getaddresstxids", "txids", {ALICE, BOB}, 2);
+    BOOST_REQUIRE_EQUAL(pages.size(), 2U);
+    const std::string spend{block2.block.vtx[1]->GetHash().GetHex()};
+    BOOST_CHECK_EQUAL(pages[0][1].get_str(), spend);
+    BOOST_CHECK_EQUAL(pages[1][1].get_str(), spend);
+    const auto entries = Entries(pages);
+    BOOST_CHECK_EQUAL(entries.size(), 4U);
+    const auto unpaged = Entries({txids});
+    BOOST_CHECK(std::set<std::string>(entries.begin(), entries.end()) == std::set<std::string>(unpaged.begin(), unpaged.end()));
+
+    // Within a page a txid is listed once, for every asset it moves.
+    const auto asset_pages = Pages("getaddresstxids", "txids", {ALICE}, 10, /*include_assets=*/true);
+    BOOST_REQUIRE_EQUAL(asset_pages.size(), 1U);
+    BOOST_CHECK_EQUAL(asset_pages[0].size(), 3U);
+}
+
+BOOST_FIXTURE_TEST_CASE(address_cursor_rejected, AddressRPCSetup)
+{
+    const std::string cursor{CallRPC("getaddressdeltas", Query({ALICE, BOB}, 3, ""))["cursor"].get_str()};
+    for (const std::string& bad : {std::string{"zz"}, cursor.substr(0, 6), cursor + "00"}) {
+        BOOST_CHECK_EXCEPTION(CallRPC("getaddressdeltas", Query({ALICE, BOB}, 3, bad)), std::runtime_error, HasReason("Invalid cursor"));
+    }
+    BOOST_CHECK_EXCEPTION(CallRPC("getaddressdeltas", Query({BOB}, 3, cursor)), std::runtime_error,
+                          HasReason("Cursor does not belong to these addresses"));
+
+    // The page size is bounded.
+    for (const auto& [method, field] : {std::pair{"getaddressdeltas", "deltas"}, std::pair{"getaddresstxids", "txids"}, std::pair{"getaddressutxos", "utxos"}}) {
+        BOOST_CHECK_EXCEPTION(CallRPC(method, Query({ALICE}, 10001, "")), std::runtime_error,
+                              HasReason("Limit must be at most 10000 with a cursor"));
+        BOOST_CHECK(!CallRPC(method, Query({ALICE}, 10000, ""))[field].empty());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <addresstype.h>
+#include <assets/assets.h>
+#include <assets/assettypes.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <key_io.h>
+#include <memusage.h>
+#include <script/script.h>
+#include <streams.h>
+#include <test/util/assets.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/strencodings.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(asset_coin_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(asset_output_decoded_once)
+{
+    const PKHash holder{uint160{m_rng.randbytes(20)}};
+    CScript script{GetScriptForDestination(holder)};
+    CAssetTransfer("MEOW", 5 * COIN).ConstructTransaction(script);
+    const Coin coin{CTxOut{0, script}, 100, false};
+
+    const CAssetOutputEntry* data{GetAssetOutput(coin)};
+    BOOST_REQUIRE(data);
+    CAssetOutputEntry parsed;
+    BOOST_REQUIRE(GetAssetData(script, parsed));
+    BOOST_CHECK_EQUAL(data->type, TX_TRANSFER_ASSET);
+    BOOST_CHECK_EQUAL(data->assetName, "MEOW");
+    BOOST_CHECK_EQUAL(data->nAmount, 5 * COIN);
+    BOOST_CHECK(data->destination == parsed.destination);
+
+    // Later lookups and copies of the coin reuse the decoded entry.
+    BOOST_CHECK_EQUAL(GetAssetOutput(coin), data);
+    const Coin copy{coin};
+    BOOST_CHECK_EQUAL(GetAssetOutput(copy), data);
+    std::string name;
+    CAmount amount;
+    BOOST_CHECK(GetAssetInfoFromCoin(copy, name, amount));
+    BOOST_CHECK_EQUAL(name, "MEOW");
+    BOOST_CHECK_EQUAL(amount, 5 * COIN);
+
+    // The entry is not serialized; a coin read back decodes its own.
+    DataStream stream;
+    stream << coin;
+    Coin read;
+    stream >> read;
+    const CAssetOutputEntry* read_data{GetAssetOutput(read)};
+    BOOST_REQUIRE(read_data);
+    BOOST_CHECK(read_data != data);
+    BOOST_CHECK_EQUAL(read_data->assetName, "MEOW");
+
+    Coin cleared{coin};
+    cleared.Clear();
+    BOOST_CHECK(!GetAssetOutput(cleared));
+
+    const Coin plain{CTxOut{COIN, GetScriptForDestination(holder)}, 100, false};
+    BOOST_CHECK(!GetAssetOutput(plain));
+}
+
+BOOST_AUTO_TEST_CASE(asset_output_memory_usage)
+{
+    const PKHash holder{uint160{m_rng.randbytes(20)}};
+    CScript script{GetScriptForDestination(holder)};
+    CAssetTransfer("MEOW", 5 * COIN).ConstructTransaction(script);
+    const Coin coin{CTxOut{0, script}, 100, false};
+
+    // The decoded entry is counted before it is filled, so the usage of a
+    // cached coin stays the same when it is.
+    const size_t usage{coin.DynamicMemoryUsage()};
+    BOOST_CHECK(usage > memusage::DynamicUsage(script) + sizeof(CAssetOutputEntry));
+    BOOST_REQUIRE(GetAssetOutput(coin));
+    BOOST_CHECK_EQUAL(coin.DynamicMemoryUsage(), usage);
+
+    const CScript plain{GetScriptForDestination(holder)};
+    BOOST_CHECK_EQUAL((Coin{CTxOut{COIN, plain}, 100, false}.DynamicMemoryUsage()), memusage::DynamicUsage(plain));
+
+    CCoinsView base;
+    CCoinsViewCache cache{&base};
+    const COutPoint outpoint{Txid::FromUint256(m_rng.rand256()), 0};
+    cache.AddCoin(outpoint, Coin{CTxOut{0, script}, 100, false}, /*possible_overwrite=*/false);
+    const size_t cache_usage{cache.DynamicMemoryUsage()};
+    BOOST_REQUIRE(GetAssetOutput(cache.AccessCoin(outpoint)));
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), cache_usage);
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    cache.SanityCheck();
+}
+
+BOOST_AUTO_TEST_CASE(spend_to_base58_address_with_bech32_prefix)
+{
+    // Find a base58 address that starts with the bech32 prefix.
+    PKHash holder;
+    std::string address;
+    do {
+        holder = PKHash{uint160{m_rng.randbytes(20)}};
+        address = EncodeDestination(holder);
+    } while (ToLower(address).rfind(Params().Bech32HRP(), 0) != 0);
+    BOOST_REQUIRE(DecodeDestination(address) == CTxDestination{holder});
+
+    CScript script{GetScriptForDestination(holder)};
+    CAssetTransfer("MEOW", 5 * COIN).ConstructTransaction(script);
+    const Coin coin{CTxOut{0, script}, 100, false};
+    const CAssetOutputEntry* data{GetAssetOutput(coin)};
+    BOOST_REQUIRE(data);
+    BOOST_CHECK(data->destination == CTxDestination{holder});
+
+    // Spending the output lowers the balance of the address in the asset index.
+    AssetsCacheGuard guard;
+    const bool prev_asset_index{fAssetIndex};
+    fAssetIndex = true;
+    CAssetsCache cache;
+    cache.mapAssetsAddressAmount[{"MEOW", address}] = 8 * COIN;
+    const bool spent{cache.TrySpendCoin(COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, coin)};
+    fAssetIndex = prev_asset_index;
+    BOOST_REQUIRE(spent);
+    BOOST_CHECK_EQUAL(cache.mapAssetsAddressAmount.at({"MEOW", address}), 3 * COIN);
+    BOOST_REQUIRE_EQUAL(cache.vSpentAssets.size(), 1U);
+    BOOST_CHECK_EQUAL(cache.vSpentAssets[0].address, address);
+    BOOST_CHECK_EQUAL(cache.vSpentAssets[0].nAmount, 5 * COIN);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
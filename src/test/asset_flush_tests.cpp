@@ -0,0 +1,111 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <assets/assets.h>
+#include <assets/assettypes.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+//! Points passets at a fresh cache for the duration of a test.
+struct AssetsLayerSetup : public BasicTestingSetup {
+    std::unique_ptr<CAssetsCache> m_base{std::make_unique<CAssetsCache>()};
+    CAssetsCache* m_prev{passets};
+
+    AssetsLayerSetup() { passets = m_base.get(); }
+    ~AssetsLayerSetup() { passets = m_prev; }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(asset_flush_tests, AssetsLayerSetup)
+
+BOOST_AUTO_TEST_CASE(flush_moves_deltas)
+{
+    CNewAsset cat;
+    cat.strName = "CAT";
+    CNewAsset dog;
+    dog.strName = "DOG";
+    m_base->setNewAssetsToRemove.insert(CAssetCacheNewAsset(cat, "", 0, uint256()));
+    m_base->mapAssetsAddressAmount[{"CAT", "addr"}] = 1;
+    m_base->vSpentAssets.emplace_back("DOG", "addr", 2);
+
+    CAssetsCache block;
+    block.setNewAssetsToAdd.insert(CAssetCacheNewAsset(cat, "", 10, uint256()));
+    block.setNewAssetsToRemove.insert(CAssetCacheNewAsset(dog, "", 10, uint256()));
+    block.mapAssetsAddressAmount[{"CAT", "addr"}] = 5;
+    block.mapAssetsAddressAmount[{"DOG", "addr"}] = 7;
+    block.vSpentAssets.emplace_back("CAT", "addr", 3);
+    block.mapRootQualifierAddressesAdd[CAssetCacheRootQualifierChecker("#KYC", "addr")].insert("#KYC/A");
+    BOOST_REQUIRE(block.Flush());
+
+    BOOST_CHECK_EQUAL(m_base->setNewAssetsToAdd.size(), 1U);
+    BOOST_CHECK_EQUAL(m_base->setNewAssetsToRemove.size(), 1U);
+    BOOST_CHECK_EQUAL(m_base->setNewAssetsToRemove.begin()->asset.strName, "DOG");
+    BOOST_CHECK_EQUAL((m_base->mapAssetsAddressAmount[{"CAT", "addr"}]), 5);
+    BOOST_CHECK_EQUAL((m_base->mapAssetsAddressAmount[{"DOG", "addr"}]), 7);
+    BOOST_REQUIRE_EQUAL(m_base->vSpentAssets.size(), 2U);
+    BOOST_CHECK_EQUAL(m_base->vSpentAssets[0].assetName, "DOG");
+    BOOST_CHECK_EQUAL(m_base->vSpentAssets[1].assetName, "CAT");
+    BOOST_CHECK_EQUAL(m_base->mapRootQualifierAddressesAdd.size(), 1U);
+
+    // The block layer is left empty and can be reused.
+    BOOST_CHECK(block.setNewAssetsToAdd.empty());
+    BOOST_CHECK(block.mapAssetsAddressAmount.empty());
+    BOOST_CHECK(block.vSpentAssets.empty());
+    BOOST_CHECK(block.mapRootQualifierAddressesAdd.empty());
+}
+
+BOOST_AUTO_TEST_CASE(flush_replaces_qualifier_flag)
+{
+    m_base->setNewQualifierAddressToAdd.insert(CAssetCacheQualifierAddress("#KYC", "addr", QualifierType::ADD_QUALIFIER));
+
+    CAssetsCache block;
+    block.setNewQualifierAddressToAdd.insert(CAssetCacheQualifierAddress("#KYC", "addr", QualifierType::REMOVE_QUALIFIER));
+    BOOST_REQUIRE(block.Flush());
+
+    BOOST_REQUIRE_EQUAL(m_base->setNewQualifierAddressToAdd.size(), 1U);
+    BOOST_CHECK(m_base->setNewQualifierAddressToAdd.begin()->type == QualifierType::REMOVE_QUALIFIER);
+
+    CAssetsCache undo;
+    undo.setNewQualifierAddressToRemove.insert(CAssetCacheQualifierAddress("#KYC", "addr", QualifierType::REMOVE_QUALIFIER));
+    BOOST_REQUIRE(undo.Flush());
+    BOOST_CHECK(m_base->setNewQualifierAddressToAdd.empty());
+    BOOST_CHECK_EQUAL(m_base->setNewQualifierAddressToRemove.size(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(balance_map_by_address)
+{
+    CAssetBalanceMap balances;
+    balances[{"CAT", "addr1"}] = 1;
+    balances.insert(std::make_pair(std::make_pair(std::string{"DOG"}, std::string{"addr1"}), 2));
+    balances[{"DOG", "addr2"}] = 3;
+
+    CAssetBalanceMap block;
+    block[{"CAT", "addr1"}] = 4;
+    block[{"EEL", "addr1"}] = 5;
+    balances.Merge(block);
+    BOOST_CHECK(block.empty());
+
+    std::vector<std::pair<std::string, CAmount>> held;
+    balances.ForEachAsset("addr1", [&](const std::string& asset, CAmount amount) { held.emplace_back(asset, amount); });
+    const std::vector<std::pair<std::string, CAmount>> expected{{"CAT", 4}, {"DOG", 2}, {"EEL", 5}};
+    BOOST_CHECK(held == expected);
+
+    std::vector<std::string> holders;
+    balances.ForEachAddress("DOG", [&](const std::string& address, CAmount) { holders.push_back(address); });
+    BOOST_CHECK((holders == std::vector<std::string>{"addr1", "addr2"}));
+
+    balances.clear();
+    held.clear();
+    balances.ForEachAsset("addr1", [&](const std::string& asset, CAmount amount) { held.emplace_back(asset, amount); });
+    BOOST_CHECK(held.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <assets/assetlookup.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <string>
+
+BOOST_FIXTURE_TEST_SUITE(asset_lookup_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(put_get_erase)
+{
+    AssetLookupTable<std::string, int8_t> cache(1 << 20);
+    BOOST_CHECK(!cache.Get("CAT"));
+    cache.Put("CAT", 1);
+    cache.Put("DOG", 2);
+    BOOST_CHECK_EQUAL(*cache.Get("CAT"), 1);
+    BOOST_CHECK(cache.Exists("DOG"));
+
+    cache.Put("CAT", 3);
+    BOOST_CHECK_EQUAL(*cache.Get("CAT"), 3);
+    cache.Erase("CAT");
+    BOOST_CHECK(!cache.Exists("CAT"));
+    BOOST_CHECK(cache.Exists("DOG"));
+
+    const AssetLookupStats stats{cache.GetStats()};
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.hits, 4U);
+    BOOST_CHECK_EQUAL(stats.misses, 2U);
+    BOOST_CHECK_EQUAL(stats.evictions, 0U);
+
+    cache.Clear();
+    BOOST_CHECK(!cache.Exists("DOG"));
+    const AssetLookupTable<std::string, int8_t> empty(1 << 20);
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), empty.DynamicMemoryUsage());
+}
+
+BOOST_AUTO_TEST_CASE(slot_arrays_grow_and_shrink)
+{
+    AssetLookupTable<std::string, CDatabasedAssetData> cache(16 << 20);
+    const size_t empty_usage{cache.DynamicMemoryUsage()};
+    BOOST_CHECK(empty_usage > 0);
+
+    // Long names so the entries own heap memory besides their slots.
+    const auto name = [](int i) { return "LONG_ASSET_NAME_" + std::to_string(i); };
+    CDatabasedAssetData data;
+    data.asset.strIPFSHash = std::string(46, 'Q');
+    size_t heap_usage{0};
+    for (int i = 0; i < 4000; ++i) {
+        data.asset.strName = name(i);
+        cache.Put(name(i), data);
+        heap_usage += memusage::DynamicUsage(name(i)) + AssetLookupValueUsage(data);
+    }
+    BOOST_REQUIRE_EQUAL(cache.GetStats().entries, 4000U);
+    // Slots are counted whether used or not, at least 4/3 per entry.
+    const size_t full_usage{cache.DynamicMemoryUsage()};
+    BOOST_CHECK_EQUAL(cache.GetStats().usage, full_usage);
+    BOOST_CHECK(full_usage >= heap_usage + 4000 * 4 / 3 * sizeof(CDatabasedAssetData));
+
+    // Erasing shrinks the slot arrays again.
+    for (int i = 0; i < 4000; ++i) {
+        cache.Erase(name(i));
+    }
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 0U);
+    BOOST_CHECK_EQUAL(cache.DynamicMemoryUsage(), empty_usage);
+}
+
+BOOST_AUTO_TEST_CASE(memory_budget)
+{
+    // Random puts and erases against a reference map: every cached entry must
+    // hold the latest value put, and the budget must never be exceeded.
+    AssetLookupTable<std::string, int8_t> cache(64 << 10);
+    std::map<std::string, int8_t> reference;
+    for (int i = 0; i < 20000; ++i) {
+        const std::string key{"ASSET" + std::to_string(m_rng.randrange(4000))};
+        if (m_rng.randrange(8) == 0) {
+            cache.Erase(key);
+            reference.erase(key);
+        } else {
+            const int8_t value = m_rng.randbits(7);
+            cache.Put(key, value);
+            reference[key] = value;
+        }
+        BOOST_REQUIRE(cache.DynamicMemoryUsage() <= cache.MaxMemoryUsage());
+    }
+
+    size_t cached{0};
+    for (const auto& [key, value] : reference) {
+        if (const auto found{cache.Get(key)}) {
+            BOOST_CHECK_EQUAL(*found, value);
+            ++cached;
+        }
+    }
+    const AssetLookupStats stats{cache.GetStats()};
+    BOOST_CHECK_EQUAL(stats.entries, cached);
+    BOOST_CHECK(stats.evictions > 0);
+    BOOST_CHECK(cached < reference.size());
+}
+
+BOOST_AUTO_TEST_CASE(clock_keeps_referenced_entries)
+{
+    AssetLookupTable<std::string, int8_t> cache(32 << 10);
+    cache.Put("HOT", 1);
+    for (int i = 0; i < 10000; ++i) {
+        cache.Put("COLD" + std::to_string(i), 0);
+        BOOST_REQUIRE(cache.Exists("HOT"));
+    }
+    BOOST_CHECK(cache.GetStats().evictions > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
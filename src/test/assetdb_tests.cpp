@@ -0,0 +1,326 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <addresstype.h>
+#include <assets/assetdb.h>
+#include <assets/assets.h>
+#include <assets/assetsnapshotdb.h>
+#include <assets/assettypes.h>
+#include <assets/restricteddb.h>
+#include <assets/snapshotrequestdb.h>
+#include <key_io.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(assetdb_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(pending_restricted_batch_replay)
+{
+    CAssetsDB assetsdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    CRestrictedDB restricteddb(m_path_root, 1 << 20, /*fMemory=*/true);
+    restricteddb.WriteGlobalRestriction("$OLD");
+
+    CRestrictedDBBatch restricted;
+    restricted.WriteVerifier("$TOKEN", "#KYC");
+    restricted.WriteAddressQualifier("Maddress", "#KYC");
+    restricted.WriteQualifierAddress("Maddress", "#KYC");
+    restricted.WriteRestrictedAddress("Mfrozen", "$TOKEN");
+    restricted.WriteGlobalRestriction("$TOKEN");
+    restricted.EraseGlobalRestriction("$OLD");
+    // Later changes to the same key win, as they did with separate writes.
+    restricted.WriteRestrictedAddress("Mthawed", "$TOKEN");
+    restricted.EraseRestrictedAddress("Mthawed", "$TOKEN");
+
+    // Commit the asset side only, as if the node stopped before writing the
+    // restricted database.
+    const uint256 best_block{uint256::ONE};
+    CDBBatch batch(assetsdb);
+    assetsdb.WriteAssetAddressQuantity(batch, "$TOKEN", "Maddress", 5);
+    BOOST_REQUIRE(assetsdb.WriteFlushBatch(batch, restricted, best_block));
+
+    uint256 read_best_block;
+    BOOST_CHECK(assetsdb.ReadBestBlock(read_best_block));
+    BOOST_CHECK_EQUAL(read_best_block, best_block);
+    CAmount quantity;
+    BOOST_CHECK(assetsdb.ReadAssetAddressQuantity("$TOKEN", "Maddress", quantity));
+    BOOST_CHECK_EQUAL(quantity, 5);
+    BOOST_CHECK(!restricteddb.ReadGlobalRestriction("$TOKEN"));
+
+    // Startup replay.
+    CRestrictedDBBatch pending;
+    BOOST_REQUIRE(assetsdb.ReadPendingRestrictedBatch(pending));
+    BOOST_REQUIRE(restricteddb.WriteFlushBatch(pending));
+    BOOST_REQUIRE(assetsdb.ErasePendingRestrictedBatch());
+    BOOST_CHECK(!assetsdb.ReadPendingRestrictedBatch(pending));
+
+    std::string verifier;
+    BOOST_CHECK(restricteddb.ReadVerifier("$TOKEN", verifier));
+    BOOST_CHECK_EQUAL(verifier, "#KYC");
+    BOOST_CHECK(restricteddb.ReadAddressQualifier("Maddress", "#KYC"));
+    BOOST_CHECK(restricteddb.ReadQualifierAddress("Maddress", "#KYC"));
+    BOOST_CHECK(restricteddb.ReadRestrictedAddress("Mfrozen", "$TOKEN"));
+    BOOST_CHECK(!restricteddb.ReadRestrictedAddress("Mthawed", "$TOKEN"));
+    BOOST_CHECK(restricteddb.ReadGlobalRestriction("$TOKEN"));
+    BOOST_CHECK(!restricteddb.ReadGlobalRestriction("$OLD"));
+}
+
+BOOST_AUTO_TEST_CASE(address_key_round_trip)
+{
+    const std::vector<CTxDestination> destinations{
+        PKHash{uint160{m_rng.randbytes(20)}},
+        ScriptHash{uint160{m_rng.randbytes(20)}},
+        WitnessV0KeyHash{uint160{m_rng.randbytes(20)}},
+        WitnessV0ScriptHash{uint256{m_rng.randbytes(32)}},
+    };
+    for (const CTxDestination& dest : destinations) {
+        const std::string address{EncodeDestination(dest)};
+        const CAssetAddressKey key{CAssetAddressKey::FromString(address)};
+        BOOST_CHECK(key == CAssetAddressKey::FromDestination(dest));
+        BOOST_CHECK_EQUAL(key.ToString(), address);
+        // The hash is stored instead of the encoded address.
+        BOOST_CHECK(GetSerializeSize(key) < address.size());
+    }
+
+    // Anything that is not a known address is kept as it was given.
+    for (const std::string address : {"", "not an address", "Maddress"}) {
+        BOOST_CHECK_EQUAL(CAssetAddressKey::FromString(address).ToString(), address);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(upgrade_address_quantity_keys)
+{
+    CAssetsDB assetsdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    const std::string address{EncodeDestination(PKHash{uint160{m_rng.randbytes(20)}})};
+    const std::vector<std::pair<std::string, std::string>> balances{{"CAT", address}, {"DOG", address}, {"DOG", "Mlegacy"}};
+    for (const auto& [asset, holder] : balances) {
+        BOOST_REQUIRE(assetsdb.Write(std::make_pair(uint8_t{'B'}, std::make_pair(asset, holder)), CAmount{7}));
+        BOOST_REQUIRE(assetsdb.Write(std::make_pair(uint8_t{'C'}, std::make_pair(holder, asset)), CAmount{7}));
+    }
+
+    BOOST_REQUIRE(assetsdb.UpgradeAddressQuantityKeys());
+    for (const auto& [asset, holder] : balances) {
+        CAmount quantity;
+        BOOST_CHECK(assetsdb.ReadAssetAddressQuantity(asset, holder, quantity));
+        BOOST_CHECK_EQUAL(quantity, 7);
+        BOOST_CHECK(assetsdb.ReadAddressAssetQuantity(holder, asset, quantity));
+        BOOST_CHECK(!assetsdb.Exists(std::make_pair(uint8_t{'B'}, std::make_pair(asset, holder))));
+        BOOST_CHECK(!assetsdb.Exists(std::make_pair(uint8_t{'C'}, std::make_pair(holder, asset))));
+    }
+
+    std::vector<std::pair<std::string, CAmount>> holdings;
+    int total;
+    BOOST_REQUIRE(assetsdb.AddressDir(holdings, total, /*fGetTotal=*/false, address, /*count=*/10, /*start=*/0));
+    BOOST_REQUIRE_EQUAL(holdings.size(), 2U);
+    BOOST_CHECK_EQUAL(holdings[0].first, "CAT");
+    BOOST_CHECK_EQUAL(holdings[1].first, "DOG");
+
+    std::vector<std::pair<std::string, CAmount>> holders;
+    BOOST_REQUIRE(assetsdb.AssetAddressDir(holders, total, /*fGetTotal=*/true, "DOG", /*count=*/10, /*start=*/0));
+    BOOST_CHECK_EQUAL(total, 2);
+    BOOST_REQUIRE(assetsdb.AssetAddressDir(holders, total, /*fGetTotal=*/false, "DOG", /*count=*/10, /*start=*/-1));
+    BOOST_REQUIRE_EQUAL(holders.size(), 1U);
+
+    // Running the upgrade again finds nothing left to do.
+    BOOST_CHECK(assetsdb.UpgradeAddressQuantityKeys());
+    BOOST_CHECK(assetsdb.EraseAllAddressQuantities());
+    CAmount quantity;
+    BOOST_CHECK(!assetsdb.ReadAssetAddressQuantity("CAT", address, quantity));
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_requests_by_height)
+{
+    CSnapshotRequestDB requestdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    // Under the old string keys "1" + "0CAT" and "10" + "CAT" collided.
+    BOOST_REQUIRE(requestdb.ScheduleSnapshot("0CAT", 1));
+    BOOST_REQUIRE(requestdb.ScheduleSnapshot("CAT", 10));
+    BOOST_REQUIRE(requestdb.ScheduleSnapshot("DOG", 10));
+    BOOST_REQUIRE(requestdb.ScheduleSnapshot("CAT", 256));
+
+    std::set<CSnapshotRequestDBEntry> requests;
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequestsForHeight("", 10, requests));
+    BOOST_CHECK_EQUAL(requests.size(), 2U);
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequestsForHeight("CAT", 10, requests));
+    BOOST_REQUIRE_EQUAL(requests.size(), 1U);
+    BOOST_CHECK_EQUAL(requests.begin()->heightForSnapshot, 10);
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequestsForHeight("CAT", 0, requests));
+    BOOST_CHECK_EQUAL(requests.size(), 2U);
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequestsForHeight("", 0, requests));
+    BOOST_CHECK_EQUAL(requests.size(), 4U);
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequestsForHeight("", 11, requests));
+    BOOST_CHECK(requests.empty());
+
+    BOOST_CHECK(requestdb.ContainsSnapshotRequest("DOG", 10));
+    BOOST_REQUIRE(requestdb.RemoveSnapshotRequest("DOG", 10));
+    BOOST_CHECK(!requestdb.ContainsSnapshotRequest("DOG", 10));
+}
+
+BOOST_AUTO_TEST_CASE(upgrade_snapshot_request_keys)
+{
+    CSnapshotRequestDB requestdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    for (const int height : {5, 300}) {
+        const CSnapshotRequestDBEntry request("CAT", height);
+        BOOST_REQUIRE(requestdb.Write(std::make_pair(uint8_t{'S'}, request.heightAndName), request));
+    }
+
+    BOOST_REQUIRE(requestdb.UpgradeSnapshotRequestKeys());
+    CSnapshotRequestDBEntry request;
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequest("CAT", 300, request));
+    BOOST_CHECK_EQUAL(request.assetName, "CAT");
+    BOOST_CHECK(!requestdb.Exists(std::make_pair(uint8_t{'S'}, std::string{"300CAT"})));
+
+    std::set<CSnapshotRequestDBEntry> requests;
+    BOOST_REQUIRE(requestdb.RetrieveSnapshotRequestsForHeight("", 5, requests));
+    BOOST_CHECK_EQUAL(requests.size(), 1U);
+    BOOST_CHECK(requestdb.UpgradeSnapshotRequestKeys());
+}
+
+BOOST_AUTO_TEST_CASE(ownership_snapshot_chunks)
+{
+    CAssetsDB assetsdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    CAssetSnapshotDB snapshotdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    std::map<std::string, CAmount> holders;
+    for (size_t i = 0; i < SNAPSHOT_CHUNK_SIZE + 5; ++i) {
+        const std::string address{EncodeDestination(PKHash{uint160{m_rng.randbytes(20)}})};
+        holders.emplace(address, CAmount(i + 1));
+        BOOST_REQUIRE(assetsdb.WriteAssetAddressQuantity("CAT", address, CAmount(i + 1)));
+    }
+    BOOST_REQUIRE(assetsdb.WriteAssetAddressQuantity("DOG", holders.begin()->first, 1));
+
+    CAssetsDB* const prev_assetsdb{passetsdb};
+    passetsdb = &assetsdb;
+    const bool added{snapshotdb.AddAssetOwnershipSnapshot("CAT", 100)};
+    passetsdb = prev_assetsdb;
+    BOOST_REQUIRE(added);
+
+    CAssetSnapshotDBEntry snapshot;
+    BOOST_REQUIRE(snapshotdb.RetrieveOwnershipSnapshot("CAT", 100, snapshot));
+    BOOST_CHECK_EQUAL(snapshot.assetName, "CAT");
+    BOOST_REQUIRE_EQUAL(snapshot.ownersAndAmounts.size(), holders.size());
+    for (const auto& [address, amount] : snapshot.ownersAndAmounts) {
+        BOOST_CHECK_EQUAL(holders.at(address), amount);
+    }
+
+    size_t visited{0};
+    BOOST_CHECK(snapshotdb.ForEachSnapshotOwner("CAT", 100, [&](const std::string& address, CAmount amount) {
+        ++visited;
+        return holders.at(address) == amount;
+    }));
+    BOOST_CHECK_EQUAL(visited, holders.size());
+
+    BOOST_REQUIRE(snapshotdb.RemoveOwnershipSnapshot("CAT", 100));
+    BOOST_CHECK(!snapshotdb.RetrieveOwnershipSnapshot("CAT", 100, snapshot));
+    BOOST_CHECK(!snapshotdb.ForEachSnapshotOwner("CAT", 100, [](const std::string&, CAmount) { return true; }));
+}
+
+BOOST_AUTO_TEST_CASE(ownership_snapshot_replace)
+{
+    CAssetsDB assetsdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    CAssetSnapshotDB snapshotdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    std::vector<std::string> addresses;
+    for (int i = 0; i < 4; ++i) {
+        addresses.push_back(EncodeDestination(PKHash{uint160{m_rng.randbytes(20)}}));
+    }
+
+    CAssetsDB* const prev_assetsdb{passetsdb};
+    passetsdb = &assetsdb;
+    const auto owners = [&] {
+        std::map<std::string, CAmount> result;
+        BOOST_CHECK(snapshotdb.ForEachSnapshotOwner("CAT", 100, [&](const std::string& address, CAmount amount) {
+            return result.emplace(address, amount).second;
+        }));
+        return result;
+    };
+
+    BOOST_REQUIRE(assetsdb.WriteAssetAddressQuantity("CAT", addresses[0], 1));
+    BOOST_REQUIRE(assetsdb.WriteAssetAddressQuantity("CAT", addresses[1], 2));
+    BOOST_REQUIRE(snapshotdb.AddAssetOwnershipSnapshot("CAT", 100));
+
+    // Chunks left over from a replacement that never completed are ignored,
+    // and dropped by the next one.
+    const auto orphan_key{std::make_pair(uint8_t{'O'}, std::make_pair(std::string{"100CAT"}, uint32_t{7}))};
+    BOOST_REQUIRE(snapshotdb.Write(orphan_key, std::vector<std::pair<std::string, CAmount>>{{addresses[3], 9}}));
+    BOOST_CHECK((owners() == std::map<std::string, CAmount>{{addresses[0], 1}, {addresses[1], 2}}));
+
+    BOOST_REQUIRE(assetsdb.EraseAssetAddressQuantity("CAT", addresses[0]));
+    BOOST_REQUIRE(assetsdb.WriteAssetAddressQuantity("CAT", addresses[2], 3));
+    BOOST_REQUIRE(snapshotdb.AddAssetOwnershipSnapshot("CAT", 100));
+    BOOST_CHECK((owners() == std::map<std::string, CAmount>{{addresses[1], 2}, {addresses[2], 3}}));
+    BOOST_CHECK(!snapshotdb.Exists(orphan_key));
+
+    // A replacement that fails leaves the previous snapshot in place.
+    BOOST_REQUIRE(assetsdb.EraseAssetAddressQuantity("CAT", addresses[1]));
+    BOOST_REQUIRE(assetsdb.EraseAssetAddressQuantity("CAT", addresses[2]));
+    BOOST_CHECK(!snapshotdb.AddAssetOwnershipSnapshot("CAT", 100));
+    BOOST_CHECK((owners() == std::map<std::string, CAmount>{{addresses[1], 2}, {addresses[2], 3}}));
+    passetsdb = prev_assetsdb;
+}
+
+BOOST_AUTO_TEST_CASE(ownership_snapshot_legacy)
+{
+    CAssetSnapshotDB snapshotdb(m_path_root, 1 << 20, /*fMemory=*/true);
+
+    // Snapshots from before owners were chunked keep them in the header and
+    // have no chunk range, so stray chunks are not theirs.
+    const CAssetSnapshotDBEntry legacy{"CAT", 100, {{"legacy", 5}}};
+    BOOST_REQUIRE(snapshotdb.Write(std::make_pair(uint8_t{'C'}, legacy.heightAndName), legacy));
+    const auto orphan_key{std::make_pair(uint8_t{'O'}, std::make_pair(legacy.heightAndName, uint32_t{0}))};
+    BOOST_REQUIRE(snapshotdb.Write(orphan_key, std::vector<std::pair<std::string, CAmount>>{{"orphan", 9}}));
+
+    std::map<std::string, CAmount> owners;
+    BOOST_CHECK(snapshotdb.ForEachSnapshotOwner("CAT", 100, [&](const std::string& address, CAmount amount) {
+        return owners.emplace(address, amount).second;
+    }));
+    BOOST_CHECK((owners == std::map<std::string, CAmount>{{"legacy", 5}}));
+}
+
+BOOST_AUTO_TEST_CASE(warm_asset_cache)
+{
+    CAssetsDB assetsdb(m_path_root, 1 << 20, /*fMemory=*/true);
+    AssetLookupTable<std::string, CDatabasedAssetData> cache(1 << 20);
+    for (const std::string name : {"CAT", "DOG", "EEL"}) {
+        CNewAsset asset;
+        asset.strName = name;
+        BOOST_REQUIRE(assetsdb.WriteAssetData(asset, 10, uint256::ONE));
+    }
+
+    CAssetsDB* const prev_assetsdb{passetsdb};
+    auto* const prev_cache{passetsCache};
+    passetsdb = &assetsdb;
+    passetsCache = &cache;
+    std::atomic<bool> interrupt{false};
+
+    // Without a hot set every stored asset is loaded.
+    WarmAssetCache(interrupt);
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 3U);
+
+    // Otherwise only the recently used ones, which survive a restart.
+    cache.Clear();
+    BOOST_REQUIRE(assetsdb.WriteHotAssets({"DOG", "GONE"}));
+    WarmAssetCache(interrupt);
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 1U);
+    BOOST_CHECK(cache.Exists("DOG"));
+    BOOST_CHECK(cache.GetKeys() == std::vector<std::string>{"DOG"});
+
+    // Writes of asset data are counted, so a batch read during one is not
+    // cached. Holder balances don't count.
+    const uint64_t writes{assetsdb.AssetDataWrites()};
+    BOOST_REQUIRE(assetsdb.WriteAssetAddressQuantity("DOG", EncodeDestination(PKHash{}), 1));
+    BOOST_CHECK_EQUAL(assetsdb.AssetDataWrites(), writes);
+    BOOST_REQUIRE(assetsdb.EraseAssetData("CAT"));
+    BOOST_CHECK_EQUAL(assetsdb.AssetDataWrites(), writes + 1);
+
+    passetsdb = prev_assetsdb;
+    passetsCache = prev_cache;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
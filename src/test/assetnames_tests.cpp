@@ -0,0 +1,168 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <assets/assetnames.h>
+#include <assets/assets.h>
+#include <coins.h>
+#include <consensus/tx_verify.h>
+#include <consensus/validation.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(assetnames_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(intern_and_lookup)
+{
+    CAssetNameTable table;
+    BOOST_CHECK(!table.Find("MEOW"));
+
+    const AssetId meow{table.Intern("MEOW")};
+    const AssetId purr{table.Intern("PURR")};
+    BOOST_CHECK(meow != NULL_ASSET_ID);
+    BOOST_CHECK(meow != purr);
+    BOOST_CHECK_EQUAL(table.Intern(std::string{"MEOW"}), meow);
+    BOOST_CHECK_EQUAL(*table.Find("PURR"), purr);
+    BOOST_CHECK_EQUAL(table.Size(), 2U);
+
+    // Names stay valid while the table grows.
+    const std::string& name{table.Name(meow)};
+    for (int i = 0; i < 10000; ++i) table.Intern("ASSET" + std::to_string(i));
+    BOOST_CHECK_EQUAL(name, "MEOW");
+    BOOST_CHECK_EQUAL(table.Name(*table.Find("ASSET9999")), "ASSET9999");
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_intern)
+{
+    CAssetNameTable table;
+    std::vector<std::vector<AssetId>> ids(4);
+    std::vector<std::thread> threads;
+    for (auto& thread_ids : ids) {
+        threads.emplace_back([&table, &thread_ids] {
+            for (int i = 0; i < 1000; ++i) thread_ids.push_back(table.Intern("ASSET" + std::to_string(i)));
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    BOOST_CHECK_EQUAL(table.Size(), 1000U);
+    for (const auto& thread_ids : ids) {
+        BOOST_CHECK(thread_ids == ids.front());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transfer_of_unheld_asset)
+{
+    // An output naming an asset that no spent coin holds is rejected, whether
+    // or not the name has been interned.
+    const auto transfer_script = [](const std::string& name) {
+        CScript script = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x22)
+                                   << OP_EQUALVERIFY << OP_CHECKSIG;
+        CAssetTransfer(name, COIN).ConstructTransaction(script);
+        return script;
+    };
+
+    for (const std::string name : {"NEVERSEENBEFORE", "HELDELSEWHERE"}) {
+        AssetNames().Intern("HELDELSEWHERE");
+        CCoinsView view;
+        CCoinsViewCache coins(&view);
+        const COutPoint outpoint{Txid::FromUint256(uint256::ONE), 0};
+        coins.AddCoin(outpoint, Coin(CTxOut{0, transfer_script("HELD")}, 10, false), true);
+
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(outpoint);
+        mtx.vout.emplace_back(0, transfer_script("HELD"));
+        mtx.vout.emplace_back(0, transfer_script(name));
+
+        TxValidationState state;
+        std::vector<std::pair<std::string, uint256>> reissued;
+        BOOST_CHECK(!Consensus::CheckTxAssets(CTransaction{mtx}, state, coins, nullptr, nullptr, reissued,
+                                              /*fRunningUnitTests=*/true, nullptr, 0, nullptr, 0));
+        BOOST_CHECK_EQUAL(state.GetRejectReason(),
+                          "bad-tx-inputs-outputs-mismatch Bad Transaction - Trying to create outpoint for asset that you don't have: " + name);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mempool_coin_not_interned)
+{
+    const auto transfer_script = [](const std::string& name, CAmount amount) {
+        CScript script = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x44)
+                                   << OP_EQUALVERIFY << OP_CHECKSIG;
+        CAssetTransfer(name, amount).ConstructTransaction(script);
+        return script;
+    };
+    const auto check = [&](const std::string& out_name, CAmount out_amount) {
+        CCoinsView view;
+        CCoinsViewCache coins(&view);
+        const COutPoint outpoint{Txid::FromUint256(uint256::ONE), 0};
+        coins.AddCoin(outpoint, Coin(CTxOut{0, transfer_script("UNCONFIRMED", 5 * COIN)}, MEMPOOL_HEIGHT, false), true);
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(outpoint);
+        mtx.vout.emplace_back(0, transfer_script(out_name, out_amount));
+
+        TxValidationState state;
+        std::vector<std::pair<std::string, uint256>> reissued;
+        Consensus::CheckTxAssets(CTransaction{mtx}, state, coins, nullptr, nullptr, reissued,
+                                 /*fRunningUnitTests=*/true, nullptr, 0, nullptr, 0);
+        return state.GetRejectReason();
+    };
+
+    // An asset that only a mempool coin holds is checked by name, without
+    // growing the table.
+    const size_t size{AssetNames().Size()};
+    BOOST_CHECK_EQUAL(check("UNCONFIRMED", 5 * COIN), "");
+    BOOST_CHECK_EQUAL(check("UNCONFIRMED", COIN), "bad-tx-inputs-outputs-mismatch Bad Transaction - Assets would be burnt UNCONFIRMED");
+    BOOST_CHECK_EQUAL(check("UNCONFIRMEE", 5 * COIN), "bad-tx-inputs-outputs-mismatch Bad Transaction - Trying to create outpoint for asset that you don't have: UNCONFIRMEE");
+    BOOST_CHECK(!AssetNames().Find("UNCONFIRMED"));
+    BOOST_CHECK_EQUAL(AssetNames().Size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(mismatch_reported_in_name_order)
+{
+    // Interned in the reverse of name order, so neither the ids nor their
+    // hashes follow the names.
+    for (const std::string name : {"ORDERZ", "ORDERM", "ORDERA"}) AssetNames().Intern(name);
+
+    const auto transfer_script = [](const std::string& name, CAmount amount) {
+        CScript script = CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x33)
+                                   << OP_EQUALVERIFY << OP_CHECKSIG;
+        CAssetTransfer(name, amount).ConstructTransaction(script);
+        return script;
+    };
+    const auto reject_reason = [&](const std::vector<std::pair<std::string, CAmount>>& outputs) {
+        CCoinsView view;
+        CCoinsViewCache coins(&view);
+        CMutableTransaction mtx;
+        for (const std::string name : {"ORDERZ", "ORDERM", "ORDERA"}) {
+            const COutPoint outpoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(mtx.vin.size())};
+            coins.AddCoin(outpoint, Coin(CTxOut{0, transfer_script(name, 5 * COIN)}, 10, false), true);
+            mtx.vin.emplace_back(outpoint);
+        }
+        for (const auto& [name, amount] : outputs) mtx.vout.emplace_back(0, transfer_script(name, amount));
+
+        TxValidationState state;
+        std::vector<std::pair<std::string, uint256>> reissued;
+        BOOST_CHECK(!Consensus::CheckTxAssets(CTransaction{mtx}, state, coins, nullptr, nullptr, reissued,
+                                              /*fRunningUnitTests=*/true, nullptr, 0, nullptr, 0));
+        return state.GetRejectReason();
+    };
+
+    // The first asset by name is reported, whatever the output order.
+    const std::string burnt{"bad-tx-inputs-outputs-mismatch Bad Transaction - Assets would be burnt "};
+    BOOST_CHECK_EQUAL(reject_reason({{"ORDERZ", COIN}, {"ORDERM", COIN}, {"ORDERA", COIN}}), burnt + "ORDERA");
+    BOOST_CHECK_EQUAL(reject_reason({{"ORDERA", 5 * COIN}, {"ORDERZ", COIN}, {"ORDERM", COIN}}), burnt + "ORDERM");
+
+    // Names that were never interned are ordered with the others.
+    const std::string unheld{"bad-tx-inputs-outputs-mismatch Bad Transaction - Trying to create outpoint for asset that you don't have: "};
+    BOOST_CHECK_EQUAL(reject_reason({{"ORDERZ", COIN}, {"ORDERN", COIN}, {"ORDERM", COIN}}), burnt + "ORDERM");
+    BOOST_CHECK_EQUAL(reject_reason({{"ORDERZ", COIN}, {"ORDERM", 5 * COIN}, {"ORDERB", COIN}}), unheld + "ORDERB");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
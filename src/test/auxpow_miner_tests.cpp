@@ -0,0 +1,180 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <chainparams.h>
+#include <consensus/consensus.h>
+#include <consensus/merkle.h>
+#include <interfaces/mining.h>
+#include <node/context.h>
+#include <node/miner.h>
+#include <primitives/block.h>
+#include <rpc/auxpow_miner.h>
+#include <script/script.h>
+#include <test/util/assets.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <txmempool.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+using auxpow_miner::MAX_AUXPOW_TEMPLATES;
+using auxpow_miner::TemplateCache;
+
+namespace {
+struct AuxPowMinerSetup : public ChainTestingSetup {
+    AssetsCacheGuard assets;
+    std::unique_ptr<interfaces::Mining> m_mining;
+
+    AuxPowMinerSetup() : ChainTestingSetup{ChainType::REGTEST}
+    {
+        // Templates are checked against the clock, which must not lag the
+        // regtest genesis block.
+        SetMockTime(Params().GenesisBlock().nTime);
+        LoadVerifyActivateChainstate();
+        m_mining = interfaces::MakeMining(m_node);
+    }
+
+    uint256 Create(TemplateCache& cache, const CScript& script)
+    {
+        return cache.createBlock(script, *m_mining, *m_node.chainman, m_node.mempool.get());
+    }
+
+    /** Extend the chain by one block paying to P2WSH_OP_TRUE. */
+    COutPoint Mine()
+    {
+        node::BlockAssembler::Options options;
+        options.coinbase_output_script = P2WSH_OP_TRUE;
+        return MineBlock(m_node, options);
+    }
+
+    /** Spend outpoint to P2WSH_OP_TRUE and add the transaction to the mempool. */
+    COutPoint Spend(const COutPoint& outpoint, CAmount value)
+    {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(outpoint);
+        mtx.vin[0].scriptWitness.stack.push_back(WITNESS_STACK_ELEM_OP_TRUE);
+        mtx.vout.emplace_back(value, P2WSH_OP_TRUE);
+        const CTransactionRef tx{MakeTransactionRef(std::move(mtx))};
+        const auto result{WITH_LOCK(::cs_main, return m_node.chainman->ProcessTransaction(tx))};
+        BOOST_REQUIRE_EQUAL(result.m_result_type, MempoolAcceptResult::ResultType::VALID);
+        return {tx->GetHash(), 0};
+    }
+
+    uint256 Tip()
+    {
+        return WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash());
+    }
+};
+
+CScript PayTo(unsigned char n)
+{
+    return CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, n) << OP_EQUALVERIFY << OP_CHECKSIG;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(auxpow_miner_tests, AuxPowMinerSetup)
+
+BOOST_AUTO_TEST_CASE(template_reuse)
+{
+    TemplateCache cache;
+    const uint256 first{Create(cache, PayTo(1))};
+    BOOST_CHECK_EQUAL(Create(cache, PayTo(1)), first);
+    BOOST_CHECK_EQUAL(cache.getStats().hits, 1U);
+    BOOST_CHECK_EQUAL(cache.getStats().misses, 1U);
+
+    // A changed mempool alone does not replace a template that is still young.
+    m_node.mempool->AddTransactionsUpdated(1);
+    BOOST_CHECK_EQUAL(Create(cache, PayTo(1)), first);
+
+    // Once it is old enough, the template is rebuilt. The assembled block is
+    // just as old, so the payout is not swapped into it either.
+    SetMockTime(Now<NodeSeconds>() + auxpow_miner::AUXPOW_TEMPLATE_REFRESH + 1s);
+    const uint256 rebuilt{Create(cache, PayTo(1))};
+    BOOST_CHECK(rebuilt != first);
+    BOOST_CHECK_EQUAL(Create(cache, PayTo(1)), rebuilt);
+    // The old template stays, so work already handed out can be submitted.
+    BOOST_CHECK(cache.getBlock(first));
+    const auto stats{cache.getStats()};
+    BOOST_CHECK_EQUAL(stats.size, 2U);
+    BOOST_CHECK_EQUAL(stats.hits, 3U);
+    BOOST_CHECK_EQUAL(stats.misses, 2U);
+    BOOST_CHECK_EQUAL(stats.payout_swaps, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(stale_purge)
+{
+    TemplateCache cache;
+    const uint256 first{Create(cache, PayTo(1))};
+    Create(cache, PayTo(2));
+    BOOST_CHECK_EQUAL(cache.getStats().size, 2U);
+
+    Mine();
+    const uint256 tip{Tip()};
+
+    const uint256 next{Create(cache, PayTo(1))};
+    BOOST_CHECK(next != first);
+    BOOST_CHECK(!cache.getBlock(first));
+    BOOST_CHECK_EQUAL(cache.getBlock(next)->hashPrevBlock, tip);
+    const auto stats{cache.getStats()};
+    BOOST_CHECK_EQUAL(stats.stale_purged, 2U);
+    BOOST_CHECK_EQUAL(stats.size, 1U);
+
+    // A template for the old tip cannot be submitted any more.
+    BOOST_CHECK(!cache.submitBlock(first, "", *m_node.chainman));
+}
+
+BOOST_AUTO_TEST_CASE(payout_swap)
+{
+    const COutPoint coinbase{Mine()};
+    for (int i = 0; i < COINBASE_MATURITY; ++i) Mine();
+    const CAmount value{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChainstate().CoinsTip().AccessCoin(coinbase).out.nValue)};
+    Spend(Spend(coinbase, value - COIN), value - 2 * COIN);
+
+    TemplateCache cache;
+    const auto a{cache.getBlock(Create(cache, PayTo(1)))};
+    const auto b{cache.getBlock(Create(cache, PayTo(2)))};
+    BOOST_CHECK_EQUAL(cache.getStats().payout_swaps, 1U);
+
+    // Only the coinbase payout differs, and the merkle root follows it.
+    BOOST_REQUIRE_EQUAL(a->vtx.size(), 3U);
+    BOOST_REQUIRE_EQUAL(b->vtx.size(), a->vtx.size());
+    BOOST_CHECK(a->vtx[0]->vout[0].scriptPubKey == PayTo(1));
+    BOOST_CHECK(b->vtx[0]->vout[0].scriptPubKey == PayTo(2));
+    for (size_t i = 1; i < a->vtx.size(); ++i) {
+        BOOST_CHECK_EQUAL(b->vtx[i]->GetHash(), a->vtx[i]->GetHash());
+    }
+    BOOST_CHECK_EQUAL(a->hashMerkleRoot, BlockMerkleRoot(*a));
+    BOOST_CHECK_EQUAL(b->hashMerkleRoot, BlockMerkleRoot(*b));
+    BOOST_CHECK(b->hashMerkleRoot != a->hashMerkleRoot);
+}
+
+BOOST_AUTO_TEST_CASE(eviction)
+{
+    TemplateCache cache;
+    std::vector<uint256> hashes;
+    for (size_t i = 0; i <= MAX_AUXPOW_TEMPLATES; ++i) {
+        hashes.push_back(Create(cache, PayTo(static_cast<unsigned char>(i))));
+    }
+    auto stats{cache.getStats()};
+    BOOST_CHECK_EQUAL(stats.size, MAX_AUXPOW_TEMPLATES);
+    BOOST_CHECK_EQUAL(stats.evictions, 1U);
+    BOOST_CHECK(!cache.getBlock(hashes.front()));
+    BOOST_CHECK(cache.getBlock(hashes[1]));
+    BOOST_CHECK(cache.getBlock(hashes.back()));
+
+    // The evicted payout script gets a new template, pushing out the next oldest.
+    Create(cache, PayTo(0));
+    stats = cache.getStats();
+    BOOST_CHECK_EQUAL(stats.size, MAX_AUXPOW_TEMPLATES);
+    BOOST_CHECK_EQUAL(stats.evictions, 2U);
+    BOOST_CHECK(!cache.getBlock(hashes[1]));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,51 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <auxpow.h>
+#include <chainparams.h>
+#include <primitives/block.h>
+#include <test/util/setup_common.h>
+#include <util/chaintype.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(auxpow_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(init_auxpow_passes_check)
+{
+    const auto chain_params{CreateChainParams(*m_node.args, ChainType::MAIN)};
+    const Consensus::Params& params{chain_params->GetConsensus()};
+
+    CBlockHeader header;
+    header.nVersion.SetGenesisVersion(4);
+    header.nVersion.SetChainId(params.nAuxpowChainId);
+    header.hashPrevBlock = m_rng.rand256();
+    header.hashMerkleRoot = m_rng.rand256();
+    header.nTime = 1700000000;
+    header.nBits = 0x1e0fffff;
+    CAuxPow::initAuxPow(header);
+    BOOST_REQUIRE(header.auxpow);
+    BOOST_CHECK(header.nVersion.IsAuxpow());
+
+    const uint256 hash{header.GetHash()};
+    BOOST_CHECK(header.auxpow->check(hash, params.nAuxpowChainId, params));
+    // The auxpow commits to this block only.
+    BOOST_CHECK(!header.auxpow->check(m_rng.rand256(), params.nAuxpowChainId, params));
+
+    // The merged-mining header, the chain merkle root, the tree size (1) and
+    // the nonce (0) are one push, in this order.
+    const CScript& script{header.auxpow->tx->vin[0].scriptSig};
+    std::vector<unsigned char> expected(std::begin(pchMergedMiningHeader), std::end(pchMergedMiningHeader));
+    std::vector<unsigned char> root(hash.begin(), hash.end());
+    std::reverse(root.begin(), root.end());
+    expected.insert(expected.end(), root.begin(), root.end());
+    expected.insert(expected.end(), {1, 0, 0, 0, 0, 0, 0, 0});
+    BOOST_CHECK(script == CScript() << expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -147,4 +147,20 @@ BOOST_AUTO_TEST_CASE(key_io_invalid)
     }
 }
 
+BOOST_AUTO_TEST_CASE(key_io_base58_with_bech32_prefix)
+{
+    // Base58 addresses that start with the bech32 prefix in any case still
+    // decode as base58.
+    SelectParams(ChainType::MAIN);
+    for (int found = 0; found < 3;) {
+        const PKHash hash{uint160{m_rng.randbytes(20)}};
+        const std::string address{EncodeDestination(hash)};
+        if (ToLower(address).rfind(Params().Bech32HRP(), 0) != 0) continue;
+        BOOST_CHECK_MESSAGE(DecodeDestination(address) == CTxDestination{hash}, address);
+        ++found;
+    }
+    const CTxDestination witness{WitnessV0KeyHash{uint160{m_rng.randbytes(20)}}};
+    BOOST_CHECK(DecodeDestination(EncodeDestination(witness)) == witness);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
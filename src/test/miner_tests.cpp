@@ -3,7 +3,6 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <addresstype.h>
-#include <assets/assets.h>
 #include <coins.h>
 #include <common/system.h>
 #include <consensus/consensus.h>
@@ -12,6 +11,7 @@
 #include <interfaces/mining.h>
 #include <node/miner.h>
 #include <policy/policy.h>
+#include <test/util/assets.h>
 #include <test/util/random.h>
 #include <test/util/transaction_utils.h>
 #include <test/util/txmempool.h>
@@ -67,15 +67,6 @@ struct MinerTestingSetup : public TestingSetup {
     }
 };
 
-// ChainTestingSetup does not initialize the global asset cache.
-struct AssetsCacheGuard {
-    CAssetsCache cache;
-    CAssetsCache* const previous{passets};
-
-    AssetsCacheGuard() { passets = &cache; }
-    ~AssetsCacheGuard() { passets = previous; }
-};
-
 struct NativeHeaderHeightTestingSetup : public ChainTestingSetup {
     AssetsCacheGuard assets;
 
@@ -4,13 +4,37 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <checkqueue.h>
+#include <consensus/validation.h>
+#include <crypto/ethash/helpers.hpp>
 #include <pow.h>
+#include <pow_hash.h>
+#include <primitives/block.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <util/chaintype.h>
+#include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace {
+//! Restores the global proof-of-work activation times on scope exit.
+struct PowActivationTimesGuard {
+    const uint32_t kawpow{nKAWPOWActivationTime};
+    const uint32_t meowpow{nMEOWPOWActivationTime};
+
+    ~PowActivationTimesGuard()
+    {
+        nKAWPOWActivationTime = kawpow;
+        nMEOWPOWActivationTime = meowpow;
+    }
+};
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(pow_tests, BasicTestingSetup)
 
 /* Test calculation of next difficulty target with no constraints applying */
@@ -208,4 +232,279 @@ BOOST_AUTO_TEST_CASE(ChainParams_SIGNET_sanity)
     sanity_check_chainparams(*m_node.args, ChainType::SIGNET);
 }
 
+BOOST_AUTO_TEST_CASE(progpow_hash256_conversion)
+{
+    for (int i = 0; i < 16; ++i) {
+        const uint256 hash{m_rng.rand256()};
+        const ethash::hash256 converted{ToEthashHash256(hash)};
+        // Must match the hex round trip the ProgPoW code used to go through.
+        BOOST_CHECK(converted == to_hash256(hash.GetHex()));
+        BOOST_CHECK_EQUAL(FromEthashHash256(converted), hash);
+        BOOST_CHECK_EQUAL(FromEthashHash256(converted).GetHex(), to_hex(converted));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_pow_check_queue_in_order)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, ChainType::REGTEST);
+    const Consensus::Params& params{chainParams->GetConsensus()};
+
+    const unsigned int bits{UintToArith256(params.powLimitPerAlgo[static_cast<uint8_t>(PowAlgo::MEOWPOW)]).GetCompact()};
+
+    // Grind every header to a valid proof of work, except one in the middle.
+    std::vector<CBlockHeader> headers(32);
+    for (size_t i = 0; i < headers.size(); ++i) {
+        CBlockHeader& header{headers[i]};
+        header.nVersion = 4;
+        header.hashPrevBlock = m_rng.rand256();
+        header.nTime = 1;
+        header.nBits = bits;
+        const bool want_valid{i != 20};
+        do {
+            header.nNonce = m_rng.rand32();
+        } while (CheckProofOfWork(header.GetHash(), bits, PowAlgo::MEOWPOW, params) != want_valid);
+    }
+
+    std::vector<std::optional<BlockValidationState>> expected(headers.size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+        CHeaderPoWCheck{headers[i], params, expected[i]}();
+    }
+
+    CCheckQueue<CHeaderPoWCheck> queue{/*batch_size=*/4, /*worker_threads_num=*/3, "Header test", "headertest"};
+    std::vector<std::optional<BlockValidationState>> results(headers.size());
+    std::vector<CHeaderPoWCheck> checks;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        checks.emplace_back(headers[i], params, results[i]);
+    }
+    CCheckQueueControl<CHeaderPoWCheck> control{queue};
+    control.Add(std::move(checks));
+    BOOST_CHECK(!expected[20]->IsValid());
+    BOOST_CHECK(control.Complete().has_value());
+
+    // Checks skipped after a failure leave their slot empty; every filled
+    // slot must match the serial result for the same position.
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (!results[i]) continue;
+        BOOST_CHECK_EQUAL(results[i]->IsValid(), expected[i]->IsValid());
+        BOOST_CHECK_EQUAL(results[i]->GetRejectReason(), expected[i]->GetRejectReason());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_pow_check_claimed_mix_only)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, ChainType::REGTEST);
+    const Consensus::Params& params{chainParams->GetConsensus()};
+
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.nTime = nKAWPOWActivationTime;
+    header.nBits = UintToArith256(params.powLimitPerAlgo[static_cast<uint8_t>(PowAlgo::MEOWPOW)]).GetCompact();
+    header.nHeight = 1;
+    header.mix_hash = m_rng.rand256();
+
+    // Find a nonce whose final hash meets the target for the (bogus) claimed mix.
+    std::optional<BlockValidationState> screened;
+    do {
+        header.nNonce64 = m_rng.rand64();
+        CHeaderPoWCheck{header, params, screened, /*check_mix_hash=*/false}();
+    } while (!screened->IsValid());
+
+    // Screening trusts the claimed mix; the full check recomputes it.
+    std::optional<BlockValidationState> full;
+    CHeaderPoWCheck{header, params, full}();
+    BOOST_CHECK(!full->IsValid());
+    BOOST_CHECK_EQUAL(full->GetRejectReason(), "bad-mix-hash");
+}
+
+BOOST_AUTO_TEST_CASE(progpow_epoch_cache_shared)
+{
+    CBlockHeader header;
+    header.nHeight = 1;
+    header.nNonce64 = 0x1234;
+
+    const PowEpochCacheStats before{GetPowEpochCacheStats()};
+
+    uint256 kawpow_mix, meowpow_mix;
+    const uint256 kawpow_hash{KAWPOWHash(header, kawpow_mix)};
+    const uint256 meowpow_hash{MEOWPOWHash(header, meowpow_mix)};
+
+    // Both algorithms resolve epoch 0 through the same cache entry.
+    const PowEpochCacheStats after{GetPowEpochCacheStats()};
+    BOOST_CHECK_EQUAL(after.hits + after.misses, before.hits + before.misses + 2);
+    BOOST_CHECK(after.hits > before.hits);
+    BOOST_CHECK(std::ranges::find(after.epochs, 0) != after.epochs.end());
+
+    // The cheap path must agree with the full computation for the claimed mix.
+    header.mix_hash = kawpow_mix;
+    BOOST_CHECK_EQUAL(KAWPOWHash_OnlyMix(header), kawpow_hash);
+    header.mix_hash = meowpow_mix;
+    BOOST_CHECK_EQUAL(MEOWPOWHash_OnlyMix(header), meowpow_hash);
+}
+
+BOOST_AUTO_TEST_CASE(progpow_epoch_prebuild_needs_room)
+{
+    // A single slot is kept for the epoch in use, so nothing is prebuilt.
+    SetPowEpochCacheSize(1);
+    const PowEpochCacheStats before{GetPowEpochCacheStats()};
+    PrebuildPowEpochContext(ethash::epoch_length * 3);
+    const PowEpochCacheStats after{GetPowEpochCacheStats()};
+    SetPowEpochCacheSize(DEFAULT_POW_EPOCH_CACHE_SIZE);
+
+    BOOST_CHECK_EQUAL(after.prebuilds, before.prebuilds);
+    BOOST_CHECK(std::ranges::find(after.epochs, 3) == after.epochs.end());
+}
+
+BOOST_AUTO_TEST_CASE(pow_hash_memo)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.hashPrevBlock = m_rng.rand256();
+    block.nTime = 1;
+    block.nBits = 0x207fffff;
+    block.nNonce = 1;
+    BOOST_REQUIRE(block.nTime < nKAWPOWActivationTime);
+
+    const PowHashCounters start{GetPowHashCounters()};
+    const uint256 hash{block.GetHash()};
+    BOOST_CHECK_EQUAL(block.GetHash(), hash);
+    const CBlockHeader header{block.GetBlockHeader()};
+    BOOST_CHECK_EQUAL(header.GetHash(), hash);
+    PowHashCounters now{GetPowHashCounters()};
+    BOOST_CHECK_EQUAL(now.computed - start.computed, 1U);
+    BOOST_CHECK_EQUAL(now.memo_hits - start.memo_hits, 2U);
+
+    // Changing any hashed field invalidates the memo.
+    block.nNonce = 2;
+    const uint256 rehash{block.GetHash()};
+    BOOST_CHECK(rehash != hash);
+    BOOST_CHECK_EQUAL(rehash, block.GetX16RV2Hash());
+    BOOST_CHECK_EQUAL(header.GetHash(), hash);
+    now = GetPowHashCounters();
+    BOOST_CHECK_EQUAL(now.computed - start.computed, 2U);
+
+    // So does moving an activation time across the header.
+    {
+        const PowActivationTimesGuard guard;
+        nKAWPOWActivationTime = 0;
+        BOOST_CHECK_EQUAL(block.GetHash(), block.nTime < nMEOWPOWActivationTime ? KAWPOWHash_OnlyMix(block) : MEOWPOWHash_OnlyMix(block));
+    }
+    BOOST_CHECK_EQUAL(block.GetHash(), rehash);
+}
+
+BOOST_AUTO_TEST_CASE(pow_hash_memo_claimed_mix)
+{
+    const PowActivationTimesGuard guard;
+    nKAWPOWActivationTime = 0;
+    nMEOWPOWActivationTime = std::numeric_limits<uint32_t>::max();
+
+    CBlockHeader header;
+    header.nTime = 1;
+    header.nHeight = 1;
+    header.nNonce64 = m_rng.rand64();
+    uint256 mix;
+    const uint256 full{header.GetHashFull(mix)};
+
+    // A wrong claimed mix is not confirmed by the full hash, so it is not memoised.
+    header.mix_hash = m_rng.rand256();
+    uint256 recomputed_mix;
+    BOOST_CHECK_EQUAL(header.GetHashFull(recomputed_mix), full);
+    BOOST_CHECK_EQUAL(recomputed_mix, mix);
+    PowHashCounters start{GetPowHashCounters()};
+    const uint256 claimed{header.GetHash()};
+    BOOST_CHECK_EQUAL(claimed, KAWPOWHash_OnlyMix(header));
+    BOOST_CHECK_EQUAL(GetPowHashCounters().memo_hits, start.memo_hits);
+
+    // The hash memoised for one claimed mix is never returned for another.
+    header.mix_hash = mix;
+    start = GetPowHashCounters();
+    BOOST_CHECK_EQUAL(header.GetHash(), full);
+    BOOST_CHECK_EQUAL(GetPowHashCounters().computed - start.computed, 1U);
+    BOOST_CHECK_EQUAL(GetPowHashCounters().memo_hits, start.memo_hits);
+    header.mix_hash = m_rng.rand256();
+    BOOST_CHECK_EQUAL(header.GetHash(), KAWPOWHash_OnlyMix(header));
+    BOOST_CHECK_EQUAL(GetPowHashCounters().computed - start.computed, 2U);
+}
+
+// Older version of the LWMA multi-algo retarget, which scans every height in
+// the search window, for comparison.
+static unsigned int LwmaByAncestorScan(const CBlockIndex* pindexLast, bool auxpow, const Consensus::Params& params)
+{
+    const int64_t T = params.nPowTargetSpacing * 2;
+    const int64_t N = params.nLwmaAveragingWindow;
+    const int64_t height = pindexLast->nHeight;
+    const arith_uint256 powLimit{UintToArith256(params.powLimitPerAlgo[static_cast<uint8_t>(auxpow ? PowAlgo::SCRYPT : PowAlgo::MEOWPOW)])};
+    if (height < N) return powLimit.GetCompact();
+
+    std::vector<const CBlockIndex*> sameAlgo;
+    const int64_t searchLimit = std::min<int64_t>(height, N * 10);
+    for (int64_t h = height; h >= 0 && static_cast<int64_t>(sameAlgo.size()) < N + 1 && height - h <= searchLimit; --h) {
+        const CBlockIndex* bi = pindexLast->GetAncestor(h);
+        if (bi->nVersion.IsAuxpow() == auxpow) sameAlgo.push_back(bi);
+    }
+    if (static_cast<int64_t>(sameAlgo.size()) < N + 1) {
+        return sameAlgo.empty() ? powLimit.GetCompact() : sameAlgo.front()->nBits;
+    }
+    std::reverse(sameAlgo.begin(), sameAlgo.end());
+
+    arith_uint256 sumTargets;
+    int64_t sumWeightedSolvetimes = 0;
+    int64_t prevTs = sameAlgo[0]->GetBlockTime();
+    for (int64_t i = 1; i <= N; ++i) {
+        const int64_t ts = std::max(sameAlgo[i]->GetBlockTime(), prevTs + 1);
+        sumWeightedSolvetimes += i * std::min(ts - prevTs, 6 * T);
+        prevTs = ts;
+        arith_uint256 tgt;
+        tgt.SetCompact(sameAlgo[i]->nBits);
+        sumTargets += tgt;
+    }
+    arith_uint256 nextTarget{sumTargets / N};
+    nextTarget *= static_cast<uint64_t>(sumWeightedSolvetimes);
+    nextTarget /= static_cast<uint64_t>(N * (N + 1) * T / 2);
+    if (nextTarget > powLimit) nextTarget = powLimit;
+    return nextTarget.GetCompact();
+}
+
+BOOST_AUTO_TEST_CASE(lwma_same_algo_links)
+{
+    const auto chainParams = CreateChainParams(*m_node.args, ChainType::MAIN);
+    Consensus::Params params{chainParams->GetConsensus()};
+    params.nAuxpowStartHeight = 0;
+    const int64_t depth{params.LwmaSearchDepth()};
+
+    // Runs of merge-mined and native blocks, some longer than the search depth.
+    std::vector<CBlockIndex> blocks(4000);
+    bool auxpow{false};
+    int run_left{0};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (run_left-- == 0) {
+            auxpow = !auxpow;
+            run_left = m_rng.randbool() ? m_rng.randrange(4) : m_rng.randrange(depth + 200);
+        }
+        blocks[i].pprev = i ? &blocks[i - 1] : nullptr;
+        blocks[i].nHeight = i;
+        blocks[i].nTime = 1700000000 + i * params.nPowTargetSpacing + m_rng.randrange(120);
+        blocks[i].nBits = 0x1c00ffff - m_rng.randrange(0x8000);
+        blocks[i].nVersion.SetAuxpow(auxpow);
+        blocks[i].BuildSkip();
+        blocks[i].BuildSameAlgoLink(depth);
+    }
+
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const CBlockIndex* expected{nullptr};
+        for (const CBlockIndex* p{blocks[i].pprev}; p && blocks[i].nHeight - p->nHeight <= depth; p = p->pprev) {
+            if (p->nVersion.IsAuxpow() == blocks[i].nVersion.IsAuxpow()) {
+                expected = p;
+                break;
+            }
+        }
+        BOOST_CHECK(blocks[i].pprevSameAlgo == expected);
+
+        for (const bool next_auxpow : {false, true}) {
+            CBlockHeader header;
+            header.nVersion.SetAuxpow(next_auxpow);
+            BOOST_CHECK_EQUAL(GetNextWorkRequired(&blocks[i], &header, params), LwmaByAncestorScan(&blocks[i], next_auxpow, params));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,205 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <index/base.h>
+#include <index/synccoordinator.h>
+#include <interfaces/chain.h>
+#include <node/miner.h>
+#include <script/script.h>
+#include <test/util/assets.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/fs.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+//! An index that indexes nothing, to register with the coordinator
+class TestIndex : public BaseIndex
+{
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+public:
+    explicit TestIndex(std::unique_ptr<interfaces::Chain> chain)
+        : BaseIndex(std::move(chain), "test index"), m_db{std::make_unique<BaseIndex::DB>("", 1 << 20, /*f_memory=*/true)} {}
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+    bool AllowPrune() const override { return true; }
+};
+
+struct SyncCoordinatorSetup : public ChainTestingSetup {
+    AssetsCacheGuard assets;
+
+    SyncCoordinatorSetup() : ChainTestingSetup{ChainType::REGTEST}
+    {
+        SetMockTime(Params().GenesisBlock().nTime);
+        LoadVerifyActivateChainstate();
+        Mine(30, P2WSH_OP_TRUE);
+    }
+
+    void Mine(int count, const CScript& script)
+    {
+        node::BlockAssembler::Options options;
+        options.coinbase_output_script = script;
+        for (int i = 0; i < count; ++i) MineBlock(m_node, options);
+    }
+
+    const CBlockIndex& Block(int height)
+    {
+        return *Assert(WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[height]));
+    }
+
+    std::unique_ptr<TestIndex> MakeIndex()
+    {
+        return std::make_unique<TestIndex>(interfaces::MakeChain(m_node));
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(synccoordinator_tests, SyncCoordinatorSetup)
+
+BOOST_AUTO_TEST_CASE(blocks_shared)
+{
+    IndexSyncCoordinator coordinator{*m_node.chainman};
+    const auto first{MakeIndex()};
+    const auto second{MakeIndex()};
+    coordinator.Register(*second, 1, /*undo=*/true);
+    coordinator.Register(*first, 1, /*undo=*/false);
+
+    for (int height = 1; height <= 5; ++height) {
+        const CBlockIndex& block{Block(height)};
+        const auto read{coordinator.GetBlock(*first, block)};
+        BOOST_REQUIRE(read);
+        BOOST_CHECK_EQUAL(read->index, &block);
+        BOOST_CHECK_EQUAL(read->block.GetHash(), block.GetBlockHash());
+        // Undo data is read as long as one of the indexes needs it.
+        BOOST_CHECK(read->undo);
+        BOOST_CHECK_EQUAL(coordinator.GetBlock(*second, block), read);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(index_going_back_restarts_reader)
+{
+    IndexSyncCoordinator coordinator{*m_node.chainman};
+    const auto index{MakeIndex()};
+    coordinator.Register(*index, 1, /*undo=*/false);
+    for (int height = 1; height <= 10; ++height) {
+        BOOST_REQUIRE(coordinator.GetBlock(*index, Block(height)));
+    }
+
+    // The blocks behind the index were dropped, so they are read again.
+    for (int height = 2; height <= 4; ++height) {
+        const auto read{coordinator.GetBlock(*index, Block(height))};
+        BOOST_REQUIRE(read);
+        BOOST_CHECK_EQUAL(read->index, &Block(height));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stale_blocks_dropped_after_reorg)
+{
+    IndexSyncCoordinator coordinator{*m_node.chainman};
+    const auto index{MakeIndex()};
+    coordinator.Register(*index, 1, /*undo=*/false);
+    for (int height = 1; height <= 3; ++height) {
+        BOOST_REQUIRE(coordinator.GetBlock(*index, Block(height)));
+    }
+
+    // Replace the blocks the reader has read ahead of the index.
+    CBlockIndex* const stale{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[4])};
+    BlockValidationState state;
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, stale));
+    Mine(30, CScript() << OP_TRUE);
+    BOOST_REQUIRE(&Block(4) != stale);
+
+    for (int height = 4; height <= 8; ++height) {
+        const auto read{coordinator.GetBlock(*index, Block(height))};
+        BOOST_REQUIRE(read);
+        BOOST_CHECK_EQUAL(read->index, &Block(height));
+        BOOST_CHECK_EQUAL(read->block.GetHash(), Block(height).GetBlockHash());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(no_block_after_reader_failure)
+{
+    IndexSyncCoordinator coordinator{*m_node.chainman};
+    const auto index{MakeIndex()};
+    const fs::path blocks{m_args.GetBlocksDirPath() / "blk00000.dat"};
+    const fs::path moved{m_args.GetBlocksDirPath() / "blk00000.moved"};
+    fs::rename(blocks, moved);
+    coordinator.Register(*index, 1, /*undo=*/false);
+    BOOST_CHECK(!coordinator.GetBlock(*index, Block(1)));
+    fs::rename(moved, blocks);
+
+    // The reader is gone for good, even though the block can now be read.
+    BOOST_CHECK(!coordinator.GetBlock(*index, Block(2)));
+}
+
+BOOST_AUTO_TEST_CASE(no_block_after_unregister)
+{
+    IndexSyncCoordinator coordinator{*m_node.chainman};
+    const auto index{MakeIndex()};
+    const auto slowest{MakeIndex()};
+    coordinator.Register(*index, 1, /*undo=*/false);
+    coordinator.Register(*slowest, 1, /*undo=*/false);
+    BOOST_REQUIRE(coordinator.GetBlock(*index, Block(1)));
+    coordinator.Unregister(*index);
+    BOOST_CHECK(!coordinator.GetBlock(*index, Block(2)));
+
+    // Unregistering an index that waits for the slowest one to catch up
+    // wakes it.
+    coordinator.Register(*index, 2, /*undo=*/false);
+    std::thread unregister{[&] {
+        std::this_thread::sleep_for(100ms);
+        coordinator.Unregister(*index);
+    }};
+    const auto start{SteadyClock::now()};
+    BOOST_CHECK(!coordinator.GetBlock(*index, Block(25)));
+    BOOST_CHECK(SteadyClock::now() - start < 5s);
+    unregister.join();
+}
+
+BOOST_AUTO_TEST_CASE(interrupt_wakes_index)
+{
+    IndexSyncCoordinator coordinator{*m_node.chainman};
+    const auto index{MakeIndex()};
+    const auto slowest{MakeIndex()};
+    BOOST_REQUIRE(index->Init());
+    index->UseSyncCoordinator(coordinator);
+    coordinator.Register(*slowest, 0, /*undo=*/false);
+
+    std::thread interrupt{[&] {
+        std::this_thread::sleep_for(100ms);
+        index->Interrupt();
+    }};
+    const auto start{SteadyClock::now()};
+    BOOST_CHECK(!coordinator.GetBlock(*index, Block(25)));
+    BOOST_CHECK(SteadyClock::now() - start < 5s);
+    interrupt.join();
+}
+
+BOOST_AUTO_TEST_CASE(destructor_joins_waiting_reader)
+{
+    const auto index{MakeIndex()};
+    const auto slowest{MakeIndex()};
+    auto coordinator{std::make_unique<IndexSyncCoordinator>(*m_node.chainman)};
+    coordinator->Register(*index, 1, /*undo=*/false);
+    coordinator->Register(*slowest, 1, /*undo=*/false);
+    // Once the last block of the window is read, the reader waits for the
+    // slowest index to move on.
+    BOOST_REQUIRE(coordinator->GetBlock(*index, Block(INDEX_SYNC_WINDOW)));
+    coordinator.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
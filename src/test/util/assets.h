@@ -0,0 +1,24 @@
+// Copyright (c) 2026 The Meowcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#ifndef BITCOIN_TEST_UTIL_ASSETS_H
+#define BITCOIN_TEST_UTIL_ASSETS_H
+
+#include <assets/assets.h>
+
+/**
+ * The testing setups do not initialize the global asset cache, which
+ * connecting blocks flushes into. Point it at a fresh one while in scope.
+ * It must exist before the first block is connected, so fixtures whose base
+ * setup mines blocks list it as a base class ahead of that setup.
+ */
+struct AssetsCacheGuard {
+    CAssetsCache cache;
+    CAssetsCache* const previous{passets};
+
+    AssetsCacheGuard() { passets = &cache; }
+    ~AssetsCacheGuard() { passets = previous; }
+};
+
+#endif // BITCOIN_TEST_UTIL_ASSETS_H
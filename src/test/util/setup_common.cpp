@@ -269,6 +269,8 @@ ChainTestingSetup::ChainTestingSetup(const ChainType chainType, TestOpts opts)
             .signals = m_node.validation_signals.get(),
             // Use no worker threads while fuzzing to avoid non-determinism
             .worker_threads_num = EnableFuzzDeterminism() ? 0 : 2,
+            .header_worker_threads_num = EnableFuzzDeterminism() ? 0 : 2,
+            .header_mix_defer_depth = static_cast<int>(m_node.args->GetIntArg("-headermixdeferdepth", DEFAULT_HEADER_MIX_DEFER_DEPTH)),
         };
         if (opts.min_validation_cache) {
             chainman_opts.script_execution_cache_bytes = 0;
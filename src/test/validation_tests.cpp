@@ -2,19 +2,28 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <chain.h>
 #include <chainparams.h>
 #include <consensus/amount.h>
 #include <consensus/merkle.h>
 #include <core_io.h>
 #include <hash.h>
 #include <net.h>
+#include <pow.h>
+#include <primitives/block.h>
 #include <signet.h>
 #include <uint256.h>
 #include <util/chaintype.h>
 #include <validation.h>
+#include <versionbits.h>
 
+#include <deque>
+#include <optional>
+#include <set>
 #include <string>
+#include <utility>
 
+#include <test/util/assets.h>
 #include <test/util/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
@@ -360,4 +369,142 @@ BOOST_AUTO_TEST_CASE(block_malleation)
     }
 }
 
+//! Regtest node in initial block download whose headers after the genesis
+//! block are hashed with KAWPOW.
+struct HeaderBatchSetup : public AssetsCacheGuard, public TestingSetup {
+    const uint32_t m_kawpow_activation{nKAWPOWActivationTime};
+    //! Indexes of the headers made so far, to work out their nBits.
+    std::deque<CBlockIndex> m_indexes;
+
+    HeaderBatchSetup() : TestingSetup{ChainType::REGTEST, {.extra_args = {"-headermixdeferdepth=2"}}}
+    {
+        nKAWPOWActivationTime = Params().GenesisBlock().nTime + 1;
+    }
+
+    ~HeaderBatchSetup() { nKAWPOWActivationTime = m_kawpow_activation; }
+
+    const CBlockIndex* Genesis() { return WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Genesis()); }
+
+    int BestHeaderHeight() { return WITH_LOCK(::cs_main, return m_node.chainman->m_best_header->nHeight); }
+
+    //! Headers on top of prev with a valid proof of work, except that the
+    //! ones at the screened heights claim a mix hash that only passes
+    //! screening.
+    std::vector<CBlockHeader> MakeHeaders(const CBlockIndex* prev, int count, const std::set<int>& screened)
+    {
+        const Consensus::Params& consensus{Params().GetConsensus()};
+        std::vector<CBlockHeader> headers;
+        uint256 prev_hash{prev->GetBlockHash()};
+        for (int i = 0; i < count; ++i) {
+            CBlockHeader& header{headers.emplace_back()};
+            header.nVersion = VERSIONBITS_TOP_BITS;
+            header.nVersion.SetChainId(consensus.nAuxpowChainId);
+            header.hashPrevBlock = prev_hash;
+            header.nTime = prev->nTime + 60;
+            header.nHeight = prev->nHeight + 1;
+            header.nBits = GetNextWorkRequired(prev, &header, consensus);
+            const PowAlgo algo{header.nVersion.GetAlgo()};
+            if (screened.contains(int(header.nHeight))) {
+                header.mix_hash = m_rng.rand256();
+                do {
+                    header.nNonce64 = m_rng.rand64();
+                } while (!CheckProofOfWork(header.GetHash(), header.nBits, algo, consensus));
+            } else {
+                uint256 hash, mix;
+                do {
+                    header.nNonce64 = m_rng.rand64();
+                    hash = header.GetHashFull(mix);
+                } while (!CheckProofOfWork(hash, header.nBits, algo, consensus));
+                header.mix_hash = mix;
+            }
+            prev_hash = header.GetHash();
+
+            CBlockIndex& index{m_indexes.emplace_back(header)};
+            index.pprev = const_cast<CBlockIndex*>(prev);
+            index.nHeight = header.nHeight;
+            index.BuildSkip();
+            prev = &index;
+        }
+        return headers;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(header_mix_defer_height, HeaderBatchSetup)
+{
+    ChainstateManager& chainman{*m_node.chainman};
+    LOCK(::cs_main);
+    BOOST_REQUIRE(chainman.IsInitialBlockDownload());
+    // Counted from the top of the batch or the best header, whichever is higher.
+    BOOST_CHECK_EQUAL(chainman.HeaderMixDeferHeight(10), 8);
+    CBlockIndex high;
+    high.nHeight = 20;
+    CBlockIndex* const best_header{std::exchange(chainman.m_best_header, &high)};
+    BOOST_CHECK_EQUAL(chainman.HeaderMixDeferHeight(10), 18);
+    chainman.m_best_header = best_header;
+}
+
+BOOST_FIXTURE_TEST_CASE(header_batch_screens_deep_mix_hashes, HeaderBatchSetup)
+{
+    ChainstateManager& chainman{*m_node.chainman};
+    const auto headers{MakeHeaders(Genesis(), 4, /*screened=*/{1, 2})};
+    const auto results{chainman.CheckHeaderBatchPoW(headers)};
+    for (const auto& result : results) {
+        BOOST_REQUIRE(result);
+        BOOST_CHECK(result->IsValid());
+    }
+
+    // The screened headers are accepted on the batch results; checked on
+    // their own they are rejected.
+    std::optional<BlockValidationState> full;
+    CHeaderPoWCheck{headers[0], chainman.GetConsensus(), full}();
+    BOOST_CHECK_EQUAL(full->GetRejectReason(), "bad-mix-hash");
+    BlockValidationState state;
+    BOOST_CHECK(chainman.ProcessNewBlockHeaders(headers, /*min_pow_checked=*/true, state));
+    BOOST_CHECK_EQUAL(BestHeaderHeight(), 4);
+}
+
+BOOST_FIXTURE_TEST_CASE(header_batch_failure_drops_screening, HeaderBatchSetup)
+{
+    ChainstateManager& chainman{*m_node.chainman};
+    // Height 3 is checked in full and fails.
+    const auto headers{MakeHeaders(Genesis(), 4, /*screened=*/{1, 2, 3})};
+    const auto results{chainman.CheckHeaderBatchPoW(headers)};
+    BOOST_CHECK(!results[0]);
+    BOOST_CHECK(!results[1]);
+
+    BlockValidationState state;
+    BOOST_CHECK(!chainman.ProcessNewBlockHeaders(headers, /*min_pow_checked=*/true, state));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-mix-hash");
+    BOOST_CHECK_EQUAL(BestHeaderHeight(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(header_batch_cut_short_drops_screening, HeaderBatchSetup)
+{
+    ChainstateManager& chainman{*m_node.chainman};
+    // The header at height 4 claims another height, so it is left out of the
+    // batch check and nothing above the screened headers is checked in full.
+    auto headers{MakeHeaders(Genesis(), 4, /*screened=*/{1, 2})};
+    headers[3].nHeight = 5;
+    const auto results{chainman.CheckHeaderBatchPoW(headers)};
+    BOOST_CHECK(!results[0]);
+    BOOST_CHECK(!results[1]);
+    BOOST_CHECK(results[2] && results[2]->IsValid());
+    BOOST_CHECK(!results[3]);
+}
+
+BOOST_FIXTURE_TEST_CASE(header_batch_fork_checked_in_full, HeaderBatchSetup)
+{
+    ChainstateManager& chainman{*m_node.chainman};
+    BlockValidationState state;
+    BOOST_REQUIRE(chainman.ProcessNewBlockHeaders(MakeHeaders(Genesis(), 4, /*screened=*/{}), /*min_pow_checked=*/true, state));
+
+    // Deep enough to be screened, but not on top of the best header.
+    const auto fork{MakeHeaders(Genesis(), 2, /*screened=*/{1, 2})};
+    for (const auto& result : chainman.CheckHeaderBatchPoW(fork)) {
+        BOOST_CHECK(!result || !result->IsValid());
+    }
+    BOOST_CHECK(!chainman.ProcessNewBlockHeaders(fork, /*min_pow_checked=*/true, state));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-mix-hash");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -44,6 +44,7 @@
 #include <policy/settings.h>
 #include <policy/truc_policy.h>
 #include <pow.h>
+#include <pow_hash.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -2803,8 +2804,9 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             if (!tx.IsCoinBase()) {
                 const CTxUndo& txundo = (i == 0) ? undoDummy : blockundo.vtxundo.back();
                 for (unsigned int j = 0; j < tx.vin.size(); j++) {
-                    const CTxOut& prevout = txundo.vprevout[j].out;
-                    if (prevout.scriptPubKey.IsAssetScript()) {
+                    // The spent coin still carries the asset data decoded by CheckTxAssets
+                    const Coin& prevout = txundo.vprevout[j];
+                    if (prevout.out.scriptPubKey.IsAssetScript()) {
                         if (!assetsCache->TrySpendCoin(tx.vin[j].prevout, prevout)) {
                             LogError("ConnectBlock: Failed to spend asset coin %s\n", tx.vin[j].prevout.ToString());
                         }
@@ -3239,14 +3241,14 @@ bool Chainstate::FlushStateToDisk(
                     return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to coin database."));
                 }
 
-                // Flush asset cache to LevelDB
+                // Flush asset cache to LevelDB, right after the coins it
+                // matches, moving the asset tip in the same batch.
                 if (AreAssetsDeployed()) {
                     auto currentActiveAssetCache = GetCurrentAssetCache();
                     if (currentActiveAssetCache) {
-                        if (!currentActiveAssetCache->DumpCacheToDatabase())
+                        if (!currentActiveAssetCache->DumpCacheToDatabase(CoinsTip().GetBestBlock()))
                             return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to asset database."));
-                    }
-                    if (passetsdb) {
+                    } else if (passetsdb) {
                         passetsdb->WriteBestBlock(CoinsTip().GetBestBlock());
                     }
                 }
@@ -3339,6 +3341,11 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
         m_mempool->AddTransactionsUpdated(1);
     }
 
+    // Build the next ProgPoW epoch context before the chain reaches it.
+    if (pindexNew->nTime >= nKAWPOWActivationTime) {
+        MaybePrebuildNextPowEpochContext(pindexNew->nHeight);
+    }
+
     std::vector<bilingual_str> warning_messages;
     if (!m_chainman.IsInitialBlockDownload()) {
         auto bits = m_chainman.m_versionbitscache.CheckUnknownActivations(pindexNew, m_chainman.GetParams());
@@ -3516,7 +3523,12 @@ bool Chainstate::ConnectTip(
         CCoinsViewCache view(&CoinsTip());
 
         CAssetsCache assetCache;
+        const PowHashCounters pow_hashes_before{GetPowHashCounters()};
         bool rv = ConnectBlock(*block_to_connect, state, pindexNew, view, false, &assetCache);
+        const PowHashCounters pow_hashes_after{GetPowHashCounters()};
+        LogDebug(BCLog::BENCH, "  - PoW hashes: %u computed, %u memoized\n",
+                 pow_hashes_after.computed - pow_hashes_before.computed,
+                 pow_hashes_after.memo_hits - pow_hashes_before.memo_hits);
         if (m_chainman.m_options.signals) {
             m_chainman.m_options.signals->BlockChecked(block_to_connect, state);
         }
@@ -4311,7 +4323,13 @@ void ChainstateManager::ReceivedBlockTransactions(const CBlock& block, CBlockInd
     }
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+/**
+ * Context-free proof-of-work checks of a block header. With fCheckMixHash
+ * false, KAWPOW/MEOWPOW headers are only screened against their target using
+ * the claimed mix_hash (no epoch context needed); the caller must make sure the
+ * full check still runs before the block is stored or connected.
+ */
+static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMixHash = true)
 {
     if (!fCheckPOW)
         return true;
@@ -4345,6 +4363,13 @@ static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& st
 
     // ---- KAWPOW / MEOWPOW path (post-activation) ----
     if (block.nTime >= nKAWPOWActivationTime) {
+        if (!fCheckMixHash) {
+            if (!CheckProofOfWork(block.GetHash(), block.nBits, block.nVersion.GetAlgo(), consensusParams))
+                return state.Invalid(BlockValidationResult::BLOCK_INVALID_HEADER,
+                                     "high-hash", "proof of work failed (progpow, claimed mix)");
+            return true;
+        }
+
         uint256 mix;
         uint256 hash = block.GetHashFull(mix);
 
@@ -4368,6 +4393,15 @@ static bool CheckBlockHeader(const CBlockHeader& block, BlockValidationState& st
     return true;
 }
 
+std::optional<std::string> CHeaderPoWCheck::operator()()
+{
+    BlockValidationState state;
+    const bool valid{CheckBlockHeader(*m_header, state, *m_params, /*fCheckPOW=*/true, m_check_mix_hash)};
+    *m_result = std::move(state);
+    if (!valid) return m_result->value().GetRejectReason();
+    return std::nullopt;
+}
+
 static bool CheckMerkleRoot(const CBlock& block, BlockValidationState& state)
 {
     if (block.m_checked_merkle_root) return true;
@@ -4742,10 +4776,19 @@ static bool ContextualCheckBlock(const CBlock& block, BlockValidationState& stat
     return true;
 }
 
-bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, CBlockIndex** ppindex, bool min_pow_checked)
+bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValidationState& state, CBlockIndex** ppindex, bool min_pow_checked, const BlockValidationState* pow_result)
 {
     AssertLockHeld(cs_main);
 
+    const auto check_block_header = [&]() {
+        if (!pow_result) return CheckBlockHeader(block, state, GetConsensus());
+        if (!pow_result->IsValid()) {
+            state = *pow_result;
+            return false;
+        }
+        return true;
+    };
+
     // Check for duplicate
     uint256 hash = block.GetHash();
     BlockMap::iterator miSelf{m_blockman.m_block_index.find(hash)};
@@ -4766,7 +4809,7 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
         }
 
         const bool has_serialized_height{HasSerializedHeaderHeight(block)};
-        if (!has_serialized_height && !CheckBlockHeader(block, state, GetConsensus())) {
+        if (!has_serialized_height && !check_block_header()) {
             LogDebug(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -4786,7 +4829,7 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
         if (!CheckSerializedHeaderHeight(block, state, pindexPrev->nHeight + 1)) {
             return false;
         }
-        if (has_serialized_height && !CheckBlockHeader(block, state, GetConsensus())) {
+        if (has_serialized_height && !check_block_header()) {
             LogDebug(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -4807,15 +4850,86 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
     return true;
 }
 
+int ChainstateManager::HeaderMixDeferHeight(int batch_top_height)
+{
+    AssertLockHeld(cs_main);
+    if (m_options.header_mix_defer_depth <= 0 || !IsInitialBlockDownload()) return -1;
+    // Depth is counted from heights we derived ourselves, never from anything
+    // the peer claims: the top of the batch follows from the known block it
+    // extends, and the best header is already in the block index.
+    const int top_height{std::max(batch_top_height, m_best_header ? m_best_header->nHeight : 0)};
+    return top_height - m_options.header_mix_defer_depth;
+}
+
+std::vector<std::optional<BlockValidationState>> ChainstateManager::CheckHeaderBatchPoW(std::span<const CBlockHeader> headers)
+{
+    AssertLockNotHeld(cs_main);
+    std::vector<std::optional<BlockValidationState>> results(headers.size());
+    if (headers.size() < 2 || !m_header_check_queue.HasThreads()) return results;
+
+    // The last header is the only one whose hash is not committed to by the
+    // next one in the batch.
+    const uint256 last_hash{headers.back().GetHash()};
+
+    std::vector<CHeaderPoWCheck> checks;
+    checks.reserve(headers.size());
+    std::vector<size_t> screened;
+    bool cut_short{false};
+    {
+        LOCK(cs_main);
+        // Only check headers that follow a block we know, at the heights they
+        // would get on top of it: the serialized height picks the ProgPoW
+        // epoch, and a peer must not be able to choose it. Headers already in
+        // the block index are not checked again. Everything left out here is
+        // handled by AcceptBlockHeader, which checks the height first.
+        const CBlockIndex* prev{m_blockman.LookupBlockIndex(headers.front().hashPrevBlock)};
+        if (!prev) return results;
+        const int defer_height{HeaderMixDeferHeight(prev->nHeight + int(headers.size()))};
+        // Mix hashes are only screened in a batch whose new headers continue
+        // the best header chain; a fork is checked in full at any depth.
+        std::optional<bool> extends_best;
+        for (size_t i = 0; i < headers.size(); ++i) {
+            const int height{prev->nHeight + 1 + int(i)};
+            BlockValidationState height_state;
+            if (!CheckSerializedHeaderHeight(headers[i], height_state, height)) {
+                cut_short = true;
+                break;
+            }
+            const uint256& hash{i + 1 < headers.size() ? headers[i + 1].hashPrevBlock : last_hash};
+            if (m_blockman.LookupBlockIndex(hash)) continue;
+            if (!extends_best) extends_best = m_blockman.LookupBlockIndex(headers[i].hashPrevBlock) == m_best_header;
+            const bool check_mix_hash{!HasSerializedHeaderHeight(headers[i]) || height > defer_height || !*extends_best};
+            if (!check_mix_hash) screened.push_back(i);
+            checks.emplace_back(headers[i], GetConsensus(), results[i], check_mix_hash);
+        }
+    }
+    if (checks.empty()) return results;
+    CCheckQueueControl<CHeaderPoWCheck> control{m_header_check_queue};
+    control.Add(std::move(checks));
+    if (control.Complete() || cut_short) {
+        // A screened header is only accepted on the strength of the fully
+        // checked headers above it, so once any check in the batch failed,
+        // or the headers above were left out, the screened ones are checked
+        // in full again by AcceptBlockHeader.
+        for (const size_t i : screened) results[i].reset();
+    }
+    return results;
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ChainstateManager::ProcessNewBlockHeaders(std::span<const CBlockHeader> headers, bool min_pow_checked, BlockValidationState& state, const CBlockIndex** ppindex)
 {
     AssertLockNotHeld(cs_main);
+    // The proof-of-work checks dominate header processing and need no chain
+    // context, so do them for the whole batch in parallel before taking cs_main.
+    const auto pow_results{CheckHeaderBatchPoW(headers)};
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); ++i) {
+            const CBlockHeader& header{headers[i]};
+            const BlockValidationState* pow_result{pow_results[i] ? &*pow_results[i] : nullptr};
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            bool accepted{AcceptBlockHeader(header, state, &pindex, min_pow_checked)};
+            bool accepted{AcceptBlockHeader(header, state, &pindex, min_pow_checked, pow_result)};
             CheckBlockIndex();
 
             if (!accepted) {
@@ -6757,6 +6871,8 @@ static ChainstateManager::Options&& Flatten(ChainstateManager::Options&& opts)
 
 ChainstateManager::ChainstateManager(const util::SignalInterrupt& interrupt, Options options, node::BlockManager::Options blockman_options)
     : m_script_check_queue{/*batch_size=*/128, std::clamp(options.worker_threads_num, 0, MAX_SCRIPTCHECK_THREADS)},
+      m_header_check_queue{/*batch_size=*/16, std::clamp(options.header_worker_threads_num, 0, MAX_HEADERCHECK_THREADS),
+                           "Header proof-of-work verification", "headerch"},
       m_interrupt{interrupt},
       m_options{Flatten(std::move(options))},
       m_blockman{interrupt, std::move(blockman_options)},
@@ -7221,18 +7337,12 @@ bool ReindexAssets(ChainstateManager& chainman)
         }
     }
 
-    if (!passets->DumpCacheToDatabase()) {
+    const CBlockIndex* pTip = active_chain.Tip();
+    if (!passets->DumpCacheToDatabase(pTip ? pTip->GetBlockHash() : uint256())) {
         LogError("ReindexAssets: Failed to write asset cache to database\n");
         return false;
     }
 
-    if (passetsdb) {
-        const CBlockIndex* pTip = active_chain.Tip();
-        if (pTip) {
-            passetsdb->WriteBestBlock(pTip->GetBlockHash());
-        }
-    }
-
     LogPrintf("ReindexAssets: Successfully rebuilt asset database from %d blocks.\n", blocks_processed);
     return true;
 }
@@ -83,6 +83,8 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
+/** Maximum number of dedicated header proof-of-work checking threads allowed */
+static constexpr int MAX_HEADERCHECK_THREADS{15};
 
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
@@ -358,6 +360,34 @@ static_assert(std::is_nothrow_move_assignable_v<CScriptCheck>);
 static_assert(std::is_nothrow_move_constructible_v<CScriptCheck>);
 static_assert(std::is_nothrow_destructible_v<CScriptCheck>);
 
+/**
+ * Closure representing the context-free proof-of-work check of one block
+ * header (MEOWPOW, KAWPOW, X16R/X16RV2 or the AuxPoW scrypt parent). The
+ * outcome is written to a caller-owned slot so that a batch can be checked
+ * in parallel and still be consumed in header order; a slot left empty means
+ * the check was skipped because an earlier failure stopped the batch.
+ */
+class CHeaderPoWCheck
+{
+private:
+    const CBlockHeader* m_header;
+    const Consensus::Params* m_params;
+    std::optional<BlockValidationState>* m_result;
+    bool m_check_mix_hash;
+
+public:
+    CHeaderPoWCheck(const CBlockHeader& header, const Consensus::Params& params, std::optional<BlockValidationState>& result, bool check_mix_hash = true) :
+        m_header(&header), m_params(&params), m_result(&result), m_check_mix_hash(check_mix_hash) { }
+
+    CHeaderPoWCheck(const CHeaderPoWCheck&) = delete;
+    CHeaderPoWCheck& operator=(const CHeaderPoWCheck&) = delete;
+    CHeaderPoWCheck(CHeaderPoWCheck&&) = default;
+    CHeaderPoWCheck& operator=(CHeaderPoWCheck&&) = default;
+
+    //! Returns the reject reason if the header's proof of work is invalid.
+    std::optional<std::string> operator()();
+};
+
 /**
  * Convenience class for initializing and passing the script execution cache
  * and signature cache.
@@ -958,12 +988,16 @@ private:
      * Caller must set min_pow_checked=true in order to add a new header to the
      * block index (permanent memory storage), indicating that the header is
      * known to be part of a sufficiently high-work chain (anti-dos check).
+     * If pow_result is set, it is the already computed outcome of the
+     * proof-of-work part of CheckBlockHeader for this header and is used
+     * instead of checking again.
      */
     bool AcceptBlockHeader(
         const CBlockHeader& block,
         BlockValidationState& state,
         CBlockIndex** ppindex,
-        bool min_pow_checked) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+        bool min_pow_checked,
+        const BlockValidationState* pow_result = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     friend Chainstate;
 
     /** Most recent headers presync progress update, for rate-limiting. */
@@ -981,6 +1015,9 @@ private:
     //! A queue for script verifications that have to be performed by worker threads.
     CCheckQueue<CScriptCheck> m_script_check_queue;
 
+    //! A queue for header proof-of-work checks that have to be performed by worker threads.
+    CCheckQueue<CHeaderPoWCheck> m_header_check_queue;
+
     //! Timers and counters used for benchmarking validation in both background
     //! and active chainstates.
     SteadyClock::duration GUARDED_BY(::cs_main) time_check{};
@@ -1236,6 +1273,30 @@ public:
      */
     bool ProcessNewBlockHeaders(std::span<const CBlockHeader> headers, bool min_pow_checked, BlockValidationState& state, const CBlockIndex** ppindex = nullptr) LOCKS_EXCLUDED(cs_main);
 
+    /**
+     * Check the proof of work of a batch of headers on the header check queue.
+     * Only headers not yet in the block index, following a known block at the
+     * heights they serialize, are checked. Returns one slot per header, in
+     * order; slots are empty for headers that were not checked (no worker
+     * threads, a batch of one, an unknown or mismatching height, an already
+     * known header, or the batch was cut short by an earlier failure) and
+     * must be checked inline. Headers below HeaderMixDeferHeight only get
+     * their mix hash screened, and only if the batch continues the best
+     * header chain; their slots are emptied again if any check failed.
+     */
+    std::vector<std::optional<BlockValidationState>> CheckHeaderBatchPoW(std::span<const CBlockHeader> headers) LOCKS_EXCLUDED(cs_main);
+
+    /**
+     * Highest height at which a KAWPOW/MEOWPOW header of a batch reaching
+     * batch_top_height may be accepted after only screening its claimed
+     * mix_hash against the target, or -1 if none may. During initial block
+     * download that is -headermixdeferdepth blocks below the higher of the
+     * batch top and the best known header. The full mix verification is then
+     * done by CheckBlock when the block itself arrives, before it is stored or
+     * connected.
+     */
+    int HeaderMixDeferHeight(int batch_top_height) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /**
      * Sufficiently validate a block for disk storage (and store on disk).
      *